@@ -41,39 +41,53 @@ EnergyMLDataObjectRepository::EnergyMLDataObjectRepository( string const & name,
 
 common::DataObjectRepository * EnergyMLDataObjectRepository::getData()
 {
+  waitForContent();
+
   return m_repository;
 }
 
 COMMON_NS::AbstractObject * EnergyMLDataObjectRepository::getDataObject( string const & id )
 {
-  return m_repository->getDataObjectByUuid( id );
+  waitForContent();
+
+  COMMON_NS::AbstractObject * dataObject = m_repository->getDataObjectByUuid( id );
+  if( dataObject == nullptr || dataObject->isPartial())
+  {
+    dataObject = loadDataObject( id );
+  }
+
+  return dataObject;
 }
 
 COMMON_NS::AbstractObject * EnergyMLDataObjectRepository::getDataObjectByTitle( string const & name )
 {
+  waitForContent();
+
   for( auto & [key, value] : m_repository->getDataObjects())
   {
     //look at the different version of the dataObject
     for( auto * dataObject : value )
     {
-      if( dataObject->getTitle() == name )
+      if( !dataObject->isPartial() && dataObject->getTitle() == name )
       {
         return dataObject;
       }
     }
   }
 
-  return nullptr;
+  return loadDataObjectByTitle( name );
 }
 
 
 RESQML2_NS::UnstructuredGridRepresentation * EnergyMLDataObjectRepository::retrieveUnstructuredGrid( string const & id )
 {
-  return m_repository->getDataObjectByUuid< RESQML2_NS::UnstructuredGridRepresentation >( id );
+  return dynamic_cast< RESQML2_NS::UnstructuredGridRepresentation * >( getDataObject( id ));
 }
 
 RESQML2_NS::UnstructuredGridRepresentation * EnergyMLDataObjectRepository::retrieveUnstructuredGridByTitle( string const & title )
 {
+  waitForContent();
+
   RESQML2_NS::UnstructuredGridRepresentation * rep{nullptr};
 
   auto grid_set = m_repository->getUnstructuredGridRepresentationSet();
@@ -85,6 +99,10 @@ RESQML2_NS::UnstructuredGridRepresentation * EnergyMLDataObjectRepository::retri
   {
     rep = *result;
   }
+  else
+  {
+    rep = dynamic_cast< RESQML2_NS::UnstructuredGridRepresentation * >( loadDataObjectByTitle( title ));
+  }
 
   return rep;
 }
@@ -30,7 +30,18 @@ public:
 
   common::DataObjectRepository * getData();
 
+  /**
+   * @brief Get a data object, loading it with its dependencies if it is not loaded yet
+   * @param[in] id the UUID of the data object
+   * @return the data object, nullptr if it does not exist
+   */
   COMMON_NS::AbstractObject * getDataObject( string const & id );
+
+  /**
+   * @brief Get a data object, loading it with its dependencies if it is not loaded yet
+   * @param[in] name the title of the data object
+   * @return the data object, nullptr if it does not exist
+   */
   COMMON_NS::AbstractObject * getDataObjectByTitle( string const & name );
 
   // RESQML2_NS::UnstructuredGridRepresentation * retrieveUnstructuredGrid(string const & name);
@@ -41,6 +52,26 @@ public:
 
 protected:
 
+  /**
+   * @brief Wait for the content of the repository to be available
+   * @details Called by every accessor, so that the content can be loaded in the background.
+   */
+  virtual void waitForContent() {}
+
+  /**
+   * @brief Load a data object which is not in the repository yet
+   * @param[in] id the UUID of the data object
+   * @return the data object, nullptr if it cannot be loaded
+   */
+  virtual COMMON_NS::AbstractObject * loadDataObject( string const & GEOS_UNUSED_PARAM( id ) ) { return nullptr; }
+
+  /**
+   * @brief Load a data object which is not in the repository yet
+   * @param[in] name the title of the data object
+   * @return the data object, nullptr if it cannot be loaded
+   */
+  virtual COMMON_NS::AbstractObject * loadDataObjectByTitle( string const & GEOS_UNUSED_PARAM( name ) ) { return nullptr; }
+
   /// RESQML DataObject Repository
   common::DataObjectRepository * m_repository;
 
@@ -1,11 +1,230 @@
 
 #include "EpcDocumentRepository.hpp"
 
+#include "fesapi/eml2/AbstractHdfProxy.h"
+#include "fesapi/epc/Package.h"
+
+#include <cctype>
+#include <cstring>
+#include <future>
+#include <limits>
+
 namespace geos
 {
 
 using namespace dataRepository;
 
+/// Relationship type of the external HDF5 file of an EPC external part reference
+static constexpr char const * externalResourceType = "http://schemas.energistics.org/package/2012/relationships/externalResource";
+
+/**
+ * @brief A data object part extracted from an EPC file
+ */
+struct EpcPart
+{
+  /// Name of the part in the package
+  string name;
+
+  /// Content type of the part
+  string contentType;
+
+  /// XML content of the part
+  string content;
+
+  /// Target of the external resource relationship of the part, if any
+  string externalResource;
+
+  /// UUIDs of the data objects the part depends on
+  std::vector< string > dependencies;
+};
+
+/// Relationship type pointing from a data object to the data objects referencing it
+static constexpr char const * sourceObjectType = "http://schemas.energistics.org/package/2012/relationships/sourceObject";
+
+/**
+ * @brief Read the relationships of a part of an EPC file
+ * @param package the opened EPC file
+ * @param name the name of the part
+ * @return the relationships of the part, empty if it has no relationship part
+ */
+static std::vector< epc::Relationship > readRelationships( epc::Package & package, string const & name )
+{
+  std::size_t const slash = name.find_last_of( '/' );
+  string const relsName = slash == string::npos
+                          ? "_rels/" + name + ".rels"
+                          : name.substr( 0, slash + 1 ) + "_rels/" + name.substr( slash + 1 ) + ".rels";
+  if( !package.fileExists( relsName ))
+  {
+    return {};
+  }
+
+  epc::FileRelationship rels;
+  rels.readFromString( package.extractFile( relsName ));
+  return rels.getAllRelationship();
+}
+
+/**
+ * @brief Get the UUID of a data object from the name of its part
+ * @param name the name of the part, ending with "_<uuid>.xml"
+ * @return the UUID, empty if the name does not end with a UUID
+ */
+static string uuidOfPart( string const & name )
+{
+  std::size_t const extension = name.rfind( ".xml" );
+  if( extension == string::npos || extension < 36 )
+  {
+    return "";
+  }
+
+  return name.substr( extension - 36, 36 );
+}
+
+/**
+ * @brief Get the title of a data object from the raw XML of its part, without parsing it
+ * @param content the XML content of the part
+ * @return the title of the first citation of the part, which is the citation of the data object,
+ *         empty if the part has no citation
+ */
+static string citationTitle( string const & content )
+{
+  // Find the opening tag of the first Citation element, with any namespace prefix
+  std::size_t citation = content.find( "Citation" );
+  while( citation != string::npos &&
+         !( citation > 0 && ( content[citation - 1] == '<' || content[citation - 1] == ':' ) &&
+            citation + 8 < content.size() && ( content[citation + 8] == '>' || std::isspace( static_cast< unsigned char >( content[citation + 8] )))))
+  {
+    citation = content.find( "Citation", citation + 8 );
+  }
+  if( citation == string::npos )
+  {
+    return "";
+  }
+
+  // The Title is the first child of the Citation
+  std::size_t title = content.find( "Title>", citation );
+  while( title != string::npos && !( content[title - 1] == '<' || content[title - 1] == ':' ))
+  {
+    title = content.find( "Title>", title + 6 );
+  }
+  if( title == string::npos )
+  {
+    return "";
+  }
+  std::size_t const begin = title + 6;
+  std::size_t const end = content.find( '<', begin );
+  if( end == string::npos )
+  {
+    return "";
+  }
+
+  // Replace the predefined entities of XML
+  string const escaped = content.substr( begin, end - begin );
+  string text;
+  for( std::size_t i = 0; i < escaped.size(); ++i )
+  {
+    static std::pair< char const *, char > const entities[] = { { "&lt;", '<' }, { "&gt;", '>' }, { "&amp;", '&' }, { "&apos;", '\'' }, { "&quot;", '"' } };
+    bool replaced = false;
+    for( auto const & [entity, character] : entities )
+    {
+      if( escaped.compare( i, std::strlen( entity ), entity ) == 0 )
+      {
+        text += character;
+        i += std::strlen( entity ) - 1;
+        replaced = true;
+        break;
+      }
+    }
+    if( !replaced )
+    {
+      text += escaped[i];
+    }
+  }
+  return text;
+}
+
+/**
+ * @brief Extract all the data object parts of an EPC file with their relationships, without parsing them
+ * @param path the path of the EPC file
+ * @return the parts
+ */
+static std::vector< EpcPart > extractParts( string const & path )
+{
+  epc::Package package;
+  package.openForReading( path );
+
+  std::vector< EpcPart > parts;
+  for( auto const & [partName, contentType] : package.getFileContentType().getAllContentType())
+  {
+    // Only the data objects are declared with their part name (the others are default extensions)
+    if( contentType.isAssociatedToAnExtension())
+    {
+      continue;
+    }
+
+    string const name = contentType.getExtensionOrPartName().substr( 1 );
+    EpcPart part{ name, contentType.getContentType(), package.extractFile( name ), "", {} };
+
+    for( auto const & relationship : readRelationships( package, name ))
+    {
+      if( relationship.getType() == externalResourceType )
+      {
+        part.externalResource = relationship.getTarget();
+      }
+      else if( relationship.getType() != sourceObjectType )
+      {
+        part.dependencies.push_back( uuidOfPart( relationship.getTarget() ));
+      }
+    }
+
+    parts.push_back( std::move( part ));
+  }
+
+  package.close();
+  return parts;
+}
+
+/**
+ * @brief Append a length-prefixed string to a buffer
+ * @param buffer the buffer
+ * @param str the string to append
+ */
+static void packString( string & buffer, string const & str )
+{
+  buffer += std::to_string( str.size()) + '\n';
+  buffer += str;
+}
+
+/**
+ * @brief Read a length-prefixed string from a buffer
+ * @param buffer the buffer
+ * @param position the position of the string in the buffer, moved after the string
+ * @return the string
+ */
+static string unpackString( string const & buffer, std::size_t & position )
+{
+  std::size_t const endOfSize = buffer.find( '\n', position );
+  std::size_t const size = std::stoull( buffer.substr( position, endOfSize - position ));
+  position = endOfSize + 1 + size;
+  return buffer.substr( endOfSize + 1, size );
+}
+
+/**
+ * @brief Broadcast a buffer from the first rank, in pieces whose size fits the int count of MPI
+ * @param buffer the buffer, filled on the other ranks
+ */
+static void broadcastBuffer( string & buffer )
+{
+  globalIndex size = LvArray::integerConversion< globalIndex >( buffer.size());
+  MpiWrapper::broadcast( size, 0 );
+  buffer.resize( LvArray::integerConversion< std::size_t >( size ));
+
+  constexpr globalIndex maxPieceSize = std::numeric_limits< int >::max();
+  for( globalIndex offset = 0; offset < size; offset += maxPieceSize )
+  {
+    MpiWrapper::bcast( buffer.data() + offset, LvArray::integerConversion< int >( std::min( maxPieceSize, size - offset )), 0 );
+  }
+}
+
 EpcDocumentRepository::EpcDocumentRepository( string const & name,
                                               Group * const parent )
   : EnergyMLDataObjectRepository( name, parent )
@@ -16,35 +235,325 @@ EpcDocumentRepository::EpcDocumentRepository( string const & name,
     .setInputFlag( InputFlags::REQUIRED )
     .setRestartFlags( RestartFlags::NO_WRITE )
     .setDescription( "Paths to the EPC files" );
+
+  registerWrapper( viewKeyStruct::broadcastContentString(), &m_broadcastContent )
+    .setApplyDefaultValue( 0 )
+    .setInputFlag( InputFlags::OPTIONAL )
+    .setDescription( "If this flag is equal to 1, the EPC files are only read by the first rank, one thread per file, "
+                     "and their XML parts and relationships are broadcast to the other ranks instead of being read from the file system by every rank. "
+                     "Every rank then only deserializes the data objects requested by the simulation, with the data objects they depend on" );
+
+  registerWrapper( viewKeyStruct::lazyLoadingString(), &m_lazyLoading )
+    .setApplyDefaultValue( 0 )
+    .setInputFlag( InputFlags::OPTIONAL )
+    .setDescription( "If this flag is equal to 1, only the content types and relationships of the EPC files are read at initialization. "
+                     "The data objects requested by the simulation are then deserialized on demand, with the data objects they depend on" );
+
+  registerWrapper( viewKeyStruct::hdf5ChunkCacheSizeString(), &m_hdfReadSettings.chunkCacheSize )
+    .setApplyDefaultValue( 0 )
+    .setInputFlag( InputFlags::OPTIONAL )
+    .setDescription( "Size in bytes of the HDF5 chunk cache of each dataset read from the repository (0 keeps the HDF5 default of 1 MB)" );
+
+  registerWrapper( viewKeyStruct::hdf5ChunkCacheSlotsString(), &m_hdfReadSettings.chunkCacheSlots )
+    .setApplyDefaultValue( 0 )
+    .setInputFlag( InputFlags::OPTIONAL )
+    .setDescription( "Number of slots of the HDF5 chunk cache hash table, ideally a prime number about 100 times the number of cached chunks "
+                     "(0 keeps the HDF5 default)" );
+
+  registerWrapper( viewKeyStruct::hdf5PageBufferSizeString(), &m_hdfReadSettings.pageBufferSize )
+    .setApplyDefaultValue( 0 )
+    .setInputFlag( InputFlags::OPTIONAL )
+    .setDescription( "Size in bytes of the HDF5 page buffer (0 disables it). It is ignored for files not created with the paged aggregation strategy" );
+
+  registerWrapper( viewKeyStruct::hdf5MetadataCacheSizeString(), &m_hdfReadSettings.metadataCacheSize )
+    .setApplyDefaultValue( 0 )
+    .setInputFlag( InputFlags::OPTIONAL )
+    .setDescription( "Initial size in bytes of the HDF5 metadata cache (0 keeps the HDF5 default)" );
+
+  registerWrapper( viewKeyStruct::hdf5SieveBufferSizeString(), &m_hdfReadSettings.sieveBufferSize )
+    .setApplyDefaultValue( 0 )
+    .setInputFlag( InputFlags::OPTIONAL )
+    .setDescription( "Size in bytes of the HDF5 sieve buffer used to read contiguous datasets (0 keeps the HDF5 default of 64 kB)" );
+}
+
+EpcDocumentRepository::~EpcDocumentRepository()
+{
+  if( m_content.valid())
+  {
+    m_content.wait();
+  }
+
+  for( auto & package : m_packages )
+  {
+    package->close();
+  }
 }
 
 void EpcDocumentRepository::postInputInitialization()
 {
 
+  // The HDF proxies created while deserializing open their files with the read settings
+  m_repository->setHdfProxyFactory( new RESQMLHdfProxyFactory( m_hdfReadSettings ));
+
+  open();
+}
+
+void EpcDocumentRepository::deserialize()
+{
+  if( m_broadcastContent )
+  {
+    indexBroadcastFiles();
+    GEOS_LOG_RANK_0(
+      GEOS_FMT( "{} entities indexed", m_lazyParts.size()));
+  }
+  else if( m_lazyLoading )
+  {
+    indexFiles();
+    GEOS_LOG_RANK_0(
+      GEOS_FMT( "{} entities indexed", m_lazyParts.size()));
+  }
+  else
+  {
+    deserializeFiles();
+    GEOS_LOG_RANK_0(
+      GEOS_FMT( "{} entities read", m_repository->getUuids().size()));
+  }
+}
+
+void EpcDocumentRepository::waitForContent()
+{
+  if( !m_content.valid())
+  {
+    return;
+  }
+
   try
   {
-    for( const string & path : m_filesPaths )
-    {
-      GEOS_LOG_RANK_0( GEOS_FMT( "Reading: {}", path ));
-      COMMON_NS::EpcDocument pck( path );
-      std::string message = pck.deserializeInto( *m_repository );
-      pck.close();
-      GEOS_LOG_RANK_0( GEOS_FMT( "Deserilization message: {}", message ));
-    }
+    m_content.get();
   } catch( const std::exception & e )
   {
     delete m_repository;
+    m_repository = nullptr;
     GEOS_THROW(
       GEOS_FMT( "{}: invalid file path : {}", this->getName(), e.what()),
       InputError );
   }
+}
+
+COMMON_NS::AbstractObject * EpcDocumentRepository::addPart( string const & content,
+                                                            string const & contentType,
+                                                            string const & directory,
+                                                            string const & externalResource )
+{
+  COMMON_NS::AbstractObject * const dataObject = m_repository->addOrReplaceGsoapProxy( content, contentType );
+
+  auto * const hdfProxy = dynamic_cast< EML2_NS::AbstractHdfProxy * >( dataObject );
+  if( hdfProxy != nullptr )
+  {
+    hdfProxy->setRootPath( directory );
+    if( !externalResource.empty())
+    {
+      hdfProxy->setRelativePath( externalResource );
+    }
+  }
+
+  return dataObject;
+}
+
+void EpcDocumentRepository::indexFiles()
+{
+  for( const string & path : m_filesPaths )
+  {
+    GEOS_LOG_RANK_0( GEOS_FMT( "Indexing: {}", path ));
+    m_packages.push_back( std::make_unique< epc::Package >() );
+    epc::Package & package = *m_packages.back();
+    package.openForReading( path );
+
+    for( auto const & [partName, contentType] : package.getFileContentType().getAllContentType())
+    {
+      if( contentType.isAssociatedToAnExtension())
+      {
+        continue;
+      }
+
+      LazyPart part{ m_packages.size() - 1, contentType.getExtensionOrPartName().substr( 1 ), contentType.getContentType(), "", std::nullopt, "", {}, false };
+
+      for( auto const & relationship : readRelationships( package, part.name ))
+      {
+        if( relationship.getType() == externalResourceType )
+        {
+          part.externalResource = relationship.getTarget();
+        }
+        else if( relationship.getType() != sourceObjectType )
+        {
+          part.dependencies.push_back( uuidOfPart( relationship.getTarget() ));
+        }
+      }
+
+      m_lazyParts.emplace( uuidOfPart( part.name ), std::move( part ));
+    }
+  }
+}
+
+COMMON_NS::AbstractObject * EpcDocumentRepository::loadDataObject( string const & id )
+{
+  if( m_lazyParts.count( id ) == 0 )
+  {
+    return nullptr;
+  }
+
+  // Deserialize the transitive closure of the dependencies which are not loaded yet
+  std::vector< string > toLoad{ id };
+  integer numLoaded = 0;
+  while( !toLoad.empty())
+  {
+    string const uuid = toLoad.back();
+    toLoad.pop_back();
+
+    auto const part = m_lazyParts.find( uuid );
+    if( part == m_lazyParts.end() || part->second.loaded )
+    {
+      continue;
+    }
+
+    LazyPart & lazyPart = part->second;
+    string directory, fileName;
+    splitPath( m_filesPaths[lazyPart.packageIndex], directory, fileName );
+    addPart( readPart( lazyPart ), lazyPart.contentType, directory, lazyPart.externalResource );
+    lazyPart.content.clear();
+    lazyPart.content.shrink_to_fit();
+    lazyPart.loaded = true;
+    ++numLoaded;
+
+    toLoad.insert( toLoad.end(), lazyPart.dependencies.begin(), lazyPart.dependencies.end() );
+  }
+
+  m_repository->updateAllRelationships();
+
+  GEOS_LOG_LEVEL_RANK_0( 1, GEOS_FMT( "{}: {} entities deserialized for {}", this->getName(), numLoaded, id ));
+
+  return m_repository->getDataObjectByUuid( id );
+}
+
+COMMON_NS::AbstractObject * EpcDocumentRepository::loadDataObjectByTitle( string const & name )
+{
+  // The titles are read from the parts until one matches, and kept for the next searches
+  for( auto & [uuid, part] : m_lazyParts )
+  {
+    if( part.loaded )
+    {
+      continue;
+    }
+    if( !part.title.has_value())
+    {
+      part.title = citationTitle( readPart( part ));
+    }
+    if( *part.title == name )
+    {
+      return loadDataObject( uuid );
+    }
+  }
+
+  return nullptr;
+}
+
+void EpcDocumentRepository::deserializeFiles()
+{
+  for( const string & path : m_filesPaths )
+  {
+    GEOS_LOG_RANK_0( GEOS_FMT( "Reading: {}", path ));
+    COMMON_NS::EpcDocument pck( path );
+    std::string message = pck.deserializeInto( *m_repository );
+    pck.close();
+    GEOS_LOG_RANK_0( GEOS_FMT( "Deserilization message: {}", message ));
+  }
+}
 
-  GEOS_LOG_RANK_0(
-    GEOS_FMT( "{} entities read", m_repository->getUuids().size()));
+string EpcDocumentRepository::readPart( LazyPart const & part ) const
+{
+  return m_broadcastContent ? part.content : m_packages[part.packageIndex]->extractFile( part.name );
+}
+
+void EpcDocumentRepository::indexBroadcastFiles()
+{
+  // The first rank unzips the files in parallel and packs their parts and relationships in a single buffer
+  string buffer;
+  if( MpiWrapper::commRank() == 0 )
+  {
+    std::vector< std::future< std::vector< EpcPart > > > extractions;
+    for( const string & path : m_filesPaths )
+    {
+      GEOS_LOG_RANK_0( GEOS_FMT( "Reading: {}", path ));
+      extractions.push_back( std::async( std::launch::async, extractParts, path ));
+    }
+
+    for( auto & extraction : extractions )
+    {
+      std::vector< EpcPart > const parts = extraction.get();
+      packString( buffer, std::to_string( parts.size()));
+      for( EpcPart const & part : parts )
+      {
+        packString( buffer, part.name );
+        packString( buffer, part.contentType );
+        packString( buffer, part.content );
+        packString( buffer, part.externalResource );
+        packString( buffer, std::to_string( part.dependencies.size()));
+        for( string const & dependency : part.dependencies )
+        {
+          packString( buffer, dependency );
+        }
+      }
+    }
+  }
+
+  broadcastBuffer( buffer );
+
+  // Every rank indexes the parts, which are only deserialized on demand
+  std::size_t position = 0;
+  for( std::size_t packageIndex = 0; packageIndex < m_filesPaths.size(); ++packageIndex )
+  {
+    std::size_t const numParts = std::stoull( unpackString( buffer, position ));
+    for( std::size_t i = 0; i < numParts; ++i )
+    {
+      string name = unpackString( buffer, position );
+      string contentType = unpackString( buffer, position );
+      string content = unpackString( buffer, position );
+      string externalResource = unpackString( buffer, position );
+      LazyPart part{ packageIndex, std::move( name ), std::move( contentType ), std::move( content ),
+                     std::nullopt, std::move( externalResource ), {}, false };
+      std::size_t const numDependencies = std::stoull( unpackString( buffer, position ));
+      for( std::size_t d = 0; d < numDependencies; ++d )
+      {
+        part.dependencies.push_back( unpackString( buffer, position ));
+      }
+
+      m_lazyParts.emplace( uuidOfPart( part.name ), std::move( part ));
+    }
+  }
+
+  GEOS_LOG_RANK_0( GEOS_FMT( "{}: {} bytes of XML parts broadcast", this->getName(), buffer.size()));
 }
 
 void EpcDocumentRepository::open()
-{}
+{
+  if( m_isOpen )
+  {
+    return;
+  }
+  m_isOpen = true;
+
+  if( m_broadcastContent )
+  {
+    // The broadcast is a collective call: it cannot be overlapped on a background thread
+    m_content = std::async( std::launch::deferred, [this]() { deserialize(); } );
+    waitForContent();
+  }
+  else
+  {
+    // The deserialization is overlapped with the rest of the input processing until the first access to the content
+    m_content = std::async( std::launch::async, [this]() { deserialize(); } );
+  }
+}
 
 REGISTER_CATALOG_ENTRY( ExternalDataRepositoryBase, EpcDocumentRepository, string const &,
                         Group * const )
@@ -2,9 +2,19 @@
 #define GEOSX_MESH_GENERATORS_RESQML_EPCDOCUMENTREPOSITORY_HPP
 
 #include "EnergyMLDataObjectRepository.hpp"
+#include "RESQMLHdfProxy.hpp"
 
 #include "fesapi/common/EpcDocument.h"
 
+#include <future>
+#include <memory>
+#include <optional>
+
+namespace epc
+{
+class Package;
+}
+
 namespace geos
 {
 
@@ -27,6 +37,11 @@ public:
    */
   static string catalogName() { return "EpcDocumentRepository"; }
 
+  /**
+   * @brief Destructor.
+   */
+  ~EpcDocumentRepository() override;
+
   void open() override;
 
 protected:
@@ -35,14 +50,120 @@ protected:
   struct viewKeyStruct
   {
     constexpr static char const * filesPathsString() { return "files"; }
+    constexpr static char const * broadcastContentString() { return "broadcastContent"; }
+    constexpr static char const * lazyLoadingString() { return "lazyLoading"; }
+    constexpr static char const * hdf5ChunkCacheSizeString() { return "hdf5ChunkCacheSize"; }
+    constexpr static char const * hdf5ChunkCacheSlotsString() { return "hdf5ChunkCacheSlots"; }
+    constexpr static char const * hdf5PageBufferSizeString() { return "hdf5PageBufferSize"; }
+    constexpr static char const * hdf5MetadataCacheSizeString() { return "hdf5MetadataCacheSize"; }
+    constexpr static char const * hdf5SieveBufferSizeString() { return "hdf5SieveBufferSize"; }
   };
   /// @endcond
 
   void postInputInitialization() override;
 
+  COMMON_NS::AbstractObject * loadDataObject( string const & id ) override;
+
+  COMMON_NS::AbstractObject * loadDataObjectByTitle( string const & name ) override;
+
+  void waitForContent() override;
+
 private:
+
+  /**
+   * @brief Deserialize or index the EPC files, according to the selected mode
+   */
+  void deserialize();
+
+  /**
+   * @brief A data object part indexed in an EPC file, but not necessarily deserialized
+   */
+  struct LazyPart
+  {
+    /// Index of the package holding the part
+    std::size_t packageIndex;
+
+    /// Name of the part in the package
+    string name;
+
+    /// Content type of the part
+    string contentType;
+
+    /// XML content of the part until it is deserialized, when the EPC files are broadcast
+    string content;
+
+    /// Title of the citation of the data object, read on demand to find the data objects by title without deserializing them
+    std::optional< string > title;
+
+    /// Target of the external resource relationship of the part, if any
+    string externalResource;
+
+    /// UUIDs of the data objects the part depends on
+    std::vector< string > dependencies;
+
+    /// Flag telling whether the part has been deserialized
+    bool loaded;
+  };
+
+  /**
+   * @brief Index the parts and the relationships of the EPC files without deserializing them
+   */
+  void indexFiles();
+
+  /**
+   * @brief Add a data object part to the repository
+   * @param[in] content the XML content of the part
+   * @param[in] contentType the content type of the part
+   * @param[in] directory the directory of the EPC file holding the part
+   * @param[in] externalResource the target of the external resource relationship of the part, if any
+   * @return the data object
+   */
+  COMMON_NS::AbstractObject * addPart( string const & content,
+                                       string const & contentType,
+                                       string const & directory,
+                                       string const & externalResource );
+
+  /**
+   * @brief Read the XML content of an indexed part
+   * @param[in] part the part
+   * @return the content, kept in memory when the EPC files are broadcast, otherwise extracted from its package
+   */
+  string readPart( LazyPart const & part ) const;
+
+  /**
+   * @brief Deserialize the EPC files on every rank
+   */
+  void deserializeFiles();
+
+  /**
+   * @brief Extract the EPC files on the first rank and broadcast their XML parts and relationships to the other ranks,
+   * which index them to deserialize them on demand
+   */
+  void indexBroadcastFiles();
+
   /// Path to the epc file
   array1d< Path > m_filesPaths;
+
+  /// Flag to read the EPC files on the first rank only and broadcast their content
+  integer m_broadcastContent;
+
+  /// Flag to only deserialize the data objects used by the simulation, with their dependencies
+  integer m_lazyLoading;
+
+  /// HDF5 file access settings of the numerical data
+  HdfReadSettings m_hdfReadSettings;
+
+  /// Packages kept open to deserialize their parts on demand
+  std::vector< std::unique_ptr< epc::Package > > m_packages;
+
+  /// Indexed parts of the packages: UUID -> part
+  std::map< string, LazyPart > m_lazyParts;
+
+  /// Flag telling whether the deserialization has been started
+  bool m_isOpen = false;
+
+  /// Pending deserialization of the EPC files, joined by the first access to the content
+  std::future< void > m_content;
 };
 
 } // end namespace geosx
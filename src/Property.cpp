@@ -37,6 +37,11 @@ Property::Property( string const & name,
   registerWrapper( viewKeyStruct::titleString(), &m_title ).
     setInputFlag( InputFlags::OPTIONAL ).
     setDescription( "Title of the data object" );
+
+  registerWrapper( viewKeyStruct::defaultValueString(), &m_defaultValue ).
+    setInputFlag( InputFlags::OPTIONAL ).
+    setApplyDefaultValue( 0.0 ).
+    setDescription( "Value of the cells out of the subrepresentation supporting the property, if any" );
 }
 
 void Property::postInputInitialization()
@@ -61,6 +61,8 @@ public:
 
   const string & getTitle() const { return m_title; }
 
+  real64 getDefaultValue() const { return m_defaultValue; }
+
   //   LinearSolverParameters const & get() const
   //   { return m_parameters; }
 
@@ -73,10 +75,12 @@ public:
     /// Solver type key
     static constexpr char const *uuidString() { return "uuid"; }
     static constexpr char const *titleString() { return "title"; }
+    static constexpr char const *defaultValueString() { return "defaultValue"; }
   };
 
   string m_uuid;
   string m_title;
+  real64 m_defaultValue;
 };
 
 } // namespace geos
@@ -0,0 +1,87 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 TotalEnergies
+ * Copyright (c) 2019-     GEOSX Contributors
+ * All rights reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+/**
+ * @file PropertyRegion.cpp
+ */
+
+#include "PropertyRegion.hpp"
+
+namespace geos
+{
+using namespace dataRepository;
+
+PropertyRegion::PropertyRegion( string const & name,
+                                Group * const parent )
+  :
+  Group( name, parent )
+{
+  setInputFlags( InputFlags::OPTIONAL );
+  enableLogLevelInput();
+
+  registerWrapper( viewKeyStruct::uuidString(), &m_uuid ).
+    setInputFlag( InputFlags::OPTIONAL ).
+    setDescription( "UUID of the discrete or categorical property" );
+
+  registerWrapper( viewKeyStruct::titleString(), &m_title ).
+    setInputFlag( InputFlags::OPTIONAL ).
+    setDescription( "Title of the discrete or categorical property" );
+
+  registerWrapper( viewKeyStruct::valuesString(), &m_values ).
+    setInputFlag( InputFlags::REQUIRED ).
+    setDescription( "Values of the property marking a region" );
+
+  registerWrapper( viewKeyStruct::regionIdsString(), &m_regionIds ).
+    setInputFlag( InputFlags::REQUIRED ).
+    setDescription( "Region id of the cells holding each value of " + string( viewKeyStruct::valuesString() ) );
+}
+
+void PropertyRegion::postInputInitialization()
+{
+  GEOS_THROW_IF( m_uuid.empty() && m_title.empty(),
+                 getName() << ": the " << viewKeyStruct::uuidString() << " or the " << viewKeyStruct::titleString() << " of the property is required",
+                 InputError );
+
+  GEOS_THROW_IF( m_values.size() != m_regionIds.size(),
+                 getName() << ": " << viewKeyStruct::valuesString() << " and " << viewKeyStruct::regionIdsString() << " must have the same size",
+                 InputError );
+
+  for( integer const regionId : m_regionIds )
+  {
+    GEOS_THROW_IF_LT_MSG( regionId, 0,
+                          getName() << ": " << viewKeyStruct::regionIdsString() << " must not be negative",
+                          InputError );
+  }
+}
+
+std::map< integer, integer > PropertyRegion::getRegionIdOfValue() const
+{
+  std::map< integer, integer > regionIdOfValue;
+  for( localIndex i = 0; i < m_values.size(); ++i )
+  {
+    regionIdOfValue[m_values[i]] = m_regionIds[i];
+  }
+  return regionIdOfValue;
+}
+
+
+PropertyRegion::CatalogInterface::CatalogType & PropertyRegion::getCatalog()
+{
+  static PropertyRegion::CatalogInterface::CatalogType catalog;
+  return catalog;
+}
+
+REGISTER_CATALOG_ENTRY( Group, PropertyRegion, string const &, Group * const )
+
+} // namespace geos
@@ -0,0 +1,90 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior
+ * University Copyright (c) 2018-2020 TotalEnergies Copyright (c) 2019- GEOSX
+ * Contributors All rights reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS
+ * files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+/**
+ * @file PropertyRegion.hpp
+ */
+
+#ifndef GEOS_EXTERNALCOMPONENTS_RESQML_PROPERTYREGION_HPP
+#define GEOS_EXTERNALCOMPONENTS_RESQML_PROPERTYREGION_HPP
+
+#include "dataRepository/Group.hpp"
+
+#include <map>
+
+namespace geos
+{
+
+/**
+ * @brief Regions defined by the values of a discrete or categorical property, with Group capabilities
+ *
+ * Each value listed in the lookup table marks the cells holding it with its region id,
+ * the cells of the other values keep their region id.
+ */
+
+class PropertyRegion : public dataRepository::Group
+{
+public:
+  PropertyRegion() = delete;
+
+  /// Constructor
+  PropertyRegion( string const & name, Group * const parent );
+
+  /// Copy constructor
+  PropertyRegion( PropertyRegion && ) = default;
+
+  /**
+   * @brief Accessor for the singleton Catalog object
+   * @return a static reference to the Catalog object
+   */
+  static CatalogInterface::CatalogType & getCatalog();
+
+  /// Destructor
+  virtual ~PropertyRegion() override = default;
+
+  /// Catalog name
+  static string catalogName() { return "PropertyRegion"; }
+
+  /// Postprocessing of input
+  virtual void postInputInitialization() override;
+
+  const string & getUUID() const { return m_uuid; }
+
+  const string & getTitle() const { return m_title; }
+
+  /**
+   * @return the region id of each value of the lookup table
+   */
+  std::map< integer, integer > getRegionIdOfValue() const;
+
+private:
+
+  /// Keys appearing in XML
+  struct viewKeyStruct
+  {
+    static constexpr char const *uuidString() { return "uuid"; }
+    static constexpr char const *titleString() { return "title"; }
+    static constexpr char const *valuesString() { return "values"; }
+    static constexpr char const *regionIdsString() { return "regionIds"; }
+  };
+
+  string m_uuid;
+  string m_title;
+  integer_array m_values;
+  integer_array m_regionIds;
+};
+
+} // namespace geos
+
+#endif // GEOS_EXTERNALCOMPONENTS_RESQML_PROPERTYREGION_HPP
@@ -0,0 +1,591 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 TotalEnergies
+ * Copyright (c) 2019-     GEOSX Contributors
+ * All rights reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+/**
+ * @file RESQMLHdf5Utilities.cpp
+ */
+
+#include "RESQMLHdf5Utilities.hpp"
+
+#include "common/logger/Logger.hpp"
+#include "common/DataTypes.hpp"
+#include "common/GEOS_RAJA_Interface.hpp"
+
+#include "fesapi/common/DataObjectRepository.h"
+#include "fesapi/eml2/AbstractHdfProxy.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <map>
+#include <mutex>
+
+#include <zlib.h>
+
+namespace geos
+{
+
+std::recursive_mutex & hdf5Mutex()
+{
+  static std::recursive_mutex mutex;
+  return mutex;
+}
+
+/**
+ * @brief Build the location of a RESQML 2.0.1 HDF5 dataset reference
+ * @param repository the repository holding the HDF proxy of the dataset
+ * @param dataset the dataset reference
+ * @param location the location of the dataset
+ * @return false if the HDF proxy of the dataset is not in the repository
+ */
+static bool locateDataset( COMMON_NS::DataObjectRepository const * repository,
+                           gsoap_resqml2_0_1::eml20__Hdf5Dataset const * dataset,
+                           Hdf5DatasetLocation & location )
+{
+  if( dataset == nullptr || dataset->HdfProxy == nullptr )
+  {
+    return false;
+  }
+
+  auto const * hdfProxy = repository->getDataObjectByUuid< EML2_NS::AbstractHdfProxy >( dataset->HdfProxy->UUID );
+  if( hdfProxy == nullptr || hdfProxy->isPartial())
+  {
+    return false;
+  }
+
+  location.filePath = hdfProxy->getPackageDirectoryAbsolutePath().empty()
+                      ? hdfProxy->getRelativePath()
+                      : hdfProxy->getPackageDirectoryAbsolutePath() + "/" + hdfProxy->getRelativePath();
+  location.datasetPath = dataset->PathInHdfFile;
+  return true;
+}
+
+bool locatePropertyValues( RESQML2_NS::AbstractValuesProperty const * valuesProperty,
+                           Hdf5DatasetLocation & location )
+{
+  auto const * property = dynamic_cast< gsoap_resqml2_0_1::resqml20__AbstractValuesProperty const * >( valuesProperty->getEml20GsoapProxy() );
+  if( property == nullptr || property->PatchOfValues.size() != 1 )
+  {
+    return false;
+  }
+
+  gsoap_resqml2_0_1::resqml20__AbstractValueArray const * values = property->PatchOfValues[0]->Values;
+  if( auto const * doubleValues = dynamic_cast< gsoap_resqml2_0_1::resqml20__DoubleHdf5Array const * >( values ))
+  {
+    return locateDataset( valuesProperty->getRepository(), doubleValues->Values, location );
+  }
+  if( auto const * integerValues = dynamic_cast< gsoap_resqml2_0_1::resqml20__IntegerHdf5Array const * >( values ))
+  {
+    return locateDataset( valuesProperty->getRepository(), integerValues->Values, location );
+  }
+
+  return false;
+}
+
+bool locateGridPoints( RESQML2_NS::UnstructuredGridRepresentation const * grid,
+                       Hdf5DatasetLocation & location )
+{
+  auto const * gsoapGrid = dynamic_cast< gsoap_resqml2_0_1::_resqml20__UnstructuredGridRepresentation const * >( grid->getEml20GsoapProxy() );
+  if( gsoapGrid == nullptr || gsoapGrid->Geometry == nullptr )
+  {
+    return false;
+  }
+
+  auto const * points = dynamic_cast< gsoap_resqml2_0_1::resqml20__Point3dHdf5Array const * >( gsoapGrid->Geometry->Points );
+  if( points == nullptr )
+  {
+    return false;
+  }
+
+  return locateDataset( grid->getRepository(), points->Coordinates, location );
+}
+
+bool locateSubRepresentationElements( RESQML2_NS::SubRepresentation const * subrep,
+                                      Hdf5DatasetLocation & location )
+{
+  auto const * gsoapSubrep = dynamic_cast< gsoap_resqml2_0_1::_resqml20__SubRepresentation const * >( subrep->getEml20GsoapProxy() );
+  if( gsoapSubrep == nullptr || gsoapSubrep->SubRepresentationPatch.size() != 1 ||
+      gsoapSubrep->SubRepresentationPatch[0]->ElementIndices.size() != 1 )
+  {
+    return false;
+  }
+
+  auto const * indices = dynamic_cast< gsoap_resqml2_0_1::resqml20__IntegerHdf5Array const * >( gsoapSubrep->SubRepresentationPatch[0]->ElementIndices[0]->Indices );
+  if( indices == nullptr )
+  {
+    return false;
+  }
+
+  return locateDataset( subrep->getRepository(), indices->Values, location );
+}
+
+/**
+ * @brief Locate the cumulative lengths of a RESQML 2.0.1 jagged array
+ * @param repository the repository holding the HDF proxy of the dataset
+ * @param array the cumulative lengths
+ * @param lengths the location of the dataset or the lattice
+ * @return false if the cumulative lengths are neither a single HDF5 dataset nor a one-dimensional lattice
+ */
+static bool locateCumulativeLengths( COMMON_NS::DataObjectRepository const * repository,
+                                     gsoap_resqml2_0_1::resqml20__AbstractIntegerArray const * array,
+                                     Hdf5CumulativeLengths & lengths )
+{
+  if( auto const * hdf5Array = dynamic_cast< gsoap_resqml2_0_1::resqml20__IntegerHdf5Array const * >( array ))
+  {
+    return locateDataset( repository, hdf5Array->Values, lengths.location );
+  }
+
+  auto const * lattice = dynamic_cast< gsoap_resqml2_0_1::resqml20__IntegerLatticeArray const * >( array );
+  if( lattice == nullptr || lattice->Offset.size() != 1 || lattice->StartValue < 0 || lattice->Offset[0]->Value < 0 )
+  {
+    return false;
+  }
+
+  lengths.start = LvArray::integerConversion< hsize_t >( lattice->StartValue );
+  lengths.step = LvArray::integerConversion< hsize_t >( lattice->Offset[0]->Value );
+  return true;
+}
+
+bool locateGridTopology( RESQML2_NS::UnstructuredGridRepresentation const * grid,
+                         Hdf5GridTopology & topology )
+{
+  auto const * gsoapGrid = dynamic_cast< gsoap_resqml2_0_1::_resqml20__UnstructuredGridRepresentation const * >( grid->getEml20GsoapProxy() );
+  if( gsoapGrid == nullptr || gsoapGrid->Geometry == nullptr ||
+      gsoapGrid->Geometry->FacesPerCell == nullptr || gsoapGrid->Geometry->NodesPerFace == nullptr )
+  {
+    return false;
+  }
+
+  COMMON_NS::DataObjectRepository const * repository = grid->getRepository();
+  auto const * facesPerCell = dynamic_cast< gsoap_resqml2_0_1::resqml20__IntegerHdf5Array const * >( gsoapGrid->Geometry->FacesPerCell->Elements );
+  auto const * nodesPerFace = dynamic_cast< gsoap_resqml2_0_1::resqml20__IntegerHdf5Array const * >( gsoapGrid->Geometry->NodesPerFace->Elements );
+  auto const * rightHandedness = dynamic_cast< gsoap_resqml2_0_1::resqml20__BooleanHdf5Array const * >( gsoapGrid->Geometry->CellFaceIsRightHanded );
+
+  return facesPerCell != nullptr && nodesPerFace != nullptr && rightHandedness != nullptr &&
+         locateDataset( repository, facesPerCell->Values, topology.facesPerCell ) &&
+         locateDataset( repository, nodesPerFace->Values, topology.nodesPerFace ) &&
+         locateDataset( repository, rightHandedness->Values, topology.cellFaceIsRightHanded ) &&
+         locateCumulativeLengths( repository, gsoapGrid->Geometry->FacesPerCell->CumulativeLength, topology.cumulativeFaceCountPerCell ) &&
+         locateCumulativeLengths( repository, gsoapGrid->Geometry->NodesPerFace->CumulativeLength, topology.cumulativeNodeCountPerFace );
+}
+
+Hdf5RangeReader::Hdf5RangeReader( Hdf5DatasetLocation const & location ):
+  m_file( -1 ),
+  m_dataset( -1 ),
+  m_size( 0 )
+{
+  std::lock_guard< std::recursive_mutex > const lock( hdf5Mutex() );
+  m_file = H5Fopen( location.filePath.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT );
+  m_dataset = m_file < 0 ? -1 : H5Dopen( m_file, location.datasetPath.c_str(), H5P_DEFAULT );
+  GEOS_ERROR_IF( m_dataset < 0, GEOS_FMT( "Cannot open the dataset {} of {}", location.datasetPath, location.filePath ));
+
+  hid_t const space = H5Dget_space( m_dataset );
+  GEOS_ERROR_IF( H5Sget_simple_extent_ndims( space ) != 1,
+                 GEOS_FMT( "The dataset {} of {} is not one-dimensional", location.datasetPath, location.filePath ));
+  m_size = LvArray::integerConversion< hsize_t >( H5Sget_simple_extent_npoints( space ));
+  H5Sclose( space );
+}
+
+Hdf5RangeReader::~Hdf5RangeReader()
+{
+  std::lock_guard< std::recursive_mutex > const lock( hdf5Mutex() );
+  if( m_dataset >= 0 )
+  {
+    H5Dclose( m_dataset );
+  }
+  if( m_file >= 0 )
+  {
+    H5Fclose( m_file );
+  }
+}
+
+void Hdf5RangeReader::read( hid_t const nativeType, hsize_t const offset, hsize_t const count, void * const values ) const
+{
+  GEOS_ERROR_IF( offset + count > m_size, GEOS_FMT( "Range [{}, {}) out of a dataset of {} values", offset, offset + count, m_size ));
+  if( count == 0 )
+  {
+    return;
+  }
+
+  std::lock_guard< std::recursive_mutex > const lock( hdf5Mutex() );
+  hid_t const fileSpace = H5Dget_space( m_dataset );
+  H5Sselect_hyperslab( fileSpace, H5S_SELECT_SET, &offset, nullptr, &count, nullptr );
+  hid_t const memorySpace = H5Screate_simple( 1, &count, nullptr );
+  herr_t const status = H5Dread( m_dataset, nativeType, memorySpace, fileSpace, H5P_DEFAULT, values );
+  H5Sclose( memorySpace );
+  H5Sclose( fileSpace );
+
+  GEOS_ERROR_IF( status < 0, GEOS_FMT( "Cannot read the range [{}, {}) of a dataset", offset, offset + count ));
+}
+
+bool probeHdf5Dataset( Hdf5DatasetLocation const & location,
+                       hsize_t & count,
+                       size_t & valueSize )
+{
+  std::lock_guard< std::recursive_mutex > const lock( hdf5Mutex() );
+  hid_t const file = H5Fopen( location.filePath.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT );
+  if( file < 0 )
+  {
+    return false;
+  }
+
+  hid_t const dataset = H5Dopen( file, location.datasetPath.c_str(), H5P_DEFAULT );
+  if( dataset < 0 )
+  {
+    H5Fclose( file );
+    return false;
+  }
+
+  hid_t const type = H5Dget_type( dataset );
+  hid_t const space = H5Dget_space( dataset );
+  count = LvArray::integerConversion< hsize_t >( H5Sget_simple_extent_npoints( space ));
+  valueSize = H5Tget_size( type );
+
+  H5Sclose( space );
+  H5Tclose( type );
+  H5Dclose( dataset );
+  H5Fclose( file );
+  return true;
+}
+
+/// Protects the registry of the mapped datasets
+static std::mutex mappedDatasetsMutex;
+
+/// Mapped datasets: values -> (mapping address, mapping length)
+static std::map< void *, std::pair< void *, size_t > > mappedDatasets;
+
+void * mapHdf5Dataset( Hdf5DatasetLocation const & location,
+                       hid_t const nativeType,
+                       hsize_t & count )
+{
+  count = 0;
+
+  std::unique_lock< std::recursive_mutex > lock( hdf5Mutex() );
+  hid_t const file = H5Fopen( location.filePath.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT );
+  if( file < 0 )
+  {
+    return nullptr;
+  }
+
+  hsize_t userBlockSize = 0;
+  hid_t const fcpl = H5Fget_create_plist( file );
+  H5Pget_userblock( fcpl, &userBlockSize );
+  H5Pclose( fcpl );
+
+  hid_t const dataset = H5Dopen( file, location.datasetPath.c_str(), H5P_DEFAULT );
+  if( dataset < 0 )
+  {
+    H5Fclose( file );
+    return nullptr;
+  }
+
+  hid_t const dcpl = H5Dget_create_plist( dataset );
+  hid_t const type = H5Dget_type( dataset );
+  hid_t const space = H5Dget_space( dataset );
+
+  // Only the contiguous, unfiltered and allocated datasets are stored as a plain array in the file
+  haddr_t const offset = H5Dget_offset( dataset );
+  bool const isMappable = H5Pget_layout( dcpl ) == H5D_CONTIGUOUS &&
+                          H5Pget_nfilters( dcpl ) == 0 &&
+                          H5Tequal( type, nativeType ) > 0 &&
+                          offset != HADDR_UNDEF;
+  hssize_t const numValues = H5Sget_simple_extent_npoints( space );
+
+  H5Sclose( space );
+  H5Tclose( type );
+  H5Pclose( dcpl );
+  H5Dclose( dataset );
+  H5Fclose( file );
+  lock.unlock();
+
+  if( !isMappable || numValues <= 0 )
+  {
+    return nullptr;
+  }
+
+  // The values are only used in place if they are aligned for their type
+  off_t const start = LvArray::integerConversion< off_t >( offset + userBlockSize );
+  if( start % LvArray::integerConversion< off_t >( H5Tget_size( nativeType )) != 0 )
+  {
+    return nullptr;
+  }
+
+  int const fd = ::open( location.filePath.c_str(), O_RDONLY );
+  if( fd < 0 )
+  {
+    return nullptr;
+  }
+
+  // The mapping must start on a page boundary
+  off_t const pageSize = sysconf( _SC_PAGESIZE );
+  off_t const alignedStart = start - start % pageSize;
+  size_t const length = numValues * H5Tget_size( nativeType ) + ( start - alignedStart );
+
+  void * const mapping = mmap( nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, alignedStart );
+  ::close( fd );
+  if( mapping == MAP_FAILED )
+  {
+    return nullptr;
+  }
+
+  void * const values = static_cast< char * >( mapping ) + ( start - alignedStart );
+  {
+    std::lock_guard< std::mutex > lock( mappedDatasetsMutex );
+    mappedDatasets[values] = { mapping, length };
+  }
+
+  count = LvArray::integerConversion< hsize_t >( numValues );
+  return values;
+}
+
+/// Number of raw chunks read before being decompressed together
+static constexpr hsize_t chunkBatchSize = 1024;
+
+bool readDeflatedHdf5Dataset( Hdf5DatasetLocation const & location,
+                              hid_t const nativeType,
+                              void * const values,
+                              hsize_t const count )
+{
+  std::unique_lock< std::recursive_mutex > lock( hdf5Mutex() );
+  hid_t const file = H5Fopen( location.filePath.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT );
+  if( file < 0 )
+  {
+    return false;
+  }
+
+  hid_t const dataset = H5Dopen( file, location.datasetPath.c_str(), H5P_DEFAULT );
+  if( dataset < 0 )
+  {
+    H5Fclose( file );
+    return false;
+  }
+
+  hid_t const dcpl = H5Dget_create_plist( dataset );
+  hid_t const type = H5Dget_type( dataset );
+  hid_t const space = H5Dget_space( dataset );
+
+  int const rank = H5Sget_simple_extent_ndims( space );
+  std::vector< hsize_t > dims( rank ), chunkDims( rank );
+  H5Sget_simple_extent_dims( space, dims.data(), nullptr );
+
+  // Position of the shuffle and deflate filters in the pipeline, -1 if absent
+  int shuffleFilter = -1;
+  int deflateFilter = -1;
+  bool isSupported = H5Pget_layout( dcpl ) == H5D_CHUNKED &&
+                     H5Tequal( type, nativeType ) > 0 &&
+                     H5Pget_chunk( dcpl, rank, chunkDims.data() ) == rank &&
+                     H5Sget_simple_extent_npoints( space ) == LvArray::integerConversion< hssize_t >( count );
+  int const numFilters = H5Pget_nfilters( dcpl );
+  for( int f = 0; f < numFilters && isSupported; ++f )
+  {
+    unsigned int flags;
+    size_t numValues = 0;
+    unsigned int filterConfig;
+    H5Z_filter_t const filter = H5Pget_filter2( dcpl, f, &flags, &numValues, nullptr, 0, nullptr, &filterConfig );
+    if( filter == H5Z_FILTER_SHUFFLE && deflateFilter < 0 )
+    {
+      shuffleFilter = f;
+    }
+    else if( filter == H5Z_FILTER_DEFLATE )
+    {
+      deflateFilter = f;
+    }
+    else
+    {
+      isSupported = false;
+    }
+  }
+
+  hsize_t numChunks = 0;
+  isSupported = isSupported && H5Dget_num_chunks( dataset, H5S_ALL, &numChunks ) >= 0;
+
+  // Fill value of the unwritten chunks, converted to the native type
+  size_t const valueSize = H5Tget_size( nativeType );
+  std::vector< unsigned char > fillValue( valueSize, 0 );
+  isSupported = isSupported && H5Pget_fill_value( dcpl, nativeType, fillValue.data() ) >= 0;
+
+  H5Sclose( space );
+  H5Tclose( type );
+  H5Pclose( dcpl );
+
+  if( !isSupported )
+  {
+    H5Dclose( dataset );
+    H5Fclose( file );
+    return false;
+  }
+
+  hsize_t chunkCount = 1;
+  for( hsize_t const chunkDim : chunkDims )
+  {
+    chunkCount *= chunkDim;
+  }
+  size_t const chunkBytes = chunkCount * valueSize;
+
+  // Unwritten chunks are not stored: their values are the fill value of the dataset
+  unsigned char * const bytes = static_cast< unsigned char * >( values );
+  if( std::all_of( fillValue.begin(), fillValue.end(), []( unsigned char const byte ) { return byte == 0; } ))
+  {
+    std::memset( values, 0, count * valueSize );
+  }
+  else
+  {
+    forAll< parallelHostPolicy >( LvArray::integerConversion< localIndex >( count ), [&]( localIndex const i )
+    {
+      std::memcpy( bytes + i * valueSize, fillValue.data(), valueSize );
+    } );
+  }
+
+  for( hsize_t firstChunk = 0; firstChunk < numChunks; firstChunk += chunkBatchSize )
+  {
+    hsize_t const batchSize = std::min( chunkBatchSize, numChunks - firstChunk );
+
+    // 1. Read the raw chunks sequentially
+    std::vector< std::vector< unsigned char > > rawChunks( batchSize );
+    std::vector< std::vector< hsize_t > > chunkOffsets( batchSize, std::vector< hsize_t >( rank ));
+    std::vector< uint32_t > filterMasks( batchSize );
+    bool isRead = true;
+    for( hsize_t c = 0; c < batchSize && isRead; ++c )
+    {
+      haddr_t address;
+      hsize_t size = 0;
+      unsigned int filterMask;
+      isRead = H5Dget_chunk_info( dataset, H5S_ALL, firstChunk + c, chunkOffsets[c].data(), &filterMask, &address, &size ) >= 0;
+      if( isRead )
+      {
+        rawChunks[c].resize( size );
+        isRead = H5Dread_chunk( dataset, H5P_DEFAULT, chunkOffsets[c].data(), &filterMasks[c], rawChunks[c].data() ) >= 0;
+      }
+    }
+
+    // The whole dataset is read by fesapi if a chunk cannot be read raw
+    if( !isRead )
+    {
+      H5Dclose( dataset );
+      H5Fclose( file );
+      return false;
+    }
+
+    // 2. Decompress and scatter the chunks in parallel, letting other threads use HDF5
+    std::atomic< bool > isInflated( true );
+    lock.unlock();
+    forAll< parallelHostPolicy >( batchSize, [&]( localIndex const c )
+    {
+      std::vector< unsigned char > chunk( chunkBytes );
+      std::vector< unsigned char > const & raw = rawChunks[c];
+
+      // A bit of the filter mask is set when the corresponding filter has been skipped for this chunk
+      bool const isDeflated = deflateFilter >= 0 && !( filterMasks[c] & ( 1u << deflateFilter ));
+      bool const isShuffled = shuffleFilter >= 0 && !( filterMasks[c] & ( 1u << shuffleFilter ));
+
+      // A chunk which cannot be inflated to its full size fails the whole read, which fesapi then takes over
+      if( isDeflated )
+      {
+        uLongf chunkSize = chunkBytes;
+        int const status = uncompress( chunk.data(), &chunkSize, raw.data(), raw.size() );
+        if( status != Z_OK || chunkSize != chunkBytes )
+        {
+          isInflated = false;
+          return;
+        }
+      }
+      else if( raw.size() == chunkBytes )
+      {
+        std::memcpy( chunk.data(), raw.data(), chunkBytes );
+      }
+      else
+      {
+        isInflated = false;
+        return;
+      }
+
+      if( isShuffled && valueSize > 1 )
+      {
+        std::vector< unsigned char > unshuffled( chunk );
+        size_t const numValues = chunkBytes / valueSize;
+        for( size_t i = 0; i < numValues; ++i )
+        {
+          for( size_t b = 0; b < valueSize; ++b )
+          {
+            unshuffled[i * valueSize + b] = chunk[b * numValues + i];
+          }
+        }
+        chunk.swap( unshuffled );
+      }
+
+      // Copy the rows of the chunk along the last dimension, clipped to the dataset extent
+      std::vector< hsize_t > const & offset = chunkOffsets[c];
+      hsize_t const rowLength = std::min( chunkDims[rank - 1], dims[rank - 1] - offset[rank - 1] );
+      std::vector< hsize_t > index( rank, 0 );
+      while( true )
+      {
+        bool isInside = true;
+        hsize_t chunkPosition = 0;
+        hsize_t datasetPosition = 0;
+        for( int d = 0; d < rank; ++d )
+        {
+          isInside = isInside && offset[d] + index[d] < dims[d];
+          chunkPosition = chunkPosition * chunkDims[d] + index[d];
+          datasetPosition = datasetPosition * dims[d] + offset[d] + index[d];
+        }
+        if( isInside )
+        {
+          std::memcpy( static_cast< unsigned char * >( values ) + datasetPosition * valueSize,
+                       chunk.data() + chunkPosition * valueSize,
+                       rowLength * valueSize );
+        }
+
+        // Next row of the chunk
+        int d = rank - 2;
+        while( d >= 0 && ++index[d] == chunkDims[d] )
+        {
+          index[d--] = 0;
+        }
+        if( d < 0 )
+        {
+          break;
+        }
+      }
+    } );
+    lock.lock();
+
+    if( !isInflated )
+    {
+      GEOS_WARNING( GEOS_FMT( "Could not inflate a chunk of {} in {}, the dataset is read by fesapi", location.datasetPath, location.filePath ));
+      H5Dclose( dataset );
+      H5Fclose( file );
+      return false;
+    }
+  }
+
+  H5Dclose( dataset );
+  H5Fclose( file );
+  return true;
+}
+
+void unmapHdf5Dataset( void * const values )
+{
+  std::lock_guard< std::mutex > lock( mappedDatasetsMutex );
+  auto const mapped = mappedDatasets.find( values );
+  GEOS_ERROR_IF( mapped == mappedDatasets.end(), "Releasing values which are not mapped from an HDF5 dataset" );
+
+  munmap( mapped->second.first, mapped->second.second );
+  mappedDatasets.erase( mapped );
+}
+
+} // namespace geos
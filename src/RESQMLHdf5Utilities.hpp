@@ -0,0 +1,229 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 TotalEnergies
+ * Copyright (c) 2019-     GEOSX Contributors
+ * All rights reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+/**
+ * @file RESQMLHdf5Utilities.hpp
+ */
+
+#ifndef GEOS_EXTERNALCOMPONENTS_RESQML_RESQMLHDF5UTILITIES_HPP
+#define GEOS_EXTERNALCOMPONENTS_RESQML_RESQMLHDF5UTILITIES_HPP
+
+#include "common/DataTypes.hpp"
+
+#include "fesapi/resqml2/AbstractValuesProperty.h"
+#include "fesapi/resqml2/SubRepresentation.h"
+#include "fesapi/resqml2/UnstructuredGridRepresentation.h"
+
+#include "hdf5.h"
+
+#include <mutex>
+
+namespace geos
+{
+
+/**
+ * @brief Location of a numerical array of a RESQML data object
+ */
+struct Hdf5DatasetLocation
+{
+  /// Absolute path of the HDF5 file
+  string filePath;
+
+  /// Path of the dataset in the HDF5 file
+  string datasetPath;
+};
+
+/**
+ * @brief Get the mutex serializing the HDF5 calls of the threads reading RESQML data
+ * @return the mutex, recursive so that the readers can be nested
+ * @details Any thread calling HDF5, directly or through fesapi, while another one may also do so must hold it.
+ * The readers of this file lock it themselves, and release it while they decompress.
+ */
+std::recursive_mutex & hdf5Mutex();
+
+/**
+ * @brief Locate the values of the first patch of a RESQML 2.0.1 property
+ * @param[in] valuesProperty the property
+ * @param[out] location the location of the values
+ * @return false if the values are not stored in a single HDF5 dataset
+ */
+bool locatePropertyValues( RESQML2_NS::AbstractValuesProperty const * valuesProperty,
+                           Hdf5DatasetLocation & location );
+
+/**
+ * @brief Locate the points of a RESQML 2.0.1 unstructured grid
+ * @param[in] grid the unstructured grid
+ * @param[out] location the location of the points
+ * @return false if the points are not stored in a single HDF5 dataset
+ */
+bool locateGridPoints( RESQML2_NS::UnstructuredGridRepresentation const * grid,
+                       Hdf5DatasetLocation & location );
+
+/**
+ * @brief Locate the element indices of a RESQML 2.0.1 subrepresentation
+ * @param[in] subrep the subrepresentation
+ * @param[out] location the location of the element indices
+ * @return false if the subrepresentation has several patches or element indices,
+ * or if its indices are not stored in a single HDF5 dataset
+ */
+bool locateSubRepresentationElements( RESQML2_NS::SubRepresentation const * subrep,
+                                      Hdf5DatasetLocation & location );
+
+/**
+ * @brief Location of the cumulative lengths of a RESQML 2.0.1 jagged array
+ */
+struct Hdf5CumulativeLengths
+{
+  /// Location of the dataset, empty if the cumulative lengths are a lattice
+  Hdf5DatasetLocation location;
+
+  /// First value of the lattice
+  hsize_t start = 0;
+
+  /// Increment of the lattice
+  hsize_t step = 0;
+};
+
+/**
+ * @brief Location of the topology arrays of a RESQML 2.0.1 unstructured grid
+ */
+struct Hdf5GridTopology
+{
+  /// Face indices of the cells
+  Hdf5DatasetLocation facesPerCell;
+
+  /// Cumulative face counts of the cells
+  Hdf5CumulativeLengths cumulativeFaceCountPerCell;
+
+  /// Node indices of the faces
+  Hdf5DatasetLocation nodesPerFace;
+
+  /// Cumulative node counts of the faces
+  Hdf5CumulativeLengths cumulativeNodeCountPerFace;
+
+  /// Right handedness of the faces of the cells
+  Hdf5DatasetLocation cellFaceIsRightHanded;
+};
+
+/**
+ * @brief Locate the topology arrays of a RESQML 2.0.1 unstructured grid
+ * @param[in] grid the unstructured grid
+ * @param[out] topology the location of the topology arrays
+ * @return false if an array is neither stored in a single HDF5 dataset nor, for cumulative lengths, a lattice
+ */
+bool locateGridTopology( RESQML2_NS::UnstructuredGridRepresentation const * grid,
+                         Hdf5GridTopology & topology );
+
+/**
+ * @brief Reader of ranges of values of a one-dimensional dataset
+ * @details The file and the dataset stay open between the reads.
+ */
+class Hdf5RangeReader
+{
+public:
+
+  /**
+   * @brief Open a dataset
+   * @param[in] location the location of the dataset
+   */
+  explicit Hdf5RangeReader( Hdf5DatasetLocation const & location );
+
+  /**
+   * @brief Close the dataset
+   */
+  ~Hdf5RangeReader();
+
+  /// Deleted copy constructor
+  Hdf5RangeReader( Hdf5RangeReader const & ) = delete;
+
+  /// Deleted copy assignment operator
+  Hdf5RangeReader & operator=( Hdf5RangeReader const & ) = delete;
+
+  /**
+   * @brief Get the number of values of the dataset
+   * @return the number of values
+   */
+  hsize_t size() const { return m_size; }
+
+  /**
+   * @brief Read a range of values
+   * @param[in] nativeType the HDF5 native type of the values in memory
+   * @param[in] offset the index of the first value
+   * @param[in] count the number of values
+   * @param[out] values the values, allocated by the caller
+   */
+  void read( hid_t nativeType, hsize_t offset, hsize_t count, void * values ) const;
+
+private:
+
+  /// The HDF5 file
+  hid_t m_file;
+
+  /// The dataset
+  hid_t m_dataset;
+
+  /// The number of values of the dataset
+  hsize_t m_size;
+};
+
+/**
+ * @brief Read the shape of a dataset without reading its values
+ * @param[in] location the location of the dataset
+ * @param[out] count the number of values
+ * @param[out] valueSize the size in bytes of a value in the file
+ * @return false if the dataset cannot be opened
+ */
+bool probeHdf5Dataset( Hdf5DatasetLocation const & location,
+                       hsize_t & count,
+                       size_t & valueSize );
+
+/**
+ * @brief Map the values of a dataset in memory without copying them
+ * @param[in] location the location of the dataset
+ * @param[in] nativeType the HDF5 native type of the values
+ * @param[out] count the number of values
+ * @return the values, nullptr if the dataset is chunked, filtered, not stored with the native type,
+ * or not aligned for the native type in the file
+ * @details The mapping is private: the values can be modified without modifying the file.
+ * It must be released with unmapHdf5Dataset, which can be used as a VTK array free function.
+ */
+void * mapHdf5Dataset( Hdf5DatasetLocation const & location,
+                       hid_t nativeType,
+                       hsize_t & count );
+
+/**
+ * @brief Read a chunked dataset compressed with deflate, decompressing its chunks in parallel
+ * @param[in] location the location of the dataset
+ * @param[in] nativeType the HDF5 native type of the values
+ * @param[out] values the values, allocated by the caller
+ * @param[in] count the number of values
+ * @return false if the dataset is not chunked, uses other filters than shuffle and deflate,
+ * is not stored with the native type, or if a raw chunk cannot be read or inflated to its full size:
+ * the values must then be read otherwise
+ * @details The raw chunks are read sequentially, then inflated and unshuffled by the host threads.
+ */
+bool readDeflatedHdf5Dataset( Hdf5DatasetLocation const & location,
+                              hid_t nativeType,
+                              void * values,
+                              hsize_t count );
+
+/**
+ * @brief Release the values mapped by mapHdf5Dataset
+ * @param[in] values the mapped values
+ */
+void unmapHdf5Dataset( void * values );
+
+} // namespace geos
+
+#endif /* GEOS_EXTERNALCOMPONENTS_RESQML_RESQMLHDF5UTILITIES_HPP */
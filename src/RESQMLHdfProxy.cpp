@@ -0,0 +1,146 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 TotalEnergies
+ * Copyright (c) 2019-     GEOSX Contributors
+ * All rights reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+/**
+ * @file RESQMLHdfProxy.cpp
+ */
+
+#include "RESQMLHdfProxy.hpp"
+
+#include "common/logger/Logger.hpp"
+
+#include "hdf5.h"
+
+namespace geos
+{
+
+RESQMLHdfProxy::RESQMLHdfProxy( gsoap_resqml2_0_1::_eml20__EpcExternalPartReference * fromGsoap,
+                                HdfReadSettings const & settings ):
+  EML2_0_NS::HdfProxy( fromGsoap ),
+  m_settings( settings )
+{}
+
+RESQMLHdfProxy::RESQMLHdfProxy( COMMON_NS::DataObjectRepository * repo,
+                                std::string const & guid,
+                                std::string const & title,
+                                std::string const & packageDirAbsolutePath,
+                                std::string const & externalFilePath,
+                                COMMON_NS::DataObjectRepository::openingMode hdfPermissionAccess,
+                                HdfReadSettings const & settings ):
+  EML2_0_NS::HdfProxy( repo, guid, title, packageDirAbsolutePath, externalFilePath, hdfPermissionAccess ),
+  m_settings( settings )
+{}
+
+/**
+ * @brief Create a file access property list with the read settings
+ * @param settings the read settings
+ * @param usePageBuffer flag to enable the page buffer
+ * @return the file access property list
+ */
+static hid_t createFileAccess( HdfReadSettings const & settings, bool const usePageBuffer )
+{
+  hid_t const fapl = H5Pcreate( H5P_FILE_ACCESS );
+
+  if( settings.chunkCacheSize > 0 || settings.chunkCacheSlots > 0 )
+  {
+    int mdcElements;
+    size_t slots, size;
+    double w0;
+    H5Pget_cache( fapl, &mdcElements, &slots, &size, &w0 );
+    H5Pset_cache( fapl, mdcElements,
+                  settings.chunkCacheSlots > 0 ? LvArray::integerConversion< size_t >( settings.chunkCacheSlots ) : slots,
+                  settings.chunkCacheSize > 0 ? LvArray::integerConversion< size_t >( settings.chunkCacheSize ) : size,
+                  w0 );
+  }
+
+  if( usePageBuffer && settings.pageBufferSize > 0 )
+  {
+    H5Pset_page_buffer_size( fapl, LvArray::integerConversion< size_t >( settings.pageBufferSize ), 0, 0 );
+  }
+
+  if( settings.metadataCacheSize > 0 )
+  {
+    H5AC_cache_config_t config;
+    config.version = H5AC__CURR_CACHE_CONFIG_VERSION;
+    H5Pget_mdc_config( fapl, &config );
+    config.set_initial_size = true;
+    config.initial_size = LvArray::integerConversion< size_t >( settings.metadataCacheSize );
+    config.max_size = std::max( config.max_size, config.initial_size );
+    config.min_size = std::min( config.min_size, config.initial_size );
+    H5Pset_mdc_config( fapl, &config );
+  }
+
+  if( settings.sieveBufferSize > 0 )
+  {
+    H5Pset_sieve_buf_size( fapl, LvArray::integerConversion< size_t >( settings.sieveBufferSize ));
+  }
+
+  return fapl;
+}
+
+void RESQMLHdfProxy::open()
+{
+  if( openingMode != COMMON_NS::DataObjectRepository::openingMode::READ_ONLY )
+  {
+    EML2_0_NS::HdfProxy::open();
+    return;
+  }
+
+  if( hdfFile > -1 )
+  {
+    close();
+  }
+
+  std::string const fullName = getPackageDirectoryAbsolutePath().empty()
+                               ? getRelativePath()
+                               : getPackageDirectoryAbsolutePath() + "/" + getRelativePath();
+
+  hid_t fapl = createFileAccess( m_settings, true );
+  hdfFile = H5Fopen( fullName.c_str(), H5F_ACC_RDONLY, fapl );
+
+  // The page buffer can only be used on files created with the paged aggregation strategy
+  bool const pageBufferFallback = hdfFile < 0 && m_settings.pageBufferSize > 0;
+  if( pageBufferFallback )
+  {
+    H5Pclose( fapl );
+    fapl = createFileAccess( m_settings, false );
+    hdfFile = H5Fopen( fullName.c_str(), H5F_ACC_RDONLY, fapl );
+  }
+  H5Pclose( fapl );
+
+  GEOS_ERROR_IF( hdfFile < 0, GEOS_FMT( "Could not open the HDF5 file {}", fullName ));
+
+  // Log the settings actually used by HDF5
+  hid_t const effective = H5Fget_access_plist( hdfFile );
+  int mdcElements;
+  size_t slots, chunkCacheSize, sieveBufferSize, pageBufferSize = 0;
+  double w0;
+  H5Pget_cache( effective, &mdcElements, &slots, &chunkCacheSize, &w0 );
+  H5Pget_sieve_buf_size( effective, &sieveBufferSize );
+  if( !pageBufferFallback )
+  {
+    H5Pget_page_buffer_size( effective, &pageBufferSize, nullptr, nullptr );
+  }
+  H5AC_cache_config_t config;
+  config.version = H5AC__CURR_CACHE_CONFIG_VERSION;
+  H5Pget_mdc_config( effective, &config );
+  H5Pclose( effective );
+
+  GEOS_LOG_RANK_0( GEOS_FMT( "Opened {}: chunk cache {} bytes / {} slots, page buffer {} bytes{}, metadata cache {} bytes, sieve buffer {} bytes",
+                             fullName, chunkCacheSize, slots, pageBufferSize,
+                             pageBufferFallback ? " (file not paged)" : "",
+                             config.initial_size, sieveBufferSize ));
+}
+
+} // namespace geos
@@ -0,0 +1,134 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 TotalEnergies
+ * Copyright (c) 2019-     GEOSX Contributors
+ * All rights reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+/**
+ * @file RESQMLHdfProxy.hpp
+ */
+
+#ifndef GEOS_EXTERNALCOMPONENTS_RESQML_RESQMLHDFPROXY_HPP
+#define GEOS_EXTERNALCOMPONENTS_RESQML_RESQMLHDFPROXY_HPP
+
+#include "common/DataTypes.hpp"
+
+#include "fesapi/common/HdfProxyFactory.h"
+#include "fesapi/eml2_0/HdfProxy.h"
+
+namespace geos
+{
+
+/**
+ * @brief HDF5 file access settings applied when reading the numerical data of a repository
+ * @details A zero value keeps the HDF5 default of the setting.
+ */
+struct HdfReadSettings
+{
+  /// Size in bytes of the raw data chunk cache of each dataset
+  localIndex chunkCacheSize = 0;
+
+  /// Number of slots of the raw data chunk cache hash table
+  integer chunkCacheSlots = 0;
+
+  /// Size in bytes of the page buffer, only used by files created with the paged aggregation strategy
+  localIndex pageBufferSize = 0;
+
+  /// Initial and maximum size in bytes of the metadata cache
+  localIndex metadataCacheSize = 0;
+
+  /// Size in bytes of the sieve buffer of the contiguous datasets
+  localIndex sieveBufferSize = 0;
+};
+
+/**
+ * @brief HDF proxy opening its file in read-only mode with tuned file access settings
+ */
+class RESQMLHdfProxy : public EML2_0_NS::HdfProxy
+{
+public:
+
+  /**
+   * @brief Constructor from an existing gSOAP EPC external part reference
+   * @param[in] fromGsoap the gSOAP proxy
+   * @param[in] settings the file access settings
+   */
+  RESQMLHdfProxy( gsoap_resqml2_0_1::_eml20__EpcExternalPartReference * fromGsoap,
+                  HdfReadSettings const & settings );
+
+  /**
+   * @brief Constructor of a new HDF proxy
+   * @param[in] repo the repository of the proxy
+   * @param[in] guid the UUID of the proxy
+   * @param[in] title the title of the proxy
+   * @param[in] packageDirAbsolutePath the directory of the EPC file
+   * @param[in] externalFilePath the path of the HDF5 file, relative to the EPC file
+   * @param[in] hdfPermissionAccess the opening mode of the HDF5 file
+   * @param[in] settings the file access settings
+   */
+  RESQMLHdfProxy( COMMON_NS::DataObjectRepository * repo,
+                  std::string const & guid,
+                  std::string const & title,
+                  std::string const & packageDirAbsolutePath,
+                  std::string const & externalFilePath,
+                  COMMON_NS::DataObjectRepository::openingMode hdfPermissionAccess,
+                  HdfReadSettings const & settings );
+
+  /**
+   * @brief Open the HDF5 file, with the tuned settings if it is opened in read-only mode
+   */
+  void open() override;
+
+private:
+
+  /// File access settings
+  HdfReadSettings m_settings;
+};
+
+/**
+ * @brief HDF proxy factory creating RESQMLHdfProxy objects
+ */
+class RESQMLHdfProxyFactory : public COMMON_NS::HdfProxyFactory
+{
+public:
+
+  /**
+   * @brief Constructor
+   * @param[in] settings the file access settings of the created proxies
+   */
+  explicit RESQMLHdfProxyFactory( HdfReadSettings const & settings ):
+    m_settings( settings )
+  {}
+
+  EML2_NS::AbstractHdfProxy * make( gsoap_resqml2_0_1::_eml20__EpcExternalPartReference * fromGsoap ) override
+  {
+    return new RESQMLHdfProxy( fromGsoap, m_settings );
+  }
+
+  EML2_NS::AbstractHdfProxy * make( COMMON_NS::DataObjectRepository * repo,
+                                    std::string const & guid,
+                                    std::string const & title,
+                                    std::string const & packageDirAbsolutePath,
+                                    std::string const & externalFilePath,
+                                    COMMON_NS::DataObjectRepository::openingMode hdfPermissionAccess ) override
+  {
+    return new RESQMLHdfProxy( repo, guid, title, packageDirAbsolutePath, externalFilePath, hdfPermissionAccess, m_settings );
+  }
+
+private:
+
+  /// File access settings of the created proxies
+  HdfReadSettings m_settings;
+};
+
+} // namespace geos
+
+#endif /* GEOS_EXTERNALCOMPONENTS_RESQML_RESQMLHDFPROXY_HPP */
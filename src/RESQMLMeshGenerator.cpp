@@ -32,15 +32,30 @@
 #include "EnergyMLDataObjectRepository.hpp"
 #include "Region.hpp"
 #include "Property.hpp"
+#include "PropertyRegion.hpp"
 #include "Surface.hpp"
 
 #include <vtkBoundingBox.h>
 #include <vtkUnstructuredGrid.h>
 #include <vtkDataArray.h>
-#include <vtkXMLUnstructuredGridWriter.h>
-#include <vtkExplicitStructuredGridToUnstructuredGrid.h>
+#include <vtkExtractCells.h>
+#include <vtkIdList.h>
+#include <vtkIdTypeArray.h>
+#include <vtkMultiProcessController.h>
 #include <unordered_set>
-
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <numeric>
+#include <thread>
+
+#include <unistd.h>
+
+#include <fesapi/resqml2/AbstractIjkGridRepresentation.h>
 #include <fesapi/resqml2/UnstructuredGridRepresentation.h>
 #include <fesapi/resqml2/AbstractValuesProperty.h>
 #include <fesapi/resqml2/SubRepresentation.h>
@@ -52,6 +67,63 @@ namespace geos
 
 using namespace dataRepository;
 
+namespace
+{
+
+/// Name of the cell array holding the index of the cells in the mesh loaded on rank 0, while a partition is cached
+constexpr char const * loadedCellIdArrayName = "RESQMLLoadedCellId";
+
+/**
+ * @brief Send the cells of each partition of the mesh loaded on rank 0 to the rank of the partition
+ * @param mesh the mesh loaded on rank 0, empty on the other ranks
+ * @param partitions the partition of each cell on rank 0, empty on the other ranks
+ * @return the cells of the partition of the current rank
+ */
+vtkSmartPointer< vtkDataSet >
+scatterPartitions( vtkSmartPointer< vtkDataSet > mesh, std::vector< int > const & partitions )
+{
+  vtkSmartPointer< vtkMultiProcessController > controller = vtk::getController();
+  constexpr int partitionTag = 4800;
+  if( controller->GetLocalProcessId() != 0 )
+  {
+    vtkSmartPointer< vtkDataObject > const received = vtkSmartPointer< vtkDataObject >::Take( controller->ReceiveDataObject( 0, partitionTag ));
+    return vtkSmartPointer< vtkDataSet >( vtkDataSet::SafeDownCast( received ));
+  }
+
+  int const rankCount = controller->GetNumberOfProcesses();
+  std::vector< vtkSmartPointer< vtkIdList > > partitionCells( rankCount );
+  for( auto & cells : partitionCells )
+  {
+    cells = vtkSmartPointer< vtkIdList >::New();
+  }
+  for( vtkIdType cellId = 0; cellId < mesh->GetNumberOfCells(); ++cellId )
+  {
+    partitionCells[partitions[cellId]]->InsertNextId( cellId );
+  }
+
+  vtkSmartPointer< vtkDataSet > localMesh;
+  for( int partition = 0; partition < rankCount; ++partition )
+  {
+    vtkNew< vtkExtractCells > extractor;
+    extractor->SetInputData( mesh );
+    extractor->SetCellList( partitionCells[partition] );
+    extractor->Update();
+    partitionCells[partition] = nullptr;
+    if( partition == 0 )
+    {
+      localMesh = extractor->GetOutput();
+    }
+    else
+    {
+      controller->Send( extractor->GetOutput(), partition, partitionTag );
+    }
+  }
+
+  return localMesh;
+}
+
+} // namespace
+
 RESQMLMeshGenerator::RESQMLMeshGenerator( string const & name,
                                           Group * const parent )
   : ExternalMeshGeneratorBase( name, parent ),
@@ -95,6 +167,58 @@ RESQMLMeshGenerator::RESQMLMeshGenerator( string const & name,
                     " If set to 0 (default value), the GlobalId arrays in the input mesh are used if available, and generated otherwise."
                     " If set to a negative value, the GlobalId arrays in the input mesh are not used, and generated global Ids are automatically generated."
                     " If set to a positive value, the GlobalId arrays in the input mesh are used and required, and the simulation aborts if they are not available" );
+
+  registerWrapper( viewKeyStruct::streamingChunkSizeString(), &m_streamingChunkSize ).
+    setInputFlag( InputFlags::OPTIONAL ).
+    setApplyDefaultValue( 0 ).
+    setDescription( "Number of cells of an unstructured grid whose topology is read and converted at once on rank 0."
+                    " The topology of each range of cells is released once converted, which bounds the memory used by huge grids."
+                    " If set to 0 (default value), the whole topology is loaded at once" );
+
+  registerWrapper( viewKeyStruct::compactInactiveCellsString(), &m_compactInactiveCells ).
+    setInputFlag( InputFlags::OPTIONAL ).
+    setApplyDefaultValue( 0 ).
+    setDescription( "Controls the cells of an IJK grid without geometry."
+                    " If set to 0 (default value), they are loaded as hexahedra like the other cells."
+                    " If set to 1, they are dropped with the points only they use, so that partitioning only sees active cells."
+                    " The RESQML index of the loaded cells is kept in the RESQMLCellIndex cell array" );
+
+  registerWrapper( viewKeyStruct::structuredPartitionMethodString(), &m_structuredPartitionMethod ).
+    setInputFlag( InputFlags::OPTIONAL ).
+    setApplyDefaultValue( StructuredPartitionMethod::none ).
+    setDescription( "Method partitioning an IJK grid from the (i,j,k) indices of its cells, instead of the graph partitioner of " +
+                    string( viewKeyStruct::partitionMethodString() ) + ". Valid options: ``" + EnumStrings< StructuredPartitionMethod >::concat( "``, ``" ) + "``."
+                    " With ``cartesian``, the (i,j,k) box is recursively bisected; with ``hilbert``, the cells are split along a Hilbert curve."
+                    " Both give each rank the same number of loaded cells, so only the active cells count when compactInactiveCells is set."
+                    " Unstructured grids are always partitioned by " + string( viewKeyStruct::partitionMethodString() ) );
+
+  registerWrapper( viewKeyStruct::cellReorderingString(), &m_cellReordering ).
+    setInputFlag( InputFlags::OPTIONAL ).
+    setApplyDefaultValue( CellReordering::none ).
+    setDescription( "Method reordering the cells and the nodes of each rank after the redistribution, for memory locality."
+                    " Valid options: ``" + EnumStrings< CellReordering >::concat( "``, ``" ) + "``."
+                    " With ``hilbert``, the cells are sorted along a Hilbert curve over their centers and the nodes follow the first cell using them" );
+
+  registerWrapper( viewKeyStruct::asynchronousLoadingString(), &m_asynchronousLoading ).
+    setInputFlag( InputFlags::OPTIONAL ).
+    setApplyDefaultValue( 0 ).
+    setDescription( "Controls the reading of the regions and properties on rank 0."
+                    " If set to 0 (default value), they are read one by one once the grid is converted."
+                    " If set to 1, a thread reads them while the grid is converted, at most two of them ahead of the conversion" );
+
+  registerWrapper( viewKeyStruct::deferredRegionsAndSurfacesString(), &m_deferredRegionsAndSurfaces ).
+    setInputFlag( InputFlags::OPTIONAL ).
+    setApplyDefaultValue( 0 ).
+    setDescription( "Controls the loading of the Region subrepresentations and of the Surface children."
+                    " If set to 0 (default value), rank 0 loads them in the whole mesh, which is then redistributed with them."
+                    " If set to 1, each rank reads them by ranges once the mesh is redistributed, and keeps the cells and faces it holds."
+                    " The regions of the PropertyRegion children are still applied on rank 0, and are kept over the Region subrepresentations" );
+
+  registerWrapper( viewKeyStruct::partitionCacheDirectoryString(), &m_partitionCacheDirectory ).
+    setInputFlag( InputFlags::OPTIONAL ).
+    setDescription( "Directory of the partition cache. The rank of each cell is stored after the first partitioning in a file named"
+                    " after the grid UUID and the number of ranks, and reused by the next runs with the same grid, number of cells"
+                    " and partition settings. If empty (default value), the mesh is partitioned at each run" );
 }
 
 Group * RESQMLMeshGenerator::createChild( string const & childKey, string const & childName )
@@ -105,6 +229,11 @@ Group * RESQMLMeshGenerator::createChild( string const & childKey, string const
     m_regions.emplace_back( childName );
     return &registerGroup< Region >( childName );
   }
+  else if( childKey == groupKeyStruct::propertyRegionString())
+  {
+    m_propertyRegions.emplace_back( childName );
+    return &registerGroup< PropertyRegion >( childName );
+  }
   else if( childKey == groupKeyStruct::propertyString())
   {
     m_properties.emplace_back( childName );
@@ -144,6 +273,10 @@ void RESQMLMeshGenerator::postInputInitialization()
                  getName() << ": EnergyML Data Object Repository not found: " << m_objectName,
                  InputError );
 
+  GEOS_THROW_IF( m_streamingChunkSize < 0,
+                 getName() << ": " << viewKeyStruct::streamingChunkSizeString() << " must be positive or zero",
+                 InputError );
+
   COMMON_NS::AbstractObject * rep{nullptr};
 
   if( !m_uuid.empty())
@@ -157,6 +290,30 @@ void RESQMLMeshGenerator::postInputInitialization()
 
   m_title = rep->getTitle();
   m_uuid = rep->getUuid();
+
+  // The regions, surfaces and sparse properties loaded on each rank find their cells from the global ids,
+  // which must be the RESQML indices of the cells
+  if( m_useGlobalIds < 0 )
+  {
+    GEOS_THROW_IF( m_deferredRegionsAndSurfaces != 0,
+                   getName() << ": " << viewKeyStruct::deferredRegionsAndSurfacesString() << " requires the global ids of the input mesh, "
+                             << viewKeyStruct::useGlobalIdsString() << " must not be negative",
+                   InputError );
+
+    for( const auto & p : m_properties )
+    {
+      Property const & property = this->getGroup< Property >( p );
+      if( property.getUUID().empty() && property.getTitle().empty())
+      {
+        continue;
+      }
+
+      GEOS_THROW_IF( getPropertySubRepresentation( findProperty( property.getUUID(), property.getTitle() )) != nullptr,
+                     getName() << ": the property " << p << " is supported by a subrepresentation, which requires the global ids of the input mesh, "
+                               << viewKeyStruct::useGlobalIdsString() << " must not be negative",
+                     InputError );
+    }
+  }
 }
 
 void RESQMLMeshGenerator::fillCellBlockManager( CellBlockManager & cellBlockManager, SpatialPartition & partition )
@@ -172,10 +329,59 @@ void RESQMLMeshGenerator::fillCellBlockManager( CellBlockManager & cellBlockMana
     GEOS_LOG_LEVEL_RANK_0( 2, "  reading the dataset..." );
     vtkSmartPointer< vtkDataSet > loadedMesh = loadMesh( );
 
+    // A cached or structured partition is only kept by the generic redistribution when it is not refined
+    integer partitionRefinement = m_partitionRefinement;
+    bool const cachePartition = !m_partitionCacheDirectory.empty() && MpiWrapper::commSize( comm ) > 1;
+    bool isPartitionCached = false;
+    if( cachePartition )
+    {
+      vtkSmartPointer< vtkDataSet > partitionedMesh = loadCachedPartition( loadedMesh );
+      isPartitionCached = partitionedMesh != nullptr;
+      if( isPartitionCached )
+      {
+        loadedMesh = partitionedMesh;
+        partitionRefinement = 0;
+      }
+      else if( MpiWrapper::commRank( comm ) == 0 )
+      {
+        vtkNew< vtkIdTypeArray > loadedCellIds;
+        loadedCellIds->SetName( loadedCellIdArrayName );
+        loadedCellIds->SetNumberOfValues( loadedMesh->GetNumberOfCells());
+        std::iota( loadedCellIds->GetPointer( 0 ), loadedCellIds->GetPointer( 0 ) + loadedMesh->GetNumberOfCells(), 0 );
+        loadedMesh->GetCellData()->AddArray( loadedCellIds );
+      }
+    }
+
+    if( !isPartitionCached && m_structuredPartitionMethod != StructuredPartitionMethod::none && MpiWrapper::commSize( comm ) > 1 )
+    {
+      GEOS_LOG_LEVEL_RANK_0( 2, "  partitioning the IJK grid..." );
+      vtkSmartPointer< vtkDataSet > partitionedMesh = partitionStructuredMesh( loadedMesh );
+      if( partitionedMesh != nullptr )
+      {
+        loadedMesh = partitionedMesh;
+        partitionRefinement = 0;
+      }
+    }
+
     GEOS_LOG_LEVEL_RANK_0( 2, "  redistributing mesh..." );
     std::map< string, vtkSmartPointer< vtkDataSet > > empty{};
-    vtk::AllMeshes redistributedMeshes = vtk::redistributeMeshes( getLogLevel(), loadedMesh, empty, comm, m_partitionMethod, m_partitionRefinement, m_useGlobalIds );
+    vtk::AllMeshes redistributedMeshes = vtk::redistributeMeshes( getLogLevel(), loadedMesh, empty, comm, m_partitionMethod, partitionRefinement, m_useGlobalIds );
     m_vtkMesh = redistributedMeshes.getMainMesh();
+    if( cachePartition && !isPartitionCached )
+    {
+      writePartitionCache( *m_vtkMesh );
+    }
+    if( m_cellReordering != CellReordering::none )
+    {
+      GEOS_LOG_LEVEL_RANK_0( 2, "  reordering cells..." );
+      m_vtkMesh = reorderCells( m_vtkMesh, m_cellReordering );
+    }
+    if( m_deferredRegionsAndSurfaces != 0 )
+    {
+      GEOS_LOG_LEVEL_RANK_0( 2, "  loading the regions and surfaces of each rank..." );
+      loadOwnedRegionsAndSurfaces();
+    }
+    loadOwnedSparseProperties();
     GEOS_LOG_LEVEL_RANK_0( 2, "  finding neighbor ranks..." );
     std::vector< vtkBoundingBox > boxes = vtk::exchangeBoundingBoxes( *m_vtkMesh, comm );
     std::vector< int > const neighbors = vtk::findNeighborRanks( std::move( boxes ) );
@@ -187,6 +393,7 @@ void RESQMLMeshGenerator::fillCellBlockManager( CellBlockManager & cellBlockMana
 
 
   GEOS_LOG_LEVEL_RANK_0( 2, "  preprocessing..." );
+  convertRegionIdsToInt( *m_vtkMesh, m_attributeName );
   m_cellMap = vtk::buildCellMap( *m_vtkMesh, m_attributeName );
 
   GEOS_LOG_LEVEL_RANK_0( 2, "  writing nodes..." );
@@ -232,56 +439,107 @@ void RESQMLMeshGenerator::freeResources()
 }
 
 
-vtkSmartPointer< vtkDataSet >
-RESQMLMeshGenerator::loadSurfaces( vtkSmartPointer< vtkDataSet > mesh )
+RESQML2_NS::SubRepresentation *
+RESQMLMeshGenerator::findSubRepresentation( string const & uuid,
+                                            string const & title,
+                                            gsoap_eml2_3::eml23__IndexableElement const kind ) const
 {
-  std::vector< std::pair< integer, RESQML2_NS::SubRepresentation * > > surfaces;
+  char const * const kindName = kind == gsoap_eml2_3::eml23__IndexableElement::faces ? "faces" : "cells";
 
-  for( const auto & s : m_surfaces )
+  if( !uuid.empty())
   {
-    Surface const & surface = this->getGroup< Surface >( s );
+    auto * subrep = dynamic_cast< RESQML2_NS::SubRepresentation * >( m_repository->getDataObject( uuid ));
+    if( subrep == nullptr )
+      GEOS_ERROR( GEOS_FMT( "There exists no such data object with uuid {}", uuid ) );
+
+    if( subrep->getElementKindOfPatch( 0, 0 ) != kind )
+      GEOS_ERROR( GEOS_FMT( "There subrepresentation {} must index {} elements in the mesh", uuid, kindName ) );
 
-    GEOS_LOG( GEOS_FMT( "{}", surface.getTitle()));
+    return subrep;
+  }
 
-    if( !surface.getUUID().empty())
+  for( auto * subrep : m_repository->getData()->getSubRepresentationSet())
+  {
+    if( !subrep->isPartial() &&
+        subrep->getElementKindOfPatch( 0, 0 ) == kind &&
+        subrep->getTitle() == title )
     {
-      GEOS_LOG_RANK_0( GEOS_FMT( "{} '{}': reading surface {}", catalogName(), getName(), surface.getUUID() ) );
+      return subrep;
+    }
+  }
 
-      auto * subrep = m_repository->getData()->getDataObjectByUuid< RESQML2_NS::SubRepresentation >( surface.getUUID() );
-      if( subrep == nullptr )
-        GEOS_ERROR( GEOS_FMT( "There exists no such data object with uuid {}", surface.getUUID() ) );
+  // The subrepresentation may not be loaded yet
+  auto * subrep = dynamic_cast< RESQML2_NS::SubRepresentation * >( m_repository->getDataObjectByTitle( title ));
+  if( subrep != nullptr && subrep->getElementKindOfPatch( 0, 0 ) == kind )
+  {
+    return subrep;
+  }
 
-      if( subrep->getElementKindOfPatch( 0, 0 ) != gsoap_eml2_3::eml23__IndexableElement::faces )
-        GEOS_ERROR( GEOS_FMT( "There subrepresentation {} must be a surface", surface.getUUID() ) );
+  GEOS_ERROR( GEOS_FMT( "There exists no such data object with title {}", title ) );
+  return nullptr;
+}
 
-      surfaces.push_back( std::make_pair( surface.getRegionId(), subrep ) );
-    }
-    else if( !surface.getTitle().empty())
+std::vector< RESQML2_NS::SubRepresentation * >
+RESQMLMeshGenerator::getRegionSubRepresentations() const
+{
+  std::vector< RESQML2_NS::SubRepresentation * > regions;
+
+  for( const auto & r : m_regions )
+  {
+    Region const & region = this->getGroup< Region >( r );
+
+    if( !region.getUUID().empty() || !region.getTitle().empty())
     {
-      auto searchSurface = [&]( string const & surface_name ) -> RESQML2_NS::SubRepresentation *
-      {
-        for( auto * subrep : m_repository->getData()->getSubRepresentationSet())
-        {
-          if( subrep->getElementKindOfPatch( 0, 0 ) == gsoap_eml2_3::eml23__IndexableElement::faces  &&
-              subrep->getTitle() == surface_name )
-          {
-            return subrep;
-          }
-        }
+      regions.push_back( findSubRepresentation( region.getUUID(), region.getTitle(), gsoap_eml2_3::eml23__IndexableElement::cells ) );
+    }
+  }
 
-        return nullptr;
-      };
+  return regions;
+}
 
-      auto * subrep = searchSurface( surface.getTitle() );
-      if( subrep == nullptr )
-        GEOS_ERROR( GEOS_FMT( "There exists no such data object with title {}", surface.getTitle() ) );
+std::vector< std::pair< RESQML2_NS::AbstractValuesProperty *, std::map< integer, integer > > >
+RESQMLMeshGenerator::getRegionProperties() const
+{
+  std::vector< std::pair< RESQML2_NS::AbstractValuesProperty *, std::map< integer, integer > > > regionProperties;
 
-      GEOS_LOG_RANK_0( GEOS_FMT( "{} '{}': reading surface {} - {}", catalogName(), getName(), subrep->getTitle(), subrep->getUuid() ) );
-      surfaces.push_back( std::make_pair( surface.getRegionId(), subrep ) );
+  for( const auto & r : m_propertyRegions )
+  {
+    PropertyRegion const & propertyRegion = this->getGroup< PropertyRegion >( r );
+    regionProperties.emplace_back( findProperty( propertyRegion.getUUID(), propertyRegion.getTitle() ), propertyRegion.getRegionIdOfValue() );
+  }
+
+  return regionProperties;
+}
+
+std::vector< std::pair< integer, RESQML2_NS::SubRepresentation * > >
+RESQMLMeshGenerator::getSurfaceSubRepresentations() const
+{
+  std::vector< std::pair< integer, RESQML2_NS::SubRepresentation * > > surfaces;
 
+  for( const auto & s : m_surfaces )
+  {
+    Surface const & surface = this->getGroup< Surface >( s );
+
+    if( !surface.getUUID().empty() || !surface.getTitle().empty())
+    {
+      auto * subrep = findSubRepresentation( surface.getUUID(), surface.getTitle(), gsoap_eml2_3::eml23__IndexableElement::faces );
+      surfaces.push_back( std::make_pair( surface.getRegionId(), subrep ) );
     }
   }
 
+  return surfaces;
+}
+
+vtkSmartPointer< vtkDataSet >
+RESQMLMeshGenerator::loadSurfaces( vtkSmartPointer< vtkDataSet > mesh )
+{
+  std::vector< std::pair< integer, RESQML2_NS::SubRepresentation * > > const surfaces = getSurfaceSubRepresentations();
+
+  for( auto const & surface : surfaces )
+  {
+    GEOS_LOG_RANK_0( GEOS_FMT( "{} '{}': reading surface {} - {}", catalogName(), getName(), surface.second->getTitle(), surface.second->getUuid() ) );
+  }
+
   mesh = createSurfaces( mesh, surfaces, m_attributeName );
 
   return mesh;
@@ -290,113 +548,129 @@ RESQMLMeshGenerator::loadSurfaces( vtkSmartPointer< vtkDataSet > mesh )
 vtkSmartPointer< vtkDataSet >
 RESQMLMeshGenerator::loadRegions( vtkSmartPointer< vtkDataSet > mesh )
 {
+  // The region subrepresentations may be loaded by each rank after the redistribution
   std::vector< RESQML2_NS::SubRepresentation * > regions;
+  if( m_deferredRegionsAndSurfaces == 0 )
+  {
+    regions = getRegionSubRepresentations();
+  }
 
-  for( const auto & r : m_regions )
+  for( auto const * subrep : regions )
   {
-    Region const & region = this->getGroup< Region >( r );
+    GEOS_LOG_RANK_0( GEOS_FMT( "{} '{}': reading region {} - {}", catalogName(), getName(), subrep->getTitle(), subrep->getUuid() ) );
+  }
 
-    if( !region.getUUID().empty())
-    {
-      GEOS_LOG_RANK_0( GEOS_FMT( "{} '{}': reading region {}", catalogName(), getName(), region.getUUID() ) );
+  mesh = createRegions( mesh, regions, m_attributeName );
 
-      auto * subrep = m_repository->getData()->getDataObjectByUuid< RESQML2_NS::SubRepresentation >( region.getUUID() );
-      if( subrep == nullptr )
-        GEOS_ERROR( GEOS_FMT( "There exists no such data object with uuid {}", region.getUUID() ) );
+  // The regions of the property values are applied over the regions of the subrepresentations
+  for( auto const & [property, regionIdOfValue] : getRegionProperties())
+  {
+    GEOS_LOG_RANK_0( GEOS_FMT( "{} '{}': reading regions of property {} - {}", catalogName(), getName(), property->getTitle(), property->getUuid() ) );
+    mesh = createRegionsFromProperty( mesh, readProperty( property, property->getTitle() ), regionIdOfValue, m_attributeName );
+  }
 
-      if( subrep->getElementKindOfPatch( 0, 0 ) != gsoap_eml2_3::eml23__IndexableElement::cells )
-        GEOS_ERROR( GEOS_FMT( "There subrepresentation {} must index cells elements in the mesh", region.getUUID() ) );
+  // The cells given a region by a property keep it when the regions of the subrepresentations are loaded on each rank
+  if( m_deferredRegionsAndSurfaces == 0 )
+  {
+    mesh->GetCellData()->RemoveArray( propertyRegionCellArrayName );
+  }
 
-      regions.push_back( subrep );
-    }
-    else if( !region.getTitle().empty())
-    {
-      auto searchRegion = [&]( string const & region_name ) -> RESQML2_NS::SubRepresentation *
-      {
-        for( auto * subrep : m_repository->getData()->getSubRepresentationSet())
-        {
-          if( subrep->getElementKindOfPatch( 0, 0 ) == gsoap_eml2_3::eml23__IndexableElement::cells  &&
-              subrep->getTitle() == region_name )
-          {
-            return subrep;
-          }
-        }
+  return mesh;
+}
 
-        return nullptr;
-      };
 
-      auto * subrep = searchRegion( region.getTitle() );
-      if( subrep == nullptr )
-        GEOS_ERROR( GEOS_FMT( "There exists no such data object with title {}", region.getTitle() ) );
+RESQML2_NS::AbstractValuesProperty *
+RESQMLMeshGenerator::findProperty( string const & uuid, string const & title ) const
+{
+  if( !uuid.empty())
+  {
+    auto * prop = dynamic_cast< RESQML2_NS::AbstractValuesProperty * >( m_repository->getDataObject( uuid ));
+    if( prop == nullptr )
+      GEOS_ERROR( GEOS_FMT( "There exists no such data object with uuid {}", uuid ) );
 
-      GEOS_LOG_RANK_0( GEOS_FMT( "{} '{}': reading region {} - {}", catalogName(), getName(), subrep->getTitle(), subrep->getUuid() ) );
-      regions.push_back( subrep );
+    return prop;
+  }
 
+  for( auto * value_prop : m_repository->getData()->getDataObjects< RESQML2_NS::AbstractValuesProperty >())
+  {
+    if( !value_prop->isPartial() && value_prop->getTitle() == title )
+    {
+      return value_prop;
     }
   }
 
-  mesh = createRegions( mesh, regions, m_attributeName );
+  // The property may not be loaded yet
+  auto * prop = dynamic_cast< RESQML2_NS::AbstractValuesProperty * >( m_repository->getDataObjectByTitle( title ));
+  if( prop == nullptr )
+    GEOS_ERROR( GEOS_FMT( "There exists no such data object with title {}", title ) );
 
-  return mesh;
+  return prop;
 }
 
-
-vtkSmartPointer< vtkDataSet >
-RESQMLMeshGenerator::loadProperties( vtkSmartPointer< vtkDataSet > mesh )
+std::vector< RESQML2_NS::AbstractValuesProperty * >
+RESQMLMeshGenerator::findProperties() const
 {
   std::vector< RESQML2_NS::AbstractValuesProperty * > fields_list;
 
   for( const auto & p : m_properties )
   {
-
     Property const & property = this->getGroup< Property >( p );
-    if( !property.getUUID().empty())
+    if( !property.getUUID().empty() || !property.getTitle().empty())
     {
-      auto * prop = m_repository->getData()->getDataObjectByUuid< RESQML2_NS::AbstractValuesProperty >( property.getUUID() );
-      if( prop == nullptr )
-        GEOS_ERROR( GEOS_FMT( "There exists no such data object with uuid {} and title {}", property.getUUID() ) );
+      fields_list.push_back( findProperty( property.getUUID(), property.getTitle() ) );
+    }
+  }
 
-      GEOS_LOG_RANK_0( GEOS_FMT( "{} '{}': reading property {} - {}", catalogName(), getName(), prop->getTitle(), prop->getUuid() ) );
+  return fields_list;
+}
 
-      fields_list.push_back( prop );
+vtkSmartPointer< vtkDataSet >
+RESQMLMeshGenerator::loadProperties( vtkSmartPointer< vtkDataSet > mesh )
+{
+  std::vector< RESQML2_NS::AbstractValuesProperty * > fields_list = findProperties();
 
-    }
-    else if( !property.getTitle().empty())
+  // load the properties as fields
+  for( unsigned int i = 0; i < fields_list.size(); ++i )
+  {
+    // The properties of a subrepresentation are loaded by each rank after the redistribution
+    if( getPropertySubRepresentation( fields_list[i] ) != nullptr )
     {
-      auto searchPropery = [&]( string const & field_name ) -> RESQML2_NS::AbstractValuesProperty *
-      {
-        for( auto * value_prop : m_repository->getData()->getDataObjects< RESQML2_NS::AbstractValuesProperty >())
-        {
-          if( value_prop->getTitle() == field_name )
-          {
-            return value_prop;
-          }
-        }
+      continue;
+    }
+    GEOS_LOG_RANK_0( GEOS_FMT( "{} '{}': reading property {} - {}", catalogName(), getName(), fields_list[i]->getTitle(), fields_list[i]->getUuid() ) );
+    mesh = loadProperty( mesh, fields_list[i], m_properties[i] );
+  }
+
+  return mesh;
+}
 
-        return nullptr;
-      };
 
-      auto * prop = searchPropery( property.getTitle() );
-      if( prop == nullptr )
-        GEOS_ERROR( GEOS_FMT( "There exists no such data object with title {}", property.getTitle() ) );
+globalIndex RESQMLMeshGenerator::getCellCount() const
+{
+  COMMON_NS::AbstractObject * rep = !m_uuid.empty() ? m_repository->getDataObject( m_uuid ) : m_repository->getDataObjectByTitle( m_title );
+  GEOS_ERROR_IF( rep == nullptr, GEOS_FMT( "There exists no such data object with uuid {} or title {} in the epc file", m_uuid, m_title ) );
 
-      GEOS_LOG_RANK_0( GEOS_FMT( "{} '{}': reading property {} - {}", catalogName(), getName(), prop->getTitle(), prop->getUuid() ) );
+  return probeGridRepresentation( rep ).cellCount;
+}
 
-      fields_list.push_back( prop );
+GridProbe
+RESQMLMeshGenerator::probe() const
+{
+  COMMON_NS::AbstractObject * rep = !m_uuid.empty() ? m_repository->getDataObject( m_uuid ) : m_repository->getDataObjectByTitle( m_title );
+  GEOS_ERROR_IF( rep == nullptr, GEOS_FMT( "There exists no such data object with uuid {} or title {} in the epc file", m_uuid, m_title ) );
 
-    }
-  }
+  GridProbe gridProbe = probeGridRepresentation( rep );
 
-  // load the properties as fields
-  for( unsigned int i = 0; i < fields_list.size(); ++i )
+  for( auto * prop : findProperties())
   {
-    mesh = loadProperty( mesh, fields_list[i], m_properties[i] );
+    globalIndex const bytes = probePropertyBytes( prop );
+    gridProbe.propertyBytes[prop->getTitle()] = bytes;
+    gridProbe.estimatedBytes += bytes;
   }
 
-  return mesh;
+  return gridProbe;
 }
 
-
 vtkSmartPointer< vtkDataSet >
 RESQMLMeshGenerator::retrieveUnstructuredGrid()
 {
@@ -413,7 +687,10 @@ RESQMLMeshGenerator::retrieveUnstructuredGrid()
 
   m_title = rep->getTitle();
   m_uuid = rep->getUuid();
-  vtkSmartPointer< vtkDataSet > loadedMesh = loadGridRepresentation( rep );
+  GridLoadOptions options;
+  options.streamingChunkSize = m_streamingChunkSize;
+  options.compactInactiveCells = m_compactInactiveCells != 0;
+  vtkSmartPointer< vtkDataSet > loadedMesh = loadGridRepresentation( rep, options );
 
   GEOS_LOG_RANK_0( GEOS_FMT( "GetNumberOfCells  {}", loadedMesh->GetNumberOfCells()) );
   GEOS_LOG_RANK_0( GEOS_FMT( "GetNumberOfPoints {}", loadedMesh->GetNumberOfPoints()) );
@@ -428,48 +705,442 @@ RESQMLMeshGenerator::loadMesh()
 {
   if( MpiWrapper::commRank() == 0 )
   {
-    GEOS_LOG_LEVEL_RANK_0( 2, "  reading the RESQML dataset..." );
-    vtkSmartPointer< vtkDataSet > loadedMesh = retrieveUnstructuredGrid( );
+    GridProbe const gridProbe = probe();
+    GEOS_LOG_RANK_0( GEOS_FMT( "{} '{}': {} cells, {} nodes, {} faces, about {} MB to load",
+                               catalogName(), getName(), gridProbe.cellCount, gridProbe.nodeCount, gridProbe.faceCount,
+                               gridProbe.estimatedBytes / ( 1024 * 1024 ) ) );
+    for( auto const & [cellShape, cellCount] : gridProbe.cellShapes )
+    {
+      GEOS_LOG_LEVEL_RANK_0( 1, GEOS_FMT( "  {} {}", cellCount, cellShape ) );
+    }
+    for( auto const & [title, bytes] : gridProbe.propertyBytes )
+    {
+      GEOS_LOG_LEVEL_RANK_0( 1, GEOS_FMT( "  property {}: {} bytes", title, bytes ) );
+    }
 
-    GEOS_LOG_LEVEL_RANK_0( 2, "  (regions) load the RESQML subrepresentations into vtk attributes..." );
-    loadedMesh = loadRegions( loadedMesh );
+    vtkSmartPointer< vtkDataSet > loadedMesh;
+    if( m_asynchronousLoading != 0 )
+    {
+      GEOS_LOG_LEVEL_RANK_0( 2, "  reading the RESQML dataset, regions and properties..." );
+      loadedMesh = loadMeshAsynchronously();
+    }
+    else
+    {
+      GEOS_LOG_LEVEL_RANK_0( 2, "  reading the RESQML dataset..." );
+      loadedMesh = retrieveUnstructuredGrid( );
 
-    GEOS_LOG_LEVEL_RANK_0( 2, "  (fields) load the RESQML Properties into vtk attributes..." );
-    loadedMesh = loadProperties( loadedMesh );
+      GEOS_LOG_LEVEL_RANK_0( 2, "  (regions) load the RESQML subrepresentations into vtk attributes..." );
+      loadedMesh = loadRegions( loadedMesh );
+
+      GEOS_LOG_LEVEL_RANK_0( 2, "  (fields) load the RESQML Properties into vtk attributes..." );
+      loadedMesh = loadProperties( loadedMesh );
+    }
 
-    GEOS_LOG_LEVEL_RANK_0( 2, "  (surfaces) load the RESQML subrepresentations into the vtk grid..." );
-    loadedMesh = loadSurfaces( loadedMesh );
+    if( m_deferredRegionsAndSurfaces == 0 )
+    {
+      GEOS_LOG_LEVEL_RANK_0( 2, "  (surfaces) load the RESQML subrepresentations into the vtk grid..." );
+      loadedMesh = loadSurfaces( loadedMesh );
+    }
 
     GEOS_LOG_LEVEL_RANK_0( 2, "  ... end" );
 
-    GEOS_LOG_LEVEL_RANK_0( 2, "  temporary write" );
+    return loadedMesh;
+  }
+  else
+  {
+    return vtkSmartPointer< vtkUnstructuredGrid >::New();
+  }
+}
+
+/**
+ * @brief Queue of a bounded number of items passed from a producer thread to a consumer thread
+ */
+template< typename T >
+class BoundedQueue
+{
+public:
+
+  /**
+   * @brief Create an empty queue
+   * @param capacity the number of items held at most
+   */
+  explicit BoundedQueue( std::size_t const capacity ):
+    m_capacity( capacity )
+  {}
+
+  /**
+   * @brief Add an item, waiting for room in the queue
+   * @param item the item
+   * @return false if the queue has been closed by the consumer
+   */
+  bool push( T item )
+  {
+    std::unique_lock< std::mutex > lock( m_mutex );
+    m_changed.wait( lock, [this]() { return m_isClosed || m_items.size() < m_capacity; } );
+    if( m_isClosed )
+    {
+      return false;
+    }
+    m_items.push_back( std::move( item ));
+    m_changed.notify_all();
+    return true;
+  }
+
+  /**
+   * @brief Remove the first item, waiting for one
+   * @return the item
+   */
+  T pop()
+  {
+    std::unique_lock< std::mutex > lock( m_mutex );
+    m_changed.wait( lock, [this]() { return !m_items.empty(); } );
+    T item = std::move( m_items.front());
+    m_items.pop_front();
+    m_changed.notify_all();
+    return item;
+  }
+
+  /**
+   * @brief Stop the producer, whose next push fails
+   */
+  void close()
+  {
+    std::lock_guard< std::mutex > const lock( m_mutex );
+    m_isClosed = true;
+    m_changed.notify_all();
+  }
+
+private:
 
+  std::size_t const m_capacity;
+  std::mutex m_mutex;
+  std::condition_variable m_changed;
+  std::deque< T > m_items;
+  bool m_isClosed = false;
+};
 
-    if( loadedMesh->IsA( "vtkExplicitStructuredGrid" ))
+vtkSmartPointer< vtkDataSet >
+RESQMLMeshGenerator::loadMeshAsynchronously()
+{
+  // Resolving a data object may deserialize parts of the EPC files:
+  // all of them are resolved before the reading thread starts
+  if( !m_uuid.empty())
+    m_repository->getDataObject( m_uuid );
+  else if( !m_title.empty())
+    m_repository->getDataObjectByTitle( m_title );
+  std::vector< RESQML2_NS::SubRepresentation * > const regions = m_deferredRegionsAndSurfaces == 0
+                                                               ? getRegionSubRepresentations()
+                                                               : std::vector< RESQML2_NS::SubRepresentation * >();
+  auto const regionProperties = getRegionProperties();
+  // The properties of a subrepresentation are loaded by each rank after the redistribution
+  std::vector< RESQML2_NS::AbstractValuesProperty * > properties;
+  std::vector< string > propertyNames;
+  std::vector< RESQML2_NS::AbstractValuesProperty * > const allProperties = findProperties();
+  for( std::size_t i = 0; i < allProperties.size(); ++i )
+  {
+    if( getPropertySubRepresentation( allProperties[i] ) == nullptr )
     {
-      vtkNew< vtkExplicitStructuredGridToUnstructuredGrid > ugConvertor;
-      ugConvertor->SetInputData( loadedMesh );
-      ugConvertor->Update();
-
-      vtkNew< vtkXMLUnstructuredGridWriter > writer;
-      writer->SetFileName( "tmp_output.vtu" );
-      writer->SetInputData( ugConvertor->GetOutput() );
-      writer->Write();
+      properties.push_back( allProperties[i] );
+      propertyNames.push_back( m_properties[i] );
     }
-    else
+  }
+  for( auto const * subrep : regions )
+  {
+    GEOS_LOG_RANK_0( GEOS_FMT( "{} '{}': reading region {} - {}", catalogName(), getName(), subrep->getTitle(), subrep->getUuid() ) );
+  }
+  for( auto const & regionProperty : regionProperties )
+  {
+    GEOS_LOG_RANK_0( GEOS_FMT( "{} '{}': reading regions of property {} - {}", catalogName(), getName(),
+                               regionProperty.first->getTitle(), regionProperty.first->getUuid() ) );
+  }
+  for( auto const * property : properties )
+  {
+    GEOS_LOG_RANK_0( GEOS_FMT( "{} '{}': reading property {} - {}", catalogName(), getName(), property->getTitle(), property->getUuid() ) );
+  }
+
+  // The reading thread reads the cells of the regions and the values of the region properties, then the values of each property,
+  // while the grid is converted. It stays at most two payloads ahead of the conversion.
+  struct Payload
+  {
+    std::vector< CellBitset > regionCells;
+    std::vector< vtkSmartPointer< vtkDataArray > > regionValues;
+    vtkSmartPointer< vtkDataArray > values;
+    std::exception_ptr error;
+  };
+  BoundedQueue< Payload > payloads( 2 );
+  std::thread reading( [&]()
+  {
+    try
+    {
+      Payload regionPayload;
+      for( RESQML2_NS::SubRepresentation * region : regions )
+      {
+        regionPayload.regionCells.emplace_back( readRegionCells( region ));
+      }
+      for( auto const & regionProperty : regionProperties )
+      {
+        regionPayload.regionValues.emplace_back( readProperty( regionProperty.first, regionProperty.first->getTitle() ));
+      }
+      if( !payloads.push( std::move( regionPayload )))
+      {
+        return;
+      }
+      for( std::size_t i = 0; i < properties.size(); ++i )
+      {
+        Payload propertyPayload;
+        propertyPayload.values = readProperty( properties[i], propertyNames[i] );
+        if( !payloads.push( std::move( propertyPayload )))
+        {
+          return;
+        }
+      }
+    }
+    catch( ... )
     {
-      vtkNew< vtkXMLUnstructuredGridWriter > writer;
-      writer->SetFileName( "tmp_output.vtu" );
-      writer->SetInputData( loadedMesh );
-      writer->Write();
+      Payload errorPayload;
+      errorPayload.error = std::current_exception();
+      payloads.push( std::move( errorPayload ));
     }
+  } );
 
-    return loadedMesh;
+  vtkSmartPointer< vtkDataSet > loadedMesh;
+  try
+  {
+    loadedMesh = retrieveUnstructuredGrid();
+    for( std::size_t i = 0; i <= properties.size(); ++i )
+    {
+      Payload payload = payloads.pop();
+      if( payload.error )
+      {
+        std::rethrow_exception( payload.error );
+      }
+      if( i == 0 )
+      {
+        loadedMesh = createRegions( loadedMesh, payload.regionCells, m_attributeName );
+        for( std::size_t j = 0; j < regionProperties.size(); ++j )
+        {
+          loadedMesh = createRegionsFromProperty( loadedMesh, payload.regionValues[j], regionProperties[j].second, m_attributeName );
+        }
+      }
+      else
+      {
+        loadedMesh = addProperty( loadedMesh, payload.values );
+      }
+    }
   }
-  else
+  catch( ... )
   {
-    return vtkSmartPointer< vtkUnstructuredGrid >::New();
+    payloads.close();
+    reading.join();
+    throw;
   }
+  reading.join();
+
+  return loadedMesh;
+}
+
+void RESQMLMeshGenerator::loadOwnedRegionsAndSurfaces()
+{
+  std::vector< RESQML2_NS::SubRepresentation * > const regions = getRegionSubRepresentations();
+  for( auto const * subrep : regions )
+  {
+    GEOS_LOG_RANK_0( GEOS_FMT( "{} '{}': reading region {} - {} on each rank", catalogName(), getName(), subrep->getTitle(), subrep->getUuid() ) );
+  }
+  m_vtkMesh = createOwnedRegions( m_vtkMesh, regions, m_attributeName );
+
+  std::vector< std::pair< integer, RESQML2_NS::SubRepresentation * > > const surfaces = getSurfaceSubRepresentations();
+  if( surfaces.empty())
+  {
+    return;
+  }
+  for( auto const & surface : surfaces )
+  {
+    GEOS_LOG_RANK_0( GEOS_FMT( "{} '{}': reading surface {} - {} on each rank", catalogName(), getName(), surface.second->getTitle(), surface.second->getUuid() ) );
+  }
+
+  // The faces get global ids following the ones of the cells of all the ranks
+  vtkIdTypeArray * const globalIds = vtkIdTypeArray::SafeDownCast( m_vtkMesh->GetCellData()->GetGlobalIds());
+  vtkIdType localMaxGlobalId = -1;
+  if( globalIds != nullptr && globalIds->GetNumberOfTuples() > 0 )
+  {
+    localMaxGlobalId = *std::max_element( globalIds->GetPointer( 0 ), globalIds->GetPointer( 0 ) + globalIds->GetNumberOfTuples());
+  }
+  vtkIdType const firstGlobalId = MpiWrapper::max( localMaxGlobalId, MPI_COMM_GEOS ) + 1;
+
+  m_vtkMesh = createOwnedSurfaces( m_vtkMesh, surfaces, m_attributeName, firstGlobalId );
+}
+
+void RESQMLMeshGenerator::loadOwnedSparseProperties()
+{
+  for( const auto & p : m_properties )
+  {
+    Property const & property = this->getGroup< Property >( p );
+    if( property.getUUID().empty() && property.getTitle().empty())
+    {
+      continue;
+    }
+
+    RESQML2_NS::AbstractValuesProperty * const valuesProperty = findProperty( property.getUUID(), property.getTitle() );
+    RESQML2_NS::SubRepresentation * const subrep = getPropertySubRepresentation( valuesProperty );
+    if( subrep == nullptr )
+    {
+      continue;
+    }
+
+    GEOS_LOG_RANK_0( GEOS_FMT( "{} '{}': reading property {} - {} of subrepresentation {} on each rank",
+                               catalogName(), getName(), valuesProperty->getTitle(), valuesProperty->getUuid(), subrep->getTitle() ) );
+    GEOS_ERROR_IF( subrep->getSupportingRepresentation( 0 )->getUuid() != m_uuid,
+                   GEOS_FMT( "The subrepresentation {} of the property {} must be a subrepresentation of the mesh {}",
+                             subrep->getUuid(), valuesProperty->getUuid(), m_uuid ) );
+    m_vtkMesh = createOwnedSparseProperty( m_vtkMesh, valuesProperty, p, property.getDefaultValue() );
+  }
+}
+
+vtkSmartPointer< vtkDataSet >
+RESQMLMeshGenerator::partitionStructuredMesh( vtkSmartPointer< vtkDataSet > mesh ) const
+{
+  MPI_Comm const comm = MPI_COMM_GEOS;
+  int const rank = MpiWrapper::commRank( comm );
+  int const rankCount = MpiWrapper::commSize( comm );
+
+  // Only rank 0 knows whether the loaded grid is an IJK grid
+  RESQML2_NS::AbstractIjkGridRepresentation * grid = nullptr;
+  if( rank == 0 )
+  {
+    grid = dynamic_cast< RESQML2_NS::AbstractIjkGridRepresentation * >( m_repository->getDataObject( m_uuid ));
+    GEOS_LOG_RANK_0_IF( grid == nullptr,
+                        GEOS_FMT( "{} '{}': {} only applies to IJK grids, {} is partitioned by {}", catalogName(), getName(),
+                                  viewKeyStruct::structuredPartitionMethodString(), m_title, viewKeyStruct::partitionMethodString() ) );
+  }
+  integer isStructured = grid != nullptr;
+  MpiWrapper::broadcast( isStructured, 0, comm );
+  if( !isStructured )
+  {
+    return nullptr;
+  }
+
+  std::vector< int > partitions;
+  if( rank == 0 )
+  {
+    partitions = partitionIjkGrid( mesh, grid, m_structuredPartitionMethod, rankCount );
+  }
+  return scatterPartitions( mesh, partitions );
+}
+
+vtkSmartPointer< vtkDataSet >
+RESQMLMeshGenerator::loadCachedPartition( vtkSmartPointer< vtkDataSet > mesh ) const
+{
+  MPI_Comm const comm = MPI_COMM_GEOS;
+  std::vector< int > partitions;
+  integer isCached = 0;
+  if( MpiWrapper::commRank( comm ) == 0 )
+  {
+    string const path = partitionCachePath();
+    std::ifstream file( path, std::ios::binary );
+    string header;
+    if( file && std::getline( file, header ) && header == partitionCacheHeader( mesh->GetNumberOfCells() ))
+    {
+      partitions.resize( mesh->GetNumberOfCells() );
+      file.read( reinterpret_cast< char * >( partitions.data() ), partitions.size() * sizeof( int ));
+      int const rankCount = MpiWrapper::commSize( comm );
+      isCached = file.gcount() == static_cast< std::streamsize >( partitions.size() * sizeof( int )) &&
+                 std::all_of( partitions.begin(), partitions.end(), [rankCount]( int const p ) { return p >= 0 && p < rankCount; } );
+    }
+    GEOS_LOG_RANK_0( GEOS_FMT( "{} '{}': {} partition cache {}", catalogName(), getName(), isCached ? "reusing the" : "no valid", path ) );
+  }
+
+  MpiWrapper::broadcast( isCached, 0, comm );
+  if( !isCached )
+  {
+    return nullptr;
+  }
+  return scatterPartitions( mesh, partitions );
+}
+
+void RESQMLMeshGenerator::writePartitionCache( vtkDataSet & mesh ) const
+{
+  MPI_Comm const comm = MPI_COMM_GEOS;
+  int const rank = MpiWrapper::commRank( comm );
+  int const rankCount = MpiWrapper::commSize( comm );
+
+  // Each rank sends the loaded index of the cells it owns
+  vtkIdTypeArray * const loadedCellIds = vtkIdTypeArray::SafeDownCast( mesh.GetCellData()->GetArray( loadedCellIdArrayName ));
+  int const localCellCount = loadedCellIds == nullptr ? 0 : LvArray::integerConversion< int >( loadedCellIds->GetNumberOfTuples());
+  std::vector< long long > localCellIds( localCellCount );
+  for( int cellId = 0; cellId < localCellCount; ++cellId )
+  {
+    localCellIds[cellId] = loadedCellIds->GetValue( cellId );
+  }
+  mesh.GetCellData()->RemoveArray( loadedCellIdArrayName );
+
+  // The cell ids are received rank by rank, so that their offsets are not limited to int
+  constexpr int cellIdsTag = 4820;
+  std::vector< int > cellCounts( rankCount );
+  MpiWrapper::gather( &localCellCount, 1, cellCounts.data(), 1, 0, comm );
+  if( rank != 0 )
+  {
+    MPI_Request request;
+    MpiWrapper::iSend( localCellIds.data(), localCellCount, 0, cellIdsTag, comm, &request );
+    MpiWrapper::waitAll( 1, &request, MPI_STATUSES_IGNORE );
+    return;
+  }
+
+  std::vector< globalIndex > offsets( rankCount + 1, 0 );
+  for( int r = 0; r < rankCount; ++r )
+  {
+    offsets[r + 1] = offsets[r] + cellCounts[r];
+  }
+  std::vector< long long > cellIds( offsets.back() );
+  std::copy( localCellIds.begin(), localCellIds.end(), cellIds.begin() );
+  std::vector< MPI_Request > requests( rankCount - 1 );
+  for( int r = 1; r < rankCount; ++r )
+  {
+    MpiWrapper::iRecv( cellIds.data() + offsets[r], cellCounts[r], r, cellIdsTag, comm, &requests[r - 1] );
+  }
+  MpiWrapper::waitAll( rankCount - 1, requests.data(), MPI_STATUSES_IGNORE );
+
+  std::vector< int > partitions( cellIds.size() );
+  for( int partition = 0; partition < rankCount; ++partition )
+  {
+    for( globalIndex position = offsets[partition]; position < offsets[partition + 1]; ++position )
+    {
+      partitions[cellIds[position]] = partition;
+    }
+  }
+
+  // The file is renamed once written so that concurrent runs never read a partial file
+  string const path = partitionCachePath();
+  string const temporaryPath = GEOS_FMT( "{}.{}", path, ::getpid() );
+  {
+    std::ofstream file( temporaryPath, std::ios::binary | std::ios::trunc );
+    file << partitionCacheHeader( LvArray::integerConversion< vtkIdType >( partitions.size() )) << '\n';
+    file.write( reinterpret_cast< char const * >( partitions.data() ), partitions.size() * sizeof( int ));
+    if( !file )
+    {
+      GEOS_WARNING( GEOS_FMT( "{} '{}': cannot write the partition cache {}", catalogName(), getName(), path ) );
+      return;
+    }
+  }
+  if( std::rename( temporaryPath.c_str(), path.c_str() ) != 0 )
+  {
+    std::remove( temporaryPath.c_str() );
+    GEOS_WARNING( GEOS_FMT( "{} '{}': cannot write the partition cache {}", catalogName(), getName(), path ) );
+    return;
+  }
+  GEOS_LOG_RANK_0( GEOS_FMT( "{} '{}': partition cached in {}", catalogName(), getName(), path ) );
+}
+
+string RESQMLMeshGenerator::partitionCachePath() const
+{
+  return GEOS_FMT( "{}/{}_{}.partition", string( m_partitionCacheDirectory ), m_uuid, MpiWrapper::commSize() );
+}
+
+string RESQMLMeshGenerator::partitionCacheHeader( vtkIdType const cellCount ) const
+{
+  return GEOS_FMT( "RESQML partition uuid={} cells={} ranks={} partitionMethod={} partitionRefinement={} structuredPartitionMethod={} compactInactiveCells={}",
+                   m_uuid, cellCount, MpiWrapper::commSize(),
+                   EnumStrings< vtk::PartitionMethod >::toString( m_partitionMethod ), m_partitionRefinement,
+                   EnumStrings< StructuredPartitionMethod >::toString( m_structuredPartitionMethod ), m_compactInactiveCells );
 }
 
 std::tuple< string, string > RESQMLMeshGenerator::getParentRepresentation() const
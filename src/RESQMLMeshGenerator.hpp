@@ -21,11 +21,13 @@
 // #include "mesh/ElementType.hpp"
 #include "mesh/generators/ExternalMeshGeneratorBase.hpp"
 #include "mesh/generators/VTKUtilities.hpp"
+#include "RESQMLUtilities.hpp"
 #include "mesh/mpiCommunications/SpatialPartition.hpp"
 // #include "mesh/FieldIdentifiers.hpp"
 #include <vtkDataSet.h>
 
 #include "fesapi/common/EpcDocument.h"
+#include "fesapi/resqml2/SubRepresentation.h"
 
 namespace geos
 {
@@ -90,6 +92,48 @@ public:
   const std::string & getTitle() const { return m_title; }
   const std::string & getUuid() const { return m_uuid; }
 
+  /**
+   * @brief Look for a subrepresentation of the repository by UUID or, if the UUID is empty, by title
+   * @param[in] uuid the UUID of the subrepresentation
+   * @param[in] title the title of the subrepresentation
+   * @param[in] kind the kind of elements indexed by the subrepresentation
+   * @return the subrepresentation
+   */
+  RESQML2_NS::SubRepresentation * findSubRepresentation( string const & uuid,
+                                                         string const & title,
+                                                         gsoap_eml2_3::eml23__IndexableElement kind ) const;
+
+  /**
+   * @brief Get the subrepresentations of the Region children, in the order of their region ids
+   * @return the subrepresentations
+   * @note The repository is available on every rank, so this can be called after the mesh has been distributed.
+   */
+  std::vector< RESQML2_NS::SubRepresentation * > getRegionSubRepresentations() const;
+
+  /**
+   * @brief Get the properties of the PropertyRegion children, with the region id of their values
+   * @return the properties and their lookup tables, in the order of the PropertyRegion children
+   */
+  std::vector< std::pair< RESQML2_NS::AbstractValuesProperty *, std::map< integer, integer > > > getRegionProperties() const;
+
+  /**
+   * @brief Get the subrepresentations of the Surface children, with their region ids
+   * @return the region ids and subrepresentations, in the order of the Surface children
+   */
+  std::vector< std::pair< integer, RESQML2_NS::SubRepresentation * > > getSurfaceSubRepresentations() const;
+
+  /**
+   * @brief Get the number of cells of the grid, including the inactive cells of a compacted grid
+   * @return the number of cells
+   */
+  globalIndex getCellCount() const;
+
+  /**
+   * @brief Probe the sizes of the grid and of the properties to load, without reading any array
+   * @return the sizes of the grid and of the properties
+   */
+  GridProbe probe() const;
+
 protected:
 
   /**
@@ -113,11 +157,19 @@ private:
     constexpr static char const * partitionRefinementString() { return "partitionRefinement"; }
     constexpr static char const * partitionMethodString() { return "partitionMethod"; }
     constexpr static char const * useGlobalIdsString() { return "useGlobalIds"; }
+    constexpr static char const * streamingChunkSizeString() { return "streamingChunkSize"; }
+    constexpr static char const * compactInactiveCellsString() { return "compactInactiveCells"; }
+    constexpr static char const * structuredPartitionMethodString() { return "structuredPartitionMethod"; }
+    constexpr static char const * partitionCacheDirectoryString() { return "partitionCacheDirectory"; }
+    constexpr static char const * cellReorderingString() { return "cellReordering"; }
+    constexpr static char const * asynchronousLoadingString() { return "asynchronousLoading"; }
+    constexpr static char const * deferredRegionsAndSurfacesString() { return "deferredRegionsAndSurfaces"; }
   };
 
   struct groupKeyStruct
   {
     static constexpr char const * regionString() { return "Region"; }
+    static constexpr char const * propertyRegionString() { return "PropertyRegion"; }
     static constexpr char const * propertyString() { return "Property"; }
     static constexpr char const * surfaceString() { return "Surface"; }
   };
@@ -156,6 +208,32 @@ private:
    */
   vtkSmartPointer< vtkDataSet > loadRegions( vtkSmartPointer< vtkDataSet > mesh );
 
+  /**
+   * @brief Load the regions and the surfaces in the cells of the current rank, once the mesh is redistributed
+   * @details Each rank reads the subrepresentations by ranges and keeps the cells and faces it holds.
+   */
+  void loadOwnedRegionsAndSurfaces();
+
+  /**
+   * @brief Load the properties supported by a subrepresentation in the cells of the current rank, once the mesh is redistributed
+   * @details Each rank reads the subrepresentations and the values by ranges and keeps the values of the cells it holds.
+   */
+  void loadOwnedSparseProperties();
+
+  /**
+   * @brief Look for a property of the repository by UUID or, if the UUID is empty, by title
+   * @param[in] uuid the UUID of the property
+   * @param[in] title the title of the property
+   * @return the property
+   */
+  RESQML2_NS::AbstractValuesProperty * findProperty( string const & uuid, string const & title ) const;
+
+  /**
+   * @brief Look for the RESQML properties of the Property children
+   * @return the properties, in the order of the Property children
+   */
+  std::vector< RESQML2_NS::AbstractValuesProperty * > findProperties() const;
+
   /**
    * @brief Load a list of fields from fesapi into CellData of a vtkDataSet
    * @param[in] mesh The dataset in which load the fields
@@ -175,6 +253,43 @@ private:
    */
   vtkSmartPointer< vtkDataSet > loadMesh();
 
+  /**
+   * @brief Load the grid, the regions and the properties, reading the regions and properties while the grid is converted
+   * @return the grid with the region and property cell arrays
+   */
+  vtkSmartPointer< vtkDataSet > loadMeshAsynchronously();
+
+  /**
+   * @brief Partition an IJK grid loaded on rank 0 from the logical indices of its cells
+   * @param[in] mesh The mesh loaded on rank 0, empty on the other ranks
+   * @return the cells of the partition of the current rank
+   */
+  vtkSmartPointer< vtkDataSet > partitionStructuredMesh( vtkSmartPointer< vtkDataSet > mesh ) const;
+
+  /**
+   * @brief Partition the mesh loaded on rank 0 with the partition cache
+   * @param[in] mesh The mesh loaded on rank 0, empty on the other ranks
+   * @return the cells of the partition of the current rank, nullptr if there is no valid cache
+   */
+  vtkSmartPointer< vtkDataSet > loadCachedPartition( vtkSmartPointer< vtkDataSet > mesh ) const;
+
+  /**
+   * @brief Store the partition of the redistributed mesh in the partition cache
+   * @param[in] mesh The cells owned by the current rank, whose temporary loaded cell index array is removed
+   */
+  void writePartitionCache( vtkDataSet & mesh ) const;
+
+  /**
+   * @return the path of the partition cache file of the grid
+   */
+  string partitionCachePath() const;
+
+  /**
+   * @param[in] cellCount The number of cells of the loaded mesh
+   * @return the first line of the partition cache file, identifying the grid and the partition settings
+   */
+  string partitionCacheHeader( vtkIdType cellCount ) const;
+
 
   ///Repository of RESQML objects
   EnergyMLDataObjectRepository * m_repository;
@@ -186,6 +301,7 @@ private:
 
 
   string_array m_regions;
+  string_array m_propertyRegions;
   string_array m_surfaces;
   string_array m_properties;
 
@@ -222,6 +338,27 @@ private:
   /// Method (library) used to partition the mesh
   vtk::PartitionMethod m_partitionMethod = vtk::PartitionMethod::parmetis;
 
+  /// Number of cells of an unstructured grid converted at once, 0 to load the whole topology
+  globalIndex m_streamingChunkSize = 0;
+
+  /// Whether the cells of an IJK grid without geometry are dropped at load time
+  integer m_compactInactiveCells = 0;
+
+  /// Method partitioning an IJK grid from the logical indices of its cells
+  StructuredPartitionMethod m_structuredPartitionMethod = StructuredPartitionMethod::none;
+
+  /// Directory of the partition cache, empty to partition the mesh at each run
+  Path m_partitionCacheDirectory;
+
+  /// Method reordering the cells of each rank after the redistribution
+  CellReordering m_cellReordering = CellReordering::none;
+
+  /// Whether the regions and properties are read by a thread while the grid is converted
+  integer m_asynchronousLoading = 0;
+
+  /// Whether the region subrepresentations and the surfaces are loaded by each rank after the redistribution
+  integer m_deferredRegionsAndSurfaces = 0;
+
   /// Lists of VTK cell ids, organized by element type, then by region
   vtk::CellMapType m_cellMap;
 };
@@ -21,6 +21,8 @@
 #include "mesh/MeshManager.hpp"
 #include "RESQMLMeshGenerator.hpp"
 
+#include <cctype>
+
 
 
 namespace geos
@@ -28,6 +30,30 @@ namespace geos
 
 using namespace dataRepository;
 
+/**
+ * @brief Check whether a string is formatted as a UUID
+ * @param str the string
+ * @return true if the string is made of 8-4-4-4-12 hexadecimal digits
+ */
+static bool isUuid( string const & str )
+{
+  if( str.size() != 36 )
+  {
+    return false;
+  }
+
+  for( std::size_t i = 0; i < str.size(); ++i )
+  {
+    bool const isDash = i == 8 || i == 13 || i == 18 || i == 23;
+    if( isDash ? str[i] != '-' : !std::isxdigit( static_cast< unsigned char >( str[i] )))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 RESQMLOutput::RESQMLOutput( string const & name,
                             Group * const parent ):
   OutputBase( name, parent )
@@ -36,6 +62,15 @@ RESQMLOutput::RESQMLOutput( string const & name,
   , m_onlyPlotSpecifiedFieldNames()
   , m_fieldNames( )
   , m_referenceObjectName( )
+  , m_writeOnParentGrid()
+  , m_packScalarFields()
+  , m_temporalReductions()
+  , m_dumpFrequency()
+  , m_executionCount( 0 )
+  , m_summaryFieldNames()
+  , m_summaryWeightFieldName()
+  , m_outputRegions()
+  , m_outputBoundingBox()
   , m_writer( getOutputDirectory() )
 {
   registerWrapper( viewKeysStruct::plotFileName, &m_plotFileName ).
@@ -66,6 +101,48 @@ RESQMLOutput::RESQMLOutput( string const & name,
     setInputFlag( InputFlags::OPTIONAL ).
     setDescription( "The name of the object from which to retrieve field values." );
 
+  registerWrapper( viewKeysStruct::writeOnParentGrid, &m_writeOnParentGrid ).
+    setApplyDefaultValue( 0 ).
+    setInputFlag( InputFlags::OPTIONAL ).
+    setDescription( "If this flag is equal to 1, the properties are written directly on the parent grid, ordered by global cell index, "
+                    "instead of on one subrepresentation per field. Cells without value for a field are set to zero." );
+
+  registerWrapper( viewKeysStruct::packScalarFields, &m_packScalarFields ).
+    setApplyDefaultValue( 0 ).
+    setInputFlag( InputFlags::OPTIONAL ).
+    setDescription( "If this flag is equal to 1, the scalar fields of the same type defined on the same cells are written "
+                    "in a single (cells x fields) dataset with one collective write. Each field is still exposed as its own property." );
+
+  registerWrapper( viewKeysStruct::temporalReductions, &m_temporalReductions ).
+    setInputFlag( InputFlags::OPTIONAL ).
+    setDescription( "Temporal reductions (among `min`, `max` and `mean`) accumulated in place at each execution of this output. "
+                    "If this attribute is specified, only the reduced values are written, as `<field>_<reduction>` properties." );
+
+  registerWrapper( viewKeysStruct::dumpFrequency, &m_dumpFrequency ).
+    setApplyDefaultValue( 1 ).
+    setInputFlag( InputFlags::OPTIONAL ).
+    setDescription( "Number of executions of this output between two dumps. "
+                    "Temporal reductions are accumulated at every execution and reset after each dump." );
+
+  registerWrapper( viewKeysStruct::summaryFieldNames, &m_summaryFieldNames ).
+    setInputFlag( InputFlags::OPTIONAL ).
+    setDescription( "Names of the scalar fields aggregated over each Region of the RESQMLMesh at every execution of this output. "
+                    "Their volume-weighted totals and means are appended at every execution to one time-series property of the regions per field and statistic." );
+
+  registerWrapper( viewKeysStruct::summaryWeightFieldName, &m_summaryWeightFieldName ).
+    setInputFlag( InputFlags::OPTIONAL ).
+    setDescription( "Name of the field multiplying the cell volumes in the region summaries (e.g. a porosity to get pore-volume weighted means)." );
+
+  registerWrapper( viewKeysStruct::outputRegions, &m_outputRegions ).
+    setInputFlag( InputFlags::OPTIONAL ).
+    setDescription( "UUIDs or titles of the cell subrepresentations of the input repository restricting the output. "
+                    "If this attribute is specified, only the cells of these regions are written." );
+
+  registerWrapper( viewKeysStruct::outputBoundingBox, &m_outputBoundingBox ).
+    setInputFlag( InputFlags::OPTIONAL ).
+    setDescription( "Bounding box { xmin, ymin, zmin, xmax, ymax, zmax } restricting the output to the cells centered inside it. "
+                    "If `outputRegions` is also specified, only the cells of these regions inside the box are written." );
+
 }
 
 RESQMLOutput::~RESQMLOutput()
@@ -76,6 +153,26 @@ void RESQMLOutput::postInputInitialization()
   m_writer.setOutputLocation( getOutputDirectory(), m_plotFileName );
   m_writer.setFieldNames( m_fieldNames.toViewConst() );
   m_writer.setOnlyPlotSpecifiedFieldNamesFlag( m_onlyPlotSpecifiedFieldNames );
+  m_writer.setWriteOnParentGrid( m_writeOnParentGrid );
+  m_writer.setPackScalarFields( m_packScalarFields );
+  m_writer.setTemporalReductions( m_temporalReductions.toViewConst() );
+  m_writer.setSummaryFields( m_summaryFieldNames.toViewConst(), m_summaryWeightFieldName );
+  m_writer.setOutputBoundingBox( m_outputBoundingBox.toViewConst() );
+
+  for( string const & reduction : m_temporalReductions )
+  {
+    GEOS_THROW_IF( reduction != "min" && reduction != "max" && reduction != "mean",
+                   GEOS_FMT( "{}: unknown temporal reduction '{}', expected min, max or mean", getName(), reduction ),
+                   InputError );
+  }
+
+  GEOS_THROW_IF( !m_outputBoundingBox.empty() && m_outputBoundingBox.size() != 6,
+                 GEOS_FMT( "{}: {} must contain 6 values {{ xmin, ymin, zmin, xmax, ymax, zmax }}", getName(), viewKeysStruct::outputBoundingBox ),
+                 InputError );
+
+  GEOS_THROW_IF_LE_MSG( m_dumpFrequency, 0,
+                        GEOS_FMT( "{}: {} must be positive", getName(), viewKeysStruct::dumpFrequency ),
+                        InputError );
 
 //SupportingRepresentation
 
@@ -118,23 +215,72 @@ bool RESQMLOutput::execute( real64 const time_n,
 {
   if( cycleNumber == 0 )
   {
+    // The regions are resolved once the repository of the mesh is loaded
+    MeshManager & meshManager = this->getGroupByPath< MeshManager >( "/Problem/Mesh" );
+    RESQMLMeshGenerator const & resqmlMeshGenerator = meshManager.getGroup< RESQMLMeshGenerator >( m_referenceObjectName );
+
+    if( m_writeOnParentGrid )
+    {
+      m_writer.setParentCellCount( resqmlMeshGenerator.getCellCount() );
+    }
+
+    if( !m_summaryFieldNames.empty() )
+    {
+      m_writer.setSummaryRegions( resqmlMeshGenerator.getRegionSubRepresentations() );
+    }
+
+    std::vector< RESQML2_NS::SubRepresentation * > outputRegions;
+    for( string const & outputRegion : m_outputRegions )
+    {
+      outputRegions.push_back( isUuid( outputRegion )
+                               ? resqmlMeshGenerator.findSubRepresentation( outputRegion, "", gsoap_eml2_3::eml23__IndexableElement::cells )
+                               : resqmlMeshGenerator.findSubRepresentation( "", outputRegion, gsoap_eml2_3::eml23__IndexableElement::cells ) );
+    }
+    m_writer.setOutputRegions( outputRegions );
+
     m_writer.generateSubRepresentations( domain );
   }
 
-  // if( cycleNumber == 0 )
-  // {
-  m_writer.write( time_n, cycleNumber, domain );
-  // }
+  if( !m_summaryFieldNames.empty() )
+  {
+    m_writer.writeSummary( time_n, domain );
+  }
+
+  if( !m_temporalReductions.empty() )
+  {
+    m_writer.accumulateReductions( domain );
+  }
+
+  ++m_executionCount;
+  if( m_executionCount % m_dumpFrequency == 0 )
+  {
+    if( m_temporalReductions.empty() )
+    {
+      m_writer.write( time_n, cycleNumber, domain );
+    }
+    else
+    {
+      m_writer.writeReductions( time_n, cycleNumber, domain );
+    }
+  }
 
   return false;
 }
 
-void RESQMLOutput::cleanup( real64 const GEOS_UNUSED_PARAM( time_n ),
-                            integer const GEOS_UNUSED_PARAM( cycleNumber ),
+void RESQMLOutput::cleanup( real64 const time_n,
+                            integer const cycleNumber,
                             integer const GEOS_UNUSED_PARAM( eventCounter ),
                             real64 const GEOS_UNUSED_PARAM( eventProgress ),
-                            DomainPartition & GEOS_UNUSED_PARAM( domain ) )
+                            DomainPartition & domain )
 {
+  // The executions since the last dump make a last, partial reduction window
+  if( !m_temporalReductions.empty() && m_executionCount % m_dumpFrequency != 0 )
+  {
+    m_writer.writeReductions( time_n, cycleNumber, domain );
+  }
+
+  m_writer.writePackedFieldDatasets();
+
   if( MpiWrapper::commRank( ) == 0 )
   {
     m_writer.generateOutput();
@@ -82,6 +82,14 @@ public:
     static constexpr auto onlyPlotSpecifiedFieldNames = "onlyPlotSpecifiedFieldNames";
     static constexpr auto fieldNames = "fieldNames";
     static constexpr auto inputRepositoryName = "inputRepositoryName";
+    static constexpr auto writeOnParentGrid = "writeOnParentGrid";
+    static constexpr auto packScalarFields = "packScalarFields";
+    static constexpr auto temporalReductions = "temporalReductions";
+    static constexpr auto dumpFrequency = "dumpFrequency";
+    static constexpr auto summaryFieldNames = "summaryFieldNames";
+    static constexpr auto summaryWeightFieldName = "summaryWeightFieldName";
+    static constexpr auto outputRegions = "outputRegions";
+    static constexpr auto outputBoundingBox = "outputBoundingBox";
   } RESQMLOutputViewKeys;
   /// @endcond
 
@@ -108,6 +116,33 @@ private:
   // Name of the parent grid
   string m_parentMeshName;
 
+  /// flag to write the properties on the parent grid, in its global cell order
+  integer m_writeOnParentGrid;
+
+  /// flag to pack the same-typed scalar fields sharing a support into a single dataset
+  integer m_packScalarFields;
+
+  /// temporal reductions dumped instead of the raw values
+  array1d< string > m_temporalReductions;
+
+  /// number of executions between two dumps
+  integer m_dumpFrequency;
+
+  /// number of executions since the beginning of the simulation
+  integer m_executionCount;
+
+  /// array of names of the fields aggregated over the regions of the mesh
+  array1d< string > m_summaryFieldNames;
+
+  /// name of the field weighting the cell volumes in the region summaries
+  string m_summaryWeightFieldName;
+
+  /// UUIDs or titles of the cell subrepresentations restricting the output
+  array1d< string > m_outputRegions;
+
+  /// bounding box (xmin, ymin, zmin, xmax, ymax, zmax) restricting the output
+  array1d< real64 > m_outputBoundingBox;
+
   RESQMLWriterInterface m_writer;
 };
 
@@ -17,16 +17,23 @@
  */
 
 #include "RESQMLUtilities.hpp"
+#include "RESQMLHdf5Utilities.hpp"
 
 #include "common/logger/Logger.hpp"
 #include "common/format/Format.hpp"
+#include "common/GEOS_RAJA_Interface.hpp"
 
 #include <vtkNew.h>
 #include <vtkSmartPointer.h>
 #include <vtkIdList.h>
 #include <vtkCellData.h>
+#include <vtkPointData.h>
 #include <vtkDoubleArray.h>
 #include <vtkIntArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkShortArray.h>
+#include <vtkSignedCharArray.h>
+#include <vtkCellArray.h>
 
 
 #include "fesapi/eml2/AbstractLocal3dCrs.h"
@@ -36,15 +43,22 @@
 #include "fesapi/resqml2/SubRepresentation.h"
 
 
+#include <algorithm>
 #include <array>
+#include <bitset>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <type_traits>
+#include <vector>
 
 namespace geos
 {
 
 //----------------------------------------------------------------------------
+template< typename GRID >
 void cellVtkTetra( vtkSmartPointer< vtkUnstructuredGrid > vtk_unstructuredGrid,
-                   const RESQML2_NS::UnstructuredGridRepresentation *unstructuredGridRep,
-                   ULONG64 const *cumulativeFaceCountPerCell,
+                   const GRID *unstructuredGridRep,
                    unsigned char const *cellFaceNormalOutwardlyDirected,
                    ULONG64 cellIndex )
 {
@@ -52,10 +66,7 @@ void cellVtkTetra( vtkSmartPointer< vtkUnstructuredGrid > vtk_unstructuredGrid,
 
   // Face 0
   ULONG64 const *nodeIndices = unstructuredGridRep->getNodeIndicesOfFaceOfCell( cellIndex, 0 );
-  size_t cellFaceIndex = unstructuredGridRep->isFaceCountOfCellsConstant() || cellIndex == 0
-                 ? cellIndex * 4
-                 : cumulativeFaceCountPerCell[cellIndex - 1];
-  if( cellFaceNormalOutwardlyDirected[cellFaceIndex] == 0 )
+  if( cellFaceNormalOutwardlyDirected[0] == 0 )
   { // The RESQML orientation of face 0 honors the VTK orientation of face 0 i.e. the face 0 normal defined using a right hand rule is
     // inwardly directed.
     nodes[0] = nodeIndices[0];
@@ -90,16 +101,12 @@ void cellVtkTetra( vtkSmartPointer< vtkUnstructuredGrid > vtk_unstructuredGrid,
 }
 
 //----------------------------------------------------------------------------
+template< typename GRID >
 void cellVtkWedgeOrPyramid( vtkSmartPointer< vtkUnstructuredGrid > vtk_unstructuredGrid,
-                            const RESQML2_NS::UnstructuredGridRepresentation *unstructuredGridRep,
-                            ULONG64 const *cumulativeFaceCountPerCell, unsigned char const *cellFaceNormalOutwardlyDirected,
+                            const GRID *unstructuredGridRep,
+                            unsigned char const *cellFaceNormalOutwardlyDirected,
                             ULONG64 cellIndex )
 {
-  // The global index of the first face of the polyhedron in the cellFaceNormalOutwardlyDirected array
-  const size_t globalFirstFaceIndex = unstructuredGridRep->isFaceCountOfCellsConstant() || cellIndex == 0
-    ? cellIndex * 5
-    : cumulativeFaceCountPerCell[cellIndex - 1];
-
   std::vector< unsigned int > localFaceIndexWith4Nodes;
   for( unsigned int localFaceIndex = 0; localFaceIndex < 5; ++localFaceIndex )
   {
@@ -119,7 +126,7 @@ void cellVtkWedgeOrPyramid( vtkSmartPointer< vtkUnstructuredGrid > vtk_unstructu
       if( localNodeCount == 3 )
       {
         uint64_t const *nodeIndices = unstructuredGridRep->getNodeIndicesOfFaceOfCell( cellIndex, triangleIndex );
-        if( cellFaceNormalOutwardlyDirected[globalFirstFaceIndex + triangleIndex] == 0 )
+        if( cellFaceNormalOutwardlyDirected[triangleIndex] == 0 )
         {
           for( size_t i = 0; i < 3; ++i )
           {
@@ -181,7 +188,7 @@ void cellVtkWedgeOrPyramid( vtkSmartPointer< vtkUnstructuredGrid > vtk_unstructu
         uint64_t const *nodeIndices = unstructuredGridRep->getNodeIndicesOfFaceOfCell( cellIndex, triangleIndex );
         if( nodeIndices[0] == nodes[3] )
         {
-          if( cellFaceNormalOutwardlyDirected[globalFirstFaceIndex + triangleIndex] == 0 )
+          if( cellFaceNormalOutwardlyDirected[triangleIndex] == 0 )
           {
             nodes[4] = nodeIndices[1];
             nodes[5] = nodeIndices[2];
@@ -194,7 +201,7 @@ void cellVtkWedgeOrPyramid( vtkSmartPointer< vtkUnstructuredGrid > vtk_unstructu
         }
         else if( nodeIndices[1] == nodes[3] )
         {
-          if( cellFaceNormalOutwardlyDirected[globalFirstFaceIndex + triangleIndex] == 0 )
+          if( cellFaceNormalOutwardlyDirected[triangleIndex] == 0 )
           {
             nodes[4] = nodeIndices[2];
             nodes[5] = nodeIndices[0];
@@ -207,7 +214,7 @@ void cellVtkWedgeOrPyramid( vtkSmartPointer< vtkUnstructuredGrid > vtk_unstructu
         }
         else if( nodeIndices[2] == nodes[3] )
         {
-          if( cellFaceNormalOutwardlyDirected[globalFirstFaceIndex + triangleIndex] == 0 )
+          if( cellFaceNormalOutwardlyDirected[triangleIndex] == 0 )
           {
             nodes[4] = nodeIndices[0];
             nodes[5] = nodeIndices[1];
@@ -234,11 +241,7 @@ void cellVtkWedgeOrPyramid( vtkSmartPointer< vtkUnstructuredGrid > vtk_unstructu
     ULONG64 nodes[5];
 
     ULONG64 const *nodeIndices = unstructuredGridRep->getNodeIndicesOfFaceOfCell( cellIndex, localFaceIndexWith4Nodes[0] );
-    size_t cellFaceIndex = (unstructuredGridRep->isFaceCountOfCellsConstant() || cellIndex == 0
-      ? cellIndex * 5
-      : cumulativeFaceCountPerCell[cellIndex - 1]) +
-                           localFaceIndexWith4Nodes[0];
-    if( cellFaceNormalOutwardlyDirected[cellFaceIndex] == 0 )
+    if( cellFaceNormalOutwardlyDirected[localFaceIndexWith4Nodes[0]] == 0 )
     { // The RESQML orientation of the face honors the VTK orientation of face 0 i.e. the face 0 normal defined using a right hand rule is
       // inwardly directed.
       nodes[0] = nodeIndices[0];
@@ -280,9 +283,9 @@ void cellVtkWedgeOrPyramid( vtkSmartPointer< vtkUnstructuredGrid > vtk_unstructu
 }
 
 //----------------------------------------------------------------------------
+template< typename GRID >
 bool cellVtkHexahedron( vtkSmartPointer< vtkUnstructuredGrid > vtk_unstructuredGrid,
-                        const RESQML2_NS::UnstructuredGridRepresentation *unstructuredGridRep,
-                        ULONG64 const *cumulativeFaceCountPerCell,
+                        const GRID *unstructuredGridRep,
                         unsigned char const *cellFaceNormalOutwardlyDirected,
                         ULONG64 cellIndex )
 {
@@ -297,10 +300,7 @@ bool cellVtkHexahedron( vtkSmartPointer< vtkUnstructuredGrid > vtk_unstructuredG
   ULONG64 nodes[8];
 
   ULONG64 const *nodeIndices = unstructuredGridRep->getNodeIndicesOfFaceOfCell( cellIndex, 0 );
-  const size_t cellFaceIndex = unstructuredGridRep->isFaceCountOfCellsConstant() || cellIndex == 0
-                   ? cellIndex * 6
-                   : cumulativeFaceCountPerCell[cellIndex - 1];
-  if( cellFaceNormalOutwardlyDirected[cellFaceIndex] == 0 )
+  if( cellFaceNormalOutwardlyDirected[0] == 0 )
   { // The RESQML orientation of the face honors the VTK orientation of face 0 i.e. the face 0 normal defined using a right hand rule is
     // inwardly directed.
     nodes[0] = nodeIndices[0];
@@ -357,8 +357,9 @@ bool cellVtkHexahedron( vtkSmartPointer< vtkUnstructuredGrid > vtk_unstructuredG
 }
 
 //----------------------------------------------------------------------------
+template< typename GRID >
 bool cellVtkPentagonalPrism( vtkSmartPointer< vtkUnstructuredGrid > vtk_unstructuredGrid,
-                             const RESQML2_NS::UnstructuredGridRepresentation *unstructuredGridRep,
+                             const GRID *unstructuredGridRep,
                              ULONG64 cellIndex )
 {
   unsigned int faceTo5Nodes = 0;
@@ -390,8 +391,9 @@ bool cellVtkPentagonalPrism( vtkSmartPointer< vtkUnstructuredGrid > vtk_unstruct
 }
 
 //----------------------------------------------------------------------------
+template< typename GRID >
 bool cellVtkHexagonalPrism( vtkSmartPointer< vtkUnstructuredGrid > vtk_unstructuredGrid,
-                            const RESQML2_NS::UnstructuredGridRepresentation *unstructuredGridRep,
+                            const GRID *unstructuredGridRep,
                             ULONG64 cellIndex )
 {
   unsigned int faceTo6Nodes = 0;
@@ -422,123 +424,526 @@ bool cellVtkHexagonalPrism( vtkSmartPointer< vtkUnstructuredGrid > vtk_unstructu
   return false;
 }
 
+//----------------------------------------------------------------------------
+template< typename GRID >
+void insertCell( vtkSmartPointer< vtkUnstructuredGrid > vtk_unstructuredGrid,
+                 const GRID *unstructuredGridRep,
+                 unsigned char const *cellFaceNormalOutwardlyDirected,
+                 ULONG64 cellIndex )
+{
+  bool isOptimizedCell = false;
+
+  const ULONG64 localFaceCount = unstructuredGridRep->getFaceCountOfCell( cellIndex );
+
+  if( localFaceCount == 4 )
+  { // VTK_TETRA
+    cellVtkTetra( vtk_unstructuredGrid, unstructuredGridRep, cellFaceNormalOutwardlyDirected, cellIndex );
+    isOptimizedCell = true;
+  }
+  else if( localFaceCount == 5 )
+  { // VTK_WEDGE or VTK_PYRAMID
+    cellVtkWedgeOrPyramid( vtk_unstructuredGrid, unstructuredGridRep, cellFaceNormalOutwardlyDirected, cellIndex );
+    isOptimizedCell = true;
+  }
+  else if( localFaceCount == 6 )
+  { // VTK_HEXAHEDRON
+    isOptimizedCell = cellVtkHexahedron( vtk_unstructuredGrid, unstructuredGridRep, cellFaceNormalOutwardlyDirected, cellIndex );
+  }
+  else if( localFaceCount == 7 )
+  { // VTK_PENTAGONAL_PRISM
+    isOptimizedCell = cellVtkPentagonalPrism( vtk_unstructuredGrid, unstructuredGridRep, cellIndex );
+  }
+  else if( localFaceCount == 8 )
+  { // VTK_HEXAGONAL_PRISM
+    isOptimizedCell = cellVtkHexagonalPrism( vtk_unstructuredGrid, unstructuredGridRep, cellIndex );
+  }
+
+  if( !isOptimizedCell )
+  {
+    vtkNew< vtkIdList > idList;
+
+    // For polyhedron cell, a special ptIds input format is required : (numCellFaces, numFace0Pts, id1, id2, id3, numFace1Pts, id1, id2,
+    // id3, ...)
+    idList->InsertNextId( localFaceCount );
+    for( ULONG64 localFaceIndex = 0; localFaceIndex < localFaceCount; ++localFaceIndex )
+    {
+      const unsigned int localNodeCount = unstructuredGridRep->getNodeCountOfFaceOfCell( cellIndex, localFaceIndex );
+      idList->InsertNextId( localNodeCount );
+      ULONG64 const *nodeIndices = unstructuredGridRep->getNodeIndicesOfFaceOfCell( cellIndex, localFaceIndex );
+      for( unsigned int i = 0; i < localNodeCount; ++i )
+      {
+        idList->InsertNextId( nodeIndices[i] );
+      }
+    }
+
+    vtk_unstructuredGrid->InsertNextCell( VTK_POLYHEDRON, idList );
+  }
+}
 
-int readContinuousProperty( RESQML2_NS::AbstractValuesProperty * valuesProperty, string name, vtkCellData * outDS )
+/**
+ * @brief Reader of the topology datasets of an unstructured grid
+ */
+class UnstructuredGridTopologyReader
 {
-  const unsigned int elementCountPerValue = valuesProperty->getElementCountPerValue();
-  const unsigned int totalHDFElementcount = valuesProperty->getValuesCountOfPatch( 0 );
+public:
+
+  /**
+   * @brief Open the topology datasets
+   * @param topology the location of the datasets
+   */
+  explicit UnstructuredGridTopologyReader( Hdf5GridTopology const & topology ):
+    m_topology( topology ),
+    m_facesPerCell( topology.facesPerCell ),
+    m_nodesPerFace( topology.nodesPerFace ),
+    m_cellFaceIsRightHanded( topology.cellFaceIsRightHanded ),
+    m_cumulativeFaceCountPerCell( topology.cumulativeFaceCountPerCell.location.datasetPath.empty()
+                                  ? nullptr
+                                  : std::make_unique< Hdf5RangeReader >( topology.cumulativeFaceCountPerCell.location )),
+    m_cumulativeNodeCountPerFace( topology.cumulativeNodeCountPerFace.location.datasetPath.empty()
+                                  ? nullptr
+                                  : std::make_unique< Hdf5RangeReader >( topology.cumulativeNodeCountPerFace.location ))
+  {}
+
+  /**
+   * @brief Read the offsets of the faces of a range of cells in the faces per cell
+   * @param firstCell the first cell of the range
+   * @param cellCount the number of cells of the range
+   * @param offsets the cellCount + 1 offsets of the faces, starting with the one of the first cell
+   */
+  void readFaceOffsets( ULONG64 firstCell, ULONG64 cellCount, std::vector< ULONG64 > & offsets ) const
+  {
+    readOffsets( m_cumulativeFaceCountPerCell.get(), m_topology.cumulativeFaceCountPerCell, firstCell, cellCount, offsets );
+  }
 
-  double * valueIndices = new double[totalHDFElementcount]; // deleted by VTK cellData vtkSmartPointer
+  /**
+   * @brief Read the offsets of the nodes of a range of faces in the nodes per face
+   * @param firstFace the first face of the range
+   * @param faceCount the number of faces of the range
+   * @param offsets the faceCount + 1 offsets of the nodes, starting with the one of the first face
+   */
+  void readNodeOffsets( ULONG64 firstFace, ULONG64 faceCount, std::vector< ULONG64 > & offsets ) const
+  {
+    readOffsets( m_cumulativeNodeCountPerFace.get(), m_topology.cumulativeNodeCountPerFace, firstFace, faceCount, offsets );
+  }
 
-  valuesProperty->getDoubleValuesOfPatch( 0, valueIndices );
+  /// @return the reader of the face indices of the cells
+  Hdf5RangeReader const & facesPerCell() const { return m_facesPerCell; }
 
-  //TODO find a better way to handle NaN data
-  for( unsigned int x = 0; x < totalHDFElementcount; ++x )
+  /// @return the reader of the node indices of the faces
+  Hdf5RangeReader const & nodesPerFace() const { return m_nodesPerFace; }
+
+  /// @return the reader of the right handedness of the faces of the cells
+  Hdf5RangeReader const & cellFaceIsRightHanded() const { return m_cellFaceIsRightHanded; }
+
+private:
+
+  /**
+   * @brief Read a range of a jagged array offsets from its cumulative lengths
+   * @param reader the reader of the cumulative lengths, nullptr for a lattice
+   * @param lengths the location of the cumulative lengths
+   * @param first the first element of the range
+   * @param count the number of elements of the range
+   * @param offsets the count + 1 offsets
+   */
+  static void readOffsets( Hdf5RangeReader const * reader, Hdf5CumulativeLengths const & lengths,
+                           ULONG64 first, ULONG64 count, std::vector< ULONG64 > & offsets )
   {
-    if( std::isnan( valueIndices[x] ))
+    offsets.assign( count + 1, 0 );
+    if( reader == nullptr )
+    {
+      for( ULONG64 i = 0; i <= count; ++i )
+      {
+        offsets[i] = first + i == 0 ? 0 : lengths.start + lengths.step * ( first + i - 1 );
+      }
+    }
+    else if( first == 0 )
+    {
+      reader->read( H5T_NATIVE_ULLONG, 0, count, offsets.data() + 1 );
+    }
+    else
     {
-      valueIndices[x] = 0.00000001;
+      reader->read( H5T_NATIVE_ULLONG, first - 1, count + 1, offsets.data() );
     }
   }
 
-  vtkNew< vtkDoubleArray > cellData;
-  cellData->SetArray( valueIndices, totalHDFElementcount, 0, vtkAbstractArray::VTK_DATA_ARRAY_DELETE );
-  cellData->SetName( name.c_str());
-  cellData->SetNumberOfComponents( elementCountPerValue );
+  Hdf5GridTopology const & m_topology;
+  Hdf5RangeReader m_facesPerCell;
+  Hdf5RangeReader m_nodesPerFace;
+  Hdf5RangeReader m_cellFaceIsRightHanded;
+  std::unique_ptr< Hdf5RangeReader > m_cumulativeFaceCountPerCell;
+  std::unique_ptr< Hdf5RangeReader > m_cumulativeNodeCountPerFace;
+};
+
+/**
+ * @brief Topology of a range of cells of an unstructured grid
+ * @details Provides the accessors of UnstructuredGridRepresentation used by the cell builders, for the cells of the range.
+ * The node indices are read for all the faces between the lowest and the highest face of the range,
+ * which stays small when the faces are numbered along the cells.
+ */
+class UnstructuredGridChunk
+{
+public:
+
+  /**
+   * @brief Read the topology of a range of cells
+   * @param reader the reader of the topology datasets
+   * @param firstCell the first cell of the range
+   * @param cellCount the number of cells of the range
+   * @param flipRightHandedness true to flip the right handedness of the faces, for depth oriented grids
+   */
+  UnstructuredGridChunk( UnstructuredGridTopologyReader const & reader, ULONG64 firstCell, ULONG64 cellCount, bool flipRightHandedness ):
+    m_firstCell( firstCell ),
+    m_firstFace( 0 )
+  {
+    reader.readFaceOffsets( firstCell, cellCount, m_faceOffsets );
+    ULONG64 const firstFaceOffset = m_faceOffsets.front();
+    ULONG64 const faceOffsetCount = m_faceOffsets.back() - firstFaceOffset;
+    for( ULONG64 & offset : m_faceOffsets )
+    {
+      offset -= firstFaceOffset;
+    }
 
-  outDS->AddArray( cellData );
+    m_faceIndices.resize( faceOffsetCount );
+    reader.facesPerCell().read( H5T_NATIVE_ULLONG, firstFaceOffset, faceOffsetCount, m_faceIndices.data() );
+    m_cellFaceIsRightHanded.resize( faceOffsetCount );
+    reader.cellFaceIsRightHanded().read( H5T_NATIVE_UCHAR, firstFaceOffset, faceOffsetCount, m_cellFaceIsRightHanded.data() );
+    if( flipRightHandedness )
+    {
+      for( unsigned char & isRightHanded : m_cellFaceIsRightHanded )
+      {
+        isRightHanded = !isRightHanded;
+      }
+    }
 
-  return 1;
-}
+    if( m_faceIndices.empty() )
+    {
+      m_nodeOffsets.assign( 1, 0 );
+      return;
+    }
+
+    auto const faceRange = std::minmax_element( m_faceIndices.begin(), m_faceIndices.end() );
+    m_firstFace = *faceRange.first;
+    reader.readNodeOffsets( m_firstFace, *faceRange.second - m_firstFace + 1, m_nodeOffsets );
+    ULONG64 const firstNodeOffset = m_nodeOffsets.front();
+    for( ULONG64 & offset : m_nodeOffsets )
+    {
+      offset -= firstNodeOffset;
+    }
+
+    m_nodeIndices.resize( m_nodeOffsets.back() );
+    reader.nodesPerFace().read( H5T_NATIVE_ULLONG, firstNodeOffset, m_nodeIndices.size(), m_nodeIndices.data() );
+  }
+
+  /**
+   * @param cellIndex the global index of a cell of the range
+   * @return the number of faces of the cell
+   */
+  ULONG64 getFaceCountOfCell( ULONG64 cellIndex ) const
+  {
+    ULONG64 const localCellIndex = cellIndex - m_firstCell;
+    return m_faceOffsets[localCellIndex + 1] - m_faceOffsets[localCellIndex];
+  }
+
+  /**
+   * @param cellIndex the global index of a cell of the range
+   * @param localFaceIndex the index of a face in the cell
+   * @return the number of nodes of the face
+   */
+  unsigned int getNodeCountOfFaceOfCell( ULONG64 cellIndex, ULONG64 localFaceIndex ) const
+  {
+    ULONG64 const face = localFace( cellIndex, localFaceIndex );
+    return LvArray::integerConversion< unsigned int >( m_nodeOffsets[face + 1] - m_nodeOffsets[face] );
+  }
+
+  /**
+   * @param cellIndex the global index of a cell of the range
+   * @param localFaceIndex the index of a face in the cell
+   * @return the global node indices of the face
+   */
+  ULONG64 const * getNodeIndicesOfFaceOfCell( ULONG64 cellIndex, ULONG64 localFaceIndex ) const
+  {
+    return m_nodeIndices.data() + m_nodeOffsets[localFace( cellIndex, localFaceIndex )];
+  }
+
+  /**
+   * @param cellIndex the global index of a cell of the range
+   * @return the right handedness of the faces of the cell
+   */
+  unsigned char const * getCellFaceIsRightHanded( ULONG64 cellIndex ) const
+  {
+    return m_cellFaceIsRightHanded.data() + m_faceOffsets[cellIndex - m_firstCell];
+  }
+
+private:
+
+  ULONG64 localFace( ULONG64 cellIndex, ULONG64 localFaceIndex ) const
+  {
+    return m_faceIndices[m_faceOffsets[cellIndex - m_firstCell] + localFaceIndex] - m_firstFace;
+  }
+
+  ULONG64 m_firstCell;
+  ULONG64 m_firstFace;
+  std::vector< ULONG64 > m_faceOffsets;
+  std::vector< ULONG64 > m_faceIndices;
+  std::vector< unsigned char > m_cellFaceIsRightHanded;
+  std::vector< ULONG64 > m_nodeOffsets;
+  std::vector< ULONG64 > m_nodeIndices;
+};
 
-int readDiscreteOrCategoricalProperty( RESQML2_NS::AbstractValuesProperty * valuesProperty, string name, vtkCellData * outDS )
+
+/**
+ * @brief Read the values of the first patch of a property in a VTK array
+ * @tparam ARRAY_TYPE the type of the VTK array
+ * @tparam READ_VALUES the type of the function reading the values with fesapi
+ * @param valuesProperty the property
+ * @param name the name of the array
+ * @param nativeType the HDF5 native type of the values
+ * @param readValues the function reading the values of the patch with fesapi in a buffer
+ * @return the array of the values
+ * @details Contiguous uncompressed values are mapped from the file, compressed values are decompressed in parallel,
+ * and the other values are read by fesapi.
+ */
+template< typename ARRAY_TYPE, typename READ_VALUES >
+static vtkSmartPointer< ARRAY_TYPE > readPropertyValues( RESQML2_NS::AbstractValuesProperty * valuesProperty,
+                                                        string const & name,
+                                                        hid_t const nativeType,
+                                                        READ_VALUES && readValues )
 {
+  using T = typename ARRAY_TYPE::ValueType;
+
+  std::unique_lock< std::recursive_mutex > lock( hdf5Mutex() );
   const unsigned int elementCountPerValue = valuesProperty->getElementCountPerValue();
   const unsigned int totalHDFElementcount = valuesProperty->getValuesCountOfPatch( 0 );
+  lock.unlock();
+
+  // Contiguous uncompressed values are mapped from the file instead of being copied
+  Hdf5DatasetLocation location;
+  hsize_t mappedCount = 0;
+  bool const isLocated = locatePropertyValues( valuesProperty, location );
+  T * values = isLocated
+               ? static_cast< T * >( mapHdf5Dataset( location, nativeType, mappedCount ))
+               : nullptr;
+  bool const isMapped = values != nullptr && mappedCount == totalHDFElementcount;
+  if( values != nullptr && !isMapped )
+  {
+    unmapHdf5Dataset( values );
+  }
 
-  int * valueIndices = new int[totalHDFElementcount]; // deleted by VTK cellData vtkSmartPointer
-
-  valuesProperty->getInt32ValuesOfPatch( 0, valueIndices );
+  if( !isMapped )
+  {
+    values = new T[totalHDFElementcount]; // deleted by VTK cellData vtkSmartPointer
 
-  //TODO handle NaN ?
+    // Compressed values are decompressed in parallel
+    if( !isLocated || !readDeflatedHdf5Dataset( location, nativeType, values, totalHDFElementcount ))
+    {
+      lock.lock();
+      readValues( values );
+      lock.unlock();
+    }
+  }
 
-  vtkNew< vtkIntArray > cellData;
-  cellData->SetArray( valueIndices, totalHDFElementcount, 0, vtkAbstractArray::VTK_DATA_ARRAY_DELETE );
+  auto cellData = vtkSmartPointer< ARRAY_TYPE >::New();
+  if( isMapped )
+  {
+    cellData->SetArray( values, totalHDFElementcount, 0, vtkAbstractArray::VTK_DATA_ARRAY_USER_DEFINED );
+    cellData->SetArrayFreeFunction( unmapHdf5Dataset );
+  }
+  else
+  {
+    cellData->SetArray( values, totalHDFElementcount, 0, vtkAbstractArray::VTK_DATA_ARRAY_DELETE );
+  }
   cellData->SetName( name.c_str());
   cellData->SetNumberOfComponents( elementCountPerValue );
 
-  outDS->AddArray( cellData );
+  return cellData;
+}
+
+static vtkSmartPointer< vtkDataArray > readContinuousProperty( RESQML2_NS::AbstractValuesProperty * valuesProperty, string name )
+{
+  vtkSmartPointer< vtkDoubleArray > cellData =
+    readPropertyValues< vtkDoubleArray >( valuesProperty, name, H5T_NATIVE_DOUBLE,
+                                          [valuesProperty]( double * values ) { valuesProperty->getDoubleValuesOfPatch( 0, values ); } );
+
+  //TODO find a better way to handle NaN data
+  double * const values = cellData->GetPointer( 0 );
+  vtkIdType const valueCount = cellData->GetNumberOfValues();
+  for( vtkIdType x = 0; x < valueCount; ++x )
+  {
+    if( std::isnan( values[x] ))
+    {
+      values[x] = 0.00000001;
+    }
+  }
+
+  return cellData;
+}
 
-  return 1;
+static vtkSmartPointer< vtkDataArray > readDiscreteOrCategoricalProperty( RESQML2_NS::AbstractValuesProperty * valuesProperty, string name )
+{
+  //TODO handle NaN ?
+  return readPropertyValues< vtkIntArray >( valuesProperty, name, H5T_NATIVE_INT,
+                                            [valuesProperty]( int * values ) { valuesProperty->getInt32ValuesOfPatch( 0, values ); } );
 }
 
 
-vtkSmartPointer< vtkDataSet >
-loadGridRepresentation( COMMON_NS::AbstractObject *rep )
+/**
+ * @brief Get the name of the cells having a given number of faces
+ * @param faceCount the number of faces of the cells
+ * @return the name of the cells, as loaded in VTK
+ */
+static string cellShapeOfFaceCount( uint64_t const faceCount )
+{
+  switch( faceCount )
+  {
+    case 4: return "tetrahedra";
+    case 5: return "wedges or pyramids";
+    case 6: return "hexahedra";
+    case 7: return "pentagonal prisms";
+    case 8: return "hexagonal prisms";
+    default: return "polyhedra";
+  }
+}
+
+/**
+ * @brief Get the number of nodes of the cells having a given shape
+ * @param cellShape the name of the cells, as loaded in VTK
+ * @return the number of nodes, or an estimate of the size of the face stream for polyhedra
+ */
+static globalIndex nodeCountOfCellShape( string const & cellShape )
 {
+  if( cellShape == "tetrahedra" ) return 4;
+  if( cellShape == "wedges or pyramids" ) return 6;
+  if( cellShape == "hexahedra" ) return 8;
+  if( cellShape == "pentagonal prisms" ) return 10;
+  if( cellShape == "hexagonal prisms" ) return 12;
+  return 1 + 6 * 5;
+}
+
+GridProbe
+probeGridRepresentation( COMMON_NS::AbstractObject *rep )
+{
+  GridProbe probe;
+
   if( rep->getXmlTag() == RESQML2_NS::UnstructuredGridRepresentation::XML_TAG )
   {
-    return loadUnstructuredGridRepresentation( static_cast< RESQML2_NS::UnstructuredGridRepresentation * >(rep));
+    auto * const grid = static_cast< RESQML2_NS::UnstructuredGridRepresentation * >(rep);
+    probe.cellCount = grid->getCellCount();
+    probe.nodeCount = grid->getNodeCount();
+    probe.faceCount = grid->getFaceCount();
+
+    if( grid->isFaceCountOfCellsConstant())
+    {
+      probe.cellShapes[cellShapeOfFaceCount( grid->getConstantFaceCountOfCells())] = probe.cellCount;
+    }
+    else
+    {
+      switch( grid->getCellShape())
+      {
+        case gsoap_eml2_3::resqml22__CellShape::tetrahedral: probe.cellShapes["tetrahedra"] = probe.cellCount; break;
+        case gsoap_eml2_3::resqml22__CellShape::pyramidal:
+        case gsoap_eml2_3::resqml22__CellShape::prism: probe.cellShapes["wedges or pyramids"] = probe.cellCount; break;
+        case gsoap_eml2_3::resqml22__CellShape::hexahedral: probe.cellShapes["hexahedra"] = probe.cellCount; break;
+        default: probe.cellShapes["polyhedra"] = probe.cellCount; break;
+      }
+    }
   }
   else if( rep->getXmlTag() == RESQML2_NS::AbstractIjkGridRepresentation::XML_TAG )
   {
-    return loadIjkGridRepresentation( static_cast< RESQML2_NS::AbstractIjkGridRepresentation * >(rep));
+    auto * const grid = static_cast< RESQML2_NS::AbstractIjkGridRepresentation * >(rep);
+    globalIndex const ni = grid->getICellCount();
+    globalIndex const nj = grid->getJCellCount();
+    globalIndex const nk = grid->getKCellCount();
+    probe.cellCount = grid->getCellCount();
+    probe.nodeCount = grid->getXyzPointCountOfAllPatches();
+    probe.faceCount = ( ni + 1 ) * nj * nk + ni * ( nj + 1 ) * nk + ni * nj * ( nk + 1 );
+    probe.cellShapes["hexahedra"] = probe.cellCount;
   }
 
-  return vtkSmartPointer< vtkUnstructuredGrid >::New();
+  // Points, then connectivity, offsets and types of the VTK cells
+  probe.estimatedBytes = probe.nodeCount * 3 * sizeof( double );
+  for( auto const & [cellShape, cellCount] : probe.cellShapes )
+  {
+    probe.estimatedBytes += cellCount * ( ( nodeCountOfCellShape( cellShape ) + 1 ) * sizeof( vtkIdType ) + 1 );
+  }
+
+  return probe;
 }
 
-vtkSmartPointer< vtkDataSet >
-loadIjkGridRepresentation( RESQML2_NS::AbstractIjkGridRepresentation *grid )
+globalIndex
+probePropertyBytes( RESQML2_NS::AbstractValuesProperty *valuesProperty )
 {
-  auto vtk_explicitStructuredGrid = vtkSmartPointer< vtkExplicitStructuredGrid >::New();
-
-  uint32_t iCellCount = grid->getICellCount();
-  uint32_t jCellCount = grid->getJCellCount();
-  uint32_t kCellCount = grid->getKCellCount();
-  uint64_t pointCount = grid->getXyzPointCountOfAllPatches();
-  uint32_t initKIndex = 0;
-  uint32_t maxKIndex = kCellCount;
+  Hdf5DatasetLocation location;
+  hsize_t count = 0;
+  size_t valueSize = 0;
+  if( locatePropertyValues( valuesProperty, location ) && probeHdf5Dataset( location, count, valueSize ))
+  {
+    return LvArray::integerConversion< globalIndex >( count * valueSize );
+  }
 
+  // The values are loaded as doubles or 32 bits integers
+  size_t const loadedSize = valuesProperty->getXmlTag() == RESQML2_NS::ContinuousProperty::XML_TAG ? sizeof( double ) : sizeof( int );
+  globalIndex bytes = 0;
+  for( uint64_t patch = 0; patch < valuesProperty->getPatchCount(); ++patch )
+  {
+    bytes += valuesProperty->getValuesCountOfPatch( patch ) * loadedSize;
+  }
+  return bytes;
+}
 
-  //check hyperslab capacity
-  bool isHyperslabed;
-  try
+vtkSmartPointer< vtkDataSet >
+loadGridRepresentation( COMMON_NS::AbstractObject *rep, GridLoadOptions const & options )
+{
+  if( rep->getXmlTag() == RESQML2_NS::UnstructuredGridRepresentation::XML_TAG )
   {
-    const auto kInterfaceNodeCount = grid->getXyzPointCountOfKInterface();
-    std::unique_ptr< double[] > allXyzPoints( new double[kInterfaceNodeCount * 3] );
-    grid->getXyzPointsOfKInterface( 0, allXyzPoints.get());
-    isHyperslabed = true;
+    return loadUnstructuredGridRepresentation( static_cast< RESQML2_NS::UnstructuredGridRepresentation * >(rep), options );
   }
-  catch( const std::exception & )
+  else if( rep->getXmlTag() == RESQML2_NS::AbstractIjkGridRepresentation::XML_TAG )
   {
-    isHyperslabed = false;
+    return loadIjkGridRepresentation( static_cast< RESQML2_NS::AbstractIjkGridRepresentation * >(rep), options );
   }
 
-  std::cout << "isHyperslabed :" << isHyperslabed  << std::endl;
-
-  int extent[6] = { 0, static_cast< int >(iCellCount), 0, static_cast< int >(jCellCount), static_cast< int >(initKIndex), static_cast< int >(maxKIndex) };
-  vtk_explicitStructuredGrid->SetExtent( extent );
-
-  //handle points
-  auto points = vtkSmartPointer< vtkPoints >::New();
-  points->SetNumberOfPoints( pointCount );
-  size_t point_id = 0;
-
-  std::unique_ptr< double[] > allXyzPoints( new double[pointCount * 3] );
-  grid->getXyzPointsOfAllPatchesInGlobalCrs( allXyzPoints.get());
-  const size_t coordCount = pointCount * 3;
+  return vtkSmartPointer< vtkUnstructuredGrid >::New();
+}
 
-  const double zIndice = grid->getLocalCrs( 0 )->isDepthOriented() ? -1 : 1;
-  for( uint_fast64_t pointIndex = 0; pointIndex < coordCount; pointIndex += 3 )
+/**
+ * @brief Attach the RESQML indices of the cells and the points of a loaded grid as their global ids
+ * @param dataset the loaded grid
+ * @param cellIndices the RESQML index of each cell, nullptr if it is the index of the cell
+ * @param pointIndices the RESQML index of each point, nullptr if it is the index of the point
+ */
+static void setGlobalIds( vtkDataSet & dataset, vtkIdType const * cellIndices, vtkIdType const * pointIndices )
+{
+  auto const makeGlobalIds = []( vtkIdType const count, vtkIdType const * indices )
   {
-    points->SetPoint( point_id++, allXyzPoints[pointIndex], allXyzPoints[pointIndex + 1], allXyzPoints[pointIndex + 2] * zIndice );
-  }
-  vtk_explicitStructuredGrid->SetPoints( points );
+    vtkNew< vtkIdTypeArray > globalIds;
+    globalIds->SetName( "GlobalIds" );
+    globalIds->SetNumberOfValues( count );
+    vtkIdType * const values = globalIds->GetPointer( 0 );
+    if( indices == nullptr )
+    {
+      std::iota( values, values + count, 0 );
+    }
+    else
+    {
+      std::copy_n( indices, count, values );
+    }
+    return vtkSmartPointer< vtkIdTypeArray >( globalIds.GetPointer() );
+  };
 
+  dataset.GetCellData()->SetGlobalIds( makeGlobalIds( dataset.GetNumberOfCells(), cellIndices ));
+  dataset.GetPointData()->SetGlobalIds( makeGlobalIds( dataset.GetNumberOfPoints(), pointIndices ));
+}
 
-  // Check which cells have no geometry
+vtkSmartPointer< vtkDataSet >
+loadIjkGridRepresentation( RESQML2_NS::AbstractIjkGridRepresentation *grid, GridLoadOptions const & options )
+{
+  const uint32_t iCellCount = grid->getICellCount();
+  const uint32_t jCellCount = grid->getJCellCount();
   const uint64_t cellCount = grid->getCellCount();
+  const uint64_t pointCount = grid->getXyzPointCountOfAllPatches();
+
+  // Check which cells have no geometry
+  std::unique_lock< std::recursive_mutex > lock( hdf5Mutex() );
   std::unique_ptr< bool[] > enabledCells( new bool[cellCount] );
   if( grid->hasCellGeometryIsDefinedFlags())
   {
@@ -549,52 +954,157 @@ loadIjkGridRepresentation( RESQML2_NS::AbstractIjkGridRepresentation *grid )
     std::fill_n( enabledCells.get(), cellCount, true );
   }
 
-  const uint64_t translatePoint = grid->getXyzPointCountOfKInterface() * initKIndex;
+  const vtkIdType loadedCellCount = options.compactInactiveCells
+                                    ? LvArray::integerConversion< vtkIdType >( std::count( enabledCells.get(), enabledCells.get() + cellCount, true ))
+                                    : LvArray::integerConversion< vtkIdType >( cellCount );
+
+  // The corners of the cells are written straight into the connectivity of the VTK cells.
+  // A compacted grid renumbers the points used by the cells with a geometry, in the order of the cells.
+  vtkNew< vtkIdTypeArray > connectivity;
+  connectivity->SetNumberOfValues( 8 * loadedCellCount );
+  vtkIdType * const corners = connectivity->GetPointer( 0 );
+  std::vector< vtkIdType > pointIds( options.compactInactiveCells ? pointCount : 0, -1 );
+  std::vector< vtkIdType > usedPoints;
+  vtkNew< vtkIdTypeArray > cellIndices;
+  cellIndices->SetName( resqmlCellIndexArrayName );
 
   grid->loadSplitInformation();
+  lock.unlock();
+  vtkIdType cellId = 0;
+  for( uint64_t cellIndex = 0; cellIndex < cellCount; ++cellIndex )
+  {
+    if( options.compactInactiveCells && !enabledCells[cellIndex] )
+    {
+      continue;
+    }
 
-  uint64_t cellIndex = 0;
-  vtkSmartPointer< vtkIdList > nodes = vtkSmartPointer< vtkIdList >::New();
-  nodes->SetNumberOfIds( 8 );
+    const uint32_t iCellIndex = cellIndex % iCellCount;
+    const uint32_t jCellIndex = ( cellIndex / iCellCount ) % jCellCount;
+    const uint32_t kCellIndex = cellIndex / ( uint64_t( iCellCount ) * jCellCount );
+    for( unsigned int corner = 0; corner < 8; ++corner )
+    {
+      const uint64_t pointIndex = grid->getXyzPointIndexFromCellCorner( iCellIndex, jCellIndex, kCellIndex, corner );
+      if( !options.compactInactiveCells )
+      {
+        corners[8 * cellId + corner] = LvArray::integerConversion< vtkIdType >( pointIndex );
+        continue;
+      }
+      if( pointIds[pointIndex] < 0 )
+      {
+        pointIds[pointIndex] = LvArray::integerConversion< vtkIdType >( usedPoints.size() );
+        usedPoints.push_back( LvArray::integerConversion< vtkIdType >( pointIndex ));
+      }
+      corners[8 * cellId + corner] = pointIds[pointIndex];
+    }
+    if( options.compactInactiveCells )
+    {
+      cellIndices->InsertNextValue( LvArray::integerConversion< vtkIdType >( cellIndex ));
+    }
+    ++cellId;
+  }
+  grid->unloadSplitInformation();
+  pointIds = std::vector< vtkIdType >();
 
-  for( uint_fast32_t vtkKCellIndex = initKIndex; vtkKCellIndex < maxKIndex; ++vtkKCellIndex )
+  // POINTS
+  double * allXyzPoints = new double[pointCount * 3]; // Will be deleted by VTK
+  lock.lock();
+  grid->getXyzPointsOfAllPatchesInGlobalCrs( allXyzPoints );
+  lock.unlock();
+  if( options.compactInactiveCells )
   {
-    for( uint_fast32_t vtkJCellIndex = 0; vtkJCellIndex < jCellCount; ++vtkJCellIndex )
+    // The used points are gathered in their new order, which does not follow the RESQML order
+    // once a cell uses a point of an earlier cell layer
+    std::unique_ptr< double[] > const gridXyzPoints( allXyzPoints );
+    allXyzPoints = new double[usedPoints.size() * 3]; // Will be deleted by VTK
+    for( std::size_t pointId = 0; pointId < usedPoints.size(); ++pointId )
     {
-      for( uint_fast32_t vtkICellIndex = 0; vtkICellIndex < iCellCount; ++vtkICellIndex )
-      {
-        vtkIdType cellId = vtk_explicitStructuredGrid->ComputeCellId( vtkICellIndex, vtkJCellIndex, vtkKCellIndex );
-        if( enabledCells[cellIndex++] )
-        {
-          vtkIdType * indice = vtk_explicitStructuredGrid->GetCellPoints( cellId );
-          indice[0] = grid->getXyzPointIndexFromCellCorner( vtkICellIndex, vtkJCellIndex, vtkKCellIndex, 0 ) - translatePoint;
-          indice[1] = grid->getXyzPointIndexFromCellCorner( vtkICellIndex, vtkJCellIndex, vtkKCellIndex, 1 ) - translatePoint;
-          indice[2] = grid->getXyzPointIndexFromCellCorner( vtkICellIndex, vtkJCellIndex, vtkKCellIndex, 2 ) - translatePoint;
-          indice[3] = grid->getXyzPointIndexFromCellCorner( vtkICellIndex, vtkJCellIndex, vtkKCellIndex, 3 ) - translatePoint;
-          indice[4] = grid->getXyzPointIndexFromCellCorner( vtkICellIndex, vtkJCellIndex, vtkKCellIndex, 4 ) - translatePoint;
-          indice[5] = grid->getXyzPointIndexFromCellCorner( vtkICellIndex, vtkJCellIndex, vtkKCellIndex, 5 ) - translatePoint;
-          indice[6] = grid->getXyzPointIndexFromCellCorner( vtkICellIndex, vtkJCellIndex, vtkKCellIndex, 6 ) - translatePoint;
-          indice[7] = grid->getXyzPointIndexFromCellCorner( vtkICellIndex, vtkJCellIndex, vtkKCellIndex, 7 ) - translatePoint;
+      std::copy_n( gridXyzPoints.get() + 3 * usedPoints[pointId], 3, allXyzPoints + 3 * pointId );
+    }
+  }
+  const vtkIdType loadedPointCount = options.compactInactiveCells
+                                     ? LvArray::integerConversion< vtkIdType >( usedPoints.size() )
+                                     : LvArray::integerConversion< vtkIdType >( pointCount );
+  if( grid->getLocalCrs( 0 )->isDepthOriented())
+  {
+    for( vtkIdType zCoordIndex = 2; zCoordIndex < 3 * loadedPointCount; zCoordIndex += 3 )
+    {
+      allXyzPoints[zCoordIndex] *= -1;
+    }
+  }
 
-        }
-        else
-        {
-          vtk_explicitStructuredGrid->BlankCell( cellId );
-        }
-      }
+  vtkNew< vtkDoubleArray > vtkUnderlyingArray;
+  vtkUnderlyingArray->SetNumberOfComponents( 3 );
+  // Take ownership of the underlying C array
+  vtkUnderlyingArray->SetArray( allXyzPoints, 3 * loadedPointCount, 0, vtkAbstractArray::VTK_DATA_ARRAY_DELETE );
+  vtkNew< vtkPoints > points;
+  points->SetData( vtkUnderlyingArray );
+
+  // The RESQML corners of the k and k+1 faces are the bottom and top faces of the VTK hexahedron.
+  // They are swapped when the grid is left handed once the z axis is flipped, which is checked on the first non flat cell.
+  bool isLeftHanded = false;
+  for( vtkIdType cell = 0; cell < loadedCellCount; ++cell )
+  {
+    if( !options.compactInactiveCells && !enabledCells[cell] )
+    {
+      continue;
+    }
+    double p[4][3];
+    points->GetPoint( corners[8 * cell], p[0] );
+    points->GetPoint( corners[8 * cell + 1], p[1] );
+    points->GetPoint( corners[8 * cell + 3], p[2] );
+    points->GetPoint( corners[8 * cell + 4], p[3] );
+    double u[3], v[3], w[3];
+    for( int d = 0; d < 3; ++d )
+    {
+      u[d] = p[1][d] - p[0][d];
+      v[d] = p[2][d] - p[0][d];
+      w[d] = p[3][d] - p[0][d];
+    }
+    const double volume = ( u[1] * v[2] - u[2] * v[1] ) * w[0] + ( u[2] * v[0] - u[0] * v[2] ) * w[1] + ( u[0] * v[1] - u[1] * v[0] ) * w[2];
+    if( volume != 0 )
+    {
+      isLeftHanded = volume < 0;
+      break;
     }
   }
+  if( isLeftHanded )
+  {
+    forAll< parallelHostPolicy >( loadedCellCount, [corners]( localIndex const cell )
+    {
+      std::swap_ranges( corners + 8 * cell, corners + 8 * cell + 4, corners + 8 * cell + 4 );
+    } );
+  }
 
-  grid->unloadSplitInformation();
+  // CELLS
+  vtkNew< vtkIdTypeArray > offsets;
+  offsets->SetNumberOfValues( loadedCellCount + 1 );
+  for( vtkIdType cell = 0; cell <= loadedCellCount; ++cell )
+  {
+    offsets->SetValue( cell, 8 * cell );
+  }
+  vtkNew< vtkCellArray > cells;
+  cells->SetData( offsets, connectivity );
 
-  vtk_explicitStructuredGrid->CheckAndReorderFaces();
-  vtk_explicitStructuredGrid->ComputeFacesConnectivityFlagsArray();
+  auto vtk_unstructuredGrid = vtkSmartPointer< vtkUnstructuredGrid >::New();
+  vtk_unstructuredGrid->SetPoints( points );
+  vtk_unstructuredGrid->SetCells( VTK_HEXAHEDRON, cells );
+  if( options.compactInactiveCells )
+  {
+    vtk_unstructuredGrid->GetCellData()->AddArray( cellIndices );
+    GEOS_LOG_RANK_0( GEOS_FMT( "{}: {} of {} cells and {} of {} points kept",
+                               grid->getTitle(), loadedCellCount, cellCount, loadedPointCount, pointCount ) );
+    setGlobalIds( *vtk_unstructuredGrid, cellIndices->GetPointer( 0 ), usedPoints.data() );
+  }
+  else
+  {
+    setGlobalIds( *vtk_unstructuredGrid, nullptr, nullptr );
+  }
 
-  return vtkDataSet::SafeDownCast( vtk_explicitStructuredGrid );
+  return vtkDataSet::SafeDownCast( vtk_unstructuredGrid );
 }
 
 vtkSmartPointer< vtkDataSet >
-loadUnstructuredGridRepresentation( RESQML2_NS::UnstructuredGridRepresentation *grid )
+loadUnstructuredGridRepresentation( RESQML2_NS::UnstructuredGridRepresentation *grid, GridLoadOptions const & options )
 {
   auto vtk_unstructuredGrid = vtkSmartPointer< vtkUnstructuredGrid >::New();
 
@@ -604,20 +1114,41 @@ loadUnstructuredGridRepresentation( RESQML2_NS::UnstructuredGridRepresentation *
   uint64_t pointCount = grid->getXyzPointCountOfAllPatches();
 
   // POINTS
-  double *allXyzPoints = new double[pointCount * 3]; // Will be deleted by VTK;
-  grid->getXyzPointsOfAllPatches( allXyzPoints ); //getXyzPointsOfAllPatchesInGlobalCrs
-
   const size_t coordCount = pointCount * 3;
 
-  if( grid->getLocalCrs( 0 ) != nullptr )
+  const bool isDepthOriented = grid->getLocalCrs( 0 ) != nullptr &&
+                               !grid->getLocalCrs( 0 )->isPartial() &&
+                               grid->getLocalCrs( 0 )->isDepthOriented();
+
+  // Points which do not need to be flipped are mapped from the file instead of being copied
+  Hdf5DatasetLocation location;
+  hsize_t mappedCount = 0;
+  const bool isLocated = locateGridPoints( grid, location );
+  double *allXyzPoints = !isDepthOriented && isLocated
+                         ? static_cast< double * >( mapHdf5Dataset( location, H5T_NATIVE_DOUBLE, mappedCount ))
+                         : nullptr;
+  const bool isMapped = allXyzPoints != nullptr && mappedCount == coordCount;
+  if( allXyzPoints != nullptr && !isMapped )
+  {
+    unmapHdf5Dataset( allXyzPoints );
+  }
+
+  if( !isMapped )
   {
-    if( !grid->getLocalCrs( 0 )->isPartial())
+    allXyzPoints = new double[coordCount]; // Will be deleted by VTK;
+
+    // Compressed points are decompressed in parallel
+    if( !isLocated || !readDeflatedHdf5Dataset( location, H5T_NATIVE_DOUBLE, allXyzPoints, coordCount ))
     {
-      const double zIndice = grid->getLocalCrs( 0 )->isDepthOriented() ? -1 : 1;
+      std::lock_guard< std::recursive_mutex > const lock( hdf5Mutex() );
+      grid->getXyzPointsOfAllPatches( allXyzPoints ); //getXyzPointsOfAllPatchesInGlobalCrs
+    }
 
+    if( isDepthOriented )
+    {
       for( size_t zCoordIndex = 2; zCoordIndex < coordCount; zCoordIndex += 3 )
       {
-        allXyzPoints[zCoordIndex] *= zIndice;
+        allXyzPoints[zCoordIndex] *= -1;
       }
     }
   }
@@ -625,21 +1156,49 @@ loadUnstructuredGridRepresentation( RESQML2_NS::UnstructuredGridRepresentation *
   vtkNew< vtkDoubleArray > vtkUnderlyingArray;
   vtkUnderlyingArray->SetNumberOfComponents( 3 );
   // Take ownership of the underlying C array
-  vtkUnderlyingArray->SetArray( allXyzPoints, coordCount, vtkAbstractArray::VTK_DATA_ARRAY_DELETE );
+  if( isMapped )
+  {
+    vtkUnderlyingArray->SetArray( allXyzPoints, coordCount, 0, vtkAbstractArray::VTK_DATA_ARRAY_USER_DEFINED );
+    vtkUnderlyingArray->SetArrayFreeFunction( unmapHdf5Dataset );
+  }
+  else
+  {
+    vtkUnderlyingArray->SetArray( allXyzPoints, coordCount, 0, vtkAbstractArray::VTK_DATA_ARRAY_DELETE );
+  }
 
   vtkNew< vtkPoints > vtkPts;
   vtkPts->SetData( vtkUnderlyingArray );
 
   vtk_unstructuredGrid->SetPoints( vtkPts );
-  grid->loadGeometry();
+
   // CELLS
-  const unsigned int nodeCount = grid->getNodeCount();
-  std::unique_ptr< vtkIdType[] > pointIds( new vtkIdType[nodeCount] );
-  for( unsigned int i = 0; i < nodeCount; ++i )
+  const ULONG64 cellCount = grid->getCellCount();
+
+  // The streamed topology is read by ranges of cells, the whole topology is loaded otherwise
+  Hdf5GridTopology topology;
+  if( options.streamingChunkSize > 0 && cellCount > 0 && locateGridTopology( grid, topology ))
   {
-    pointIds[i] = i;
+    const ULONG64 chunkSize = LvArray::integerConversion< ULONG64 >( options.streamingChunkSize );
+    UnstructuredGridTopologyReader const reader( topology );
+    for( ULONG64 firstCell = 0; firstCell < cellCount; firstCell += chunkSize )
+    {
+      const ULONG64 chunkCellCount = std::min( chunkSize, cellCount - firstCell );
+      UnstructuredGridChunk const chunk( reader, firstCell, chunkCellCount, isDepthOriented );
+      for( ULONG64 cellIndex = firstCell; cellIndex < firstCell + chunkCellCount; ++cellIndex )
+      {
+        insertCell( vtk_unstructuredGrid, &chunk, chunk.getCellFaceIsRightHanded( cellIndex ), cellIndex );
+      }
+    }
+    setGlobalIds( *vtk_unstructuredGrid, nullptr, nullptr );
+
+    return vtkDataSet::SafeDownCast( vtk_unstructuredGrid );
   }
-  const ULONG64 cellCount = grid->getCellCount();
+
+  GEOS_LOG_RANK_0_IF( options.streamingChunkSize > 0,
+                      GEOS_FMT( "The topology of {} is not stored in HDF5 datasets and is loaded at once", grid->getTitle() ) );
+
+  std::unique_lock< std::recursive_mutex > lock( hdf5Mutex() );
+  grid->loadGeometry();
   // This pointer is owned and managed by FESAPI
   ULONG64 const *cumulativeFaceCountPerCell = grid->isFaceCountOfCellsConstant()
                           ? nullptr
@@ -652,9 +1211,9 @@ loadUnstructuredGridRepresentation( RESQML2_NS::UnstructuredGridRepresentation *
   std::unique_ptr< unsigned char[] > cellFaceNormalOutwardlyDirected( new unsigned char[faceCount] );
 
   grid->getCellFaceIsRightHanded( cellFaceNormalOutwardlyDirected.get());
+  lock.unlock();
 
-  auto * crs = grid->getLocalCrs( 0 );
-  if( !crs->isPartial() && crs->isDepthOriented())
+  if( isDepthOriented )
   {
     for( size_t i = 0; i < faceCount; ++i )
     {
@@ -664,63 +1223,352 @@ loadUnstructuredGridRepresentation( RESQML2_NS::UnstructuredGridRepresentation *
 
   for( ULONG64 cellIndex = 0; cellIndex < cellCount; ++cellIndex )
   {
-    bool isOptimizedCell = false;
+    // The index of the first face of the cell in the cellFaceNormalOutwardlyDirected array
+    const size_t cellFirstFaceIndex = cumulativeFaceCountPerCell == nullptr
+      ? cellIndex * grid->getConstantFaceCountOfCells()
+      : ( cellIndex == 0 ? 0 : cumulativeFaceCountPerCell[cellIndex - 1] );
 
+    insertCell( vtk_unstructuredGrid, grid, cellFaceNormalOutwardlyDirected.get() + cellFirstFaceIndex, cellIndex );
+  }
 
-    const ULONG64 localFaceCount = grid->getFaceCountOfCell( cellIndex );
+  grid->unloadGeometry();
+  setGlobalIds( *vtk_unstructuredGrid, nullptr, nullptr );
 
-    if( localFaceCount == 4 )
-    { // VTK_TETRA
-      cellVtkTetra( vtk_unstructuredGrid, grid, cumulativeFaceCountPerCell, cellFaceNormalOutwardlyDirected.get(), cellIndex );
-      isOptimizedCell = true;
-    }
-    else if( localFaceCount == 5 )
-    { // VTK_WEDGE or VTK_PYRAMID
-      cellVtkWedgeOrPyramid( vtk_unstructuredGrid, grid, cumulativeFaceCountPerCell, cellFaceNormalOutwardlyDirected.get(), cellIndex );
-      isOptimizedCell = true;
-    }
-    else if( localFaceCount == 6 )
-    { // VTK_HEXAHEDRON
-      isOptimizedCell = cellVtkHexahedron( vtk_unstructuredGrid, grid, cumulativeFaceCountPerCell, cellFaceNormalOutwardlyDirected.get(), cellIndex );
-    }
-    else if( localFaceCount == 7 )
-    { // VTK_PENTAGONAL_PRISM
-      isOptimizedCell = cellVtkPentagonalPrism( vtk_unstructuredGrid, grid, cellIndex );
-    }
-    else if( localFaceCount == 8 )
-    { // VTK_HEXAGONAL_PRISM
-      isOptimizedCell = cellVtkHexagonalPrism( vtk_unstructuredGrid, grid, cellIndex );
-    }
+  return vtkDataSet::SafeDownCast( vtk_unstructuredGrid );
+}
 
-    if( !isOptimizedCell )
+std::uint64_t
+hilbertIndex3d( std::array< std::uint32_t, 3 > coordinates, int const bitCount )
+{
+  // Skilling's transform of the coordinates into the transposed Hilbert index
+  std::uint32_t * const x = coordinates.data();
+  std::uint32_t const highestBit = 1u << ( bitCount - 1 );
+  for( std::uint32_t q = highestBit; q > 1; q >>= 1 )
+  {
+    std::uint32_t const p = q - 1;
+    for( int d = 0; d < 3; ++d )
     {
-      vtkNew< vtkIdList > idList;
+      if( x[d] & q )
+      {
+        x[0] ^= p;
+      }
+      else
+      {
+        std::uint32_t const t = ( x[0] ^ x[d] ) & p;
+        x[0] ^= t;
+        x[d] ^= t;
+      }
+    }
+  }
+
+  // Gray encoding
+  x[1] ^= x[0];
+  x[2] ^= x[1];
+  std::uint32_t t = 0;
+  for( std::uint32_t q = highestBit; q > 1; q >>= 1 )
+  {
+    if( x[2] & q )
+    {
+      t ^= q - 1;
+    }
+  }
+  for( int d = 0; d < 3; ++d )
+  {
+    x[d] ^= t;
+  }
+
+  // Interleave the bits of the transposed index
+  std::uint64_t index = 0;
+  for( int bit = bitCount - 1; bit >= 0; --bit )
+  {
+    for( int d = 0; d < 3; ++d )
+    {
+      index = ( index << 1 ) | ( ( x[d] >> bit ) & 1 );
+    }
+  }
+  return index;
+}
 
-      // For polyhedron cell, a special ptIds input format is required : (numCellFaces, numFace0Pts, id1, id2, id3, numFace1Pts, id1, id2,
-      // id3, ...)
-      idList->InsertNextId( localFaceCount );
-      for( ULONG64 localFaceIndex = 0; localFaceIndex < localFaceCount; ++localFaceIndex )
+/**
+ * @brief Split a range of cells in partitions by recursive bisection of their (i,j,k) box
+ * @param ijk the logical indices of all the cells
+ * @param first the first cell of the range, in cellIds
+ * @param last the end of the range, in cellIds
+ * @param firstPartition the first partition of the range
+ * @param partitionCount the number of partitions of the range
+ * @param partitions the partition of each cell
+ */
+static void bisectIjkCells( std::vector< std::array< std::uint32_t, 3 > > const & ijk,
+                            std::vector< vtkIdType >::iterator first,
+                            std::vector< vtkIdType >::iterator last,
+                            int const firstPartition,
+                            int const partitionCount,
+                            std::vector< int > & partitions )
+{
+  if( partitionCount == 1 || first == last )
+  {
+    for( auto cell = first; cell != last; ++cell )
+    {
+      partitions[*cell] = firstPartition;
+    }
+    return;
+  }
+
+  // Cut the longest side of the box of the range, in proportion of the partitions on each side
+  std::array< std::uint32_t, 3 > lower = ijk[*first];
+  std::array< std::uint32_t, 3 > upper = ijk[*first];
+  for( auto cell = first; cell != last; ++cell )
+  {
+    for( int d = 0; d < 3; ++d )
+    {
+      lower[d] = std::min( lower[d], ijk[*cell][d] );
+      upper[d] = std::max( upper[d], ijk[*cell][d] );
+    }
+  }
+  int axis = 0;
+  for( int d = 1; d < 3; ++d )
+  {
+    if( upper[d] - lower[d] > upper[axis] - lower[axis] )
+    {
+      axis = d;
+    }
+  }
+
+  int const lowerPartitionCount = partitionCount / 2;
+  auto const middle = first + ( last - first ) * lowerPartitionCount / partitionCount;
+  std::nth_element( first, middle, last, [&ijk, axis]( vtkIdType const a, vtkIdType const b )
+  {
+    return ijk[a][axis] < ijk[b][axis];
+  } );
+
+  bisectIjkCells( ijk, first, middle, firstPartition, lowerPartitionCount, partitions );
+  bisectIjkCells( ijk, middle, last, firstPartition + lowerPartitionCount, partitionCount - lowerPartitionCount, partitions );
+}
+
+std::vector< int >
+partitionIjkGrid( vtkDataSet * dataset, RESQML2_NS::AbstractIjkGridRepresentation * grid, StructuredPartitionMethod const method, int const partitionCount )
+{
+  vtkIdType const cellCount = dataset->GetNumberOfCells();
+  std::vector< int > partitions( cellCount, 0 );
+  if( method == StructuredPartitionMethod::none || partitionCount <= 1 )
+  {
+    return partitions;
+  }
+
+  std::uint32_t const iCellCount = grid->getICellCount();
+  std::uint32_t const jCellCount = grid->getJCellCount();
+  std::uint32_t const kCellCount = grid->getKCellCount();
+  vtkIdTypeArray * const cellIndices = vtkIdTypeArray::SafeDownCast( dataset->GetCellData()->GetArray( resqmlCellIndexArrayName ));
+
+  std::vector< std::array< std::uint32_t, 3 > > ijk( cellCount );
+  forAll< parallelHostPolicy >( cellCount, [&]( localIndex const cellId )
+  {
+    std::uint64_t const cellIndex = cellIndices == nullptr ? cellId : cellIndices->GetValue( cellId );
+    ijk[cellId] = { LvArray::integerConversion< std::uint32_t >( cellIndex % iCellCount ),
+                    LvArray::integerConversion< std::uint32_t >( ( cellIndex / iCellCount ) % jCellCount ),
+                    LvArray::integerConversion< std::uint32_t >( cellIndex / ( std::uint64_t( iCellCount ) * jCellCount )) };
+  } );
+
+  std::vector< vtkIdType > cellIds( cellCount );
+  std::iota( cellIds.begin(), cellIds.end(), 0 );
+
+  if( method == StructuredPartitionMethod::cartesian )
+  {
+    bisectIjkCells( ijk, cellIds.begin(), cellIds.end(), 0, partitionCount, partitions );
+    return partitions;
+  }
+
+  int bitCount = 1;
+  while( ( std::uint64_t( 1 ) << bitCount ) < std::max( { iCellCount, jCellCount, kCellCount } ))
+  {
+    ++bitCount;
+  }
+  GEOS_ERROR_IF( bitCount > 21, GEOS_FMT( "{}: too many cells along an axis for a Hilbert curve", grid->getTitle() ));
+
+  std::vector< std::uint64_t > curveIndices( cellCount );
+  forAll< parallelHostPolicy >( cellCount, [&]( localIndex const cellId )
+  {
+    curveIndices[cellId] = hilbertIndex3d( ijk[cellId], bitCount );
+  } );
+  std::sort( cellIds.begin(), cellIds.end(), [&curveIndices]( vtkIdType const a, vtkIdType const b )
+  {
+    return curveIndices[a] < curveIndices[b];
+  } );
+  for( vtkIdType position = 0; position < cellCount; ++position )
+  {
+    partitions[cellIds[position]] = LvArray::integerConversion< int >( position * partitionCount / cellCount );
+  }
+
+  return partitions;
+}
+
+/**
+ * @brief Compute the centers of the cells of a dataset, as the average of their points
+ * @param dataset the dataset
+ * @return the center of each cell
+ */
+static std::vector< std::array< double, 3 > > computeCellCenters( vtkDataSet & dataset )
+{
+  std::vector< std::array< double, 3 > > centers( dataset.GetNumberOfCells(), { 0.0, 0.0, 0.0 } );
+  vtkNew< vtkIdList > pointIds;
+  for( vtkIdType cellId = 0; cellId < dataset.GetNumberOfCells(); ++cellId )
+  {
+    dataset.GetCellPoints( cellId, pointIds );
+    for( vtkIdType i = 0; i < pointIds->GetNumberOfIds(); ++i )
+    {
+      double point[3];
+      dataset.GetPoint( pointIds->GetId( i ), point );
+      for( int d = 0; d < 3; ++d )
+      {
+        centers[cellId][d] += point[d] / pointIds->GetNumberOfIds();
+      }
+    }
+  }
+  return centers;
+}
+
+vtkSmartPointer< vtkDataSet >
+reorderCells( vtkSmartPointer< vtkDataSet > dataset, CellReordering const method )
+{
+  vtkUnstructuredGrid * const grid = vtkUnstructuredGrid::SafeDownCast( dataset );
+  vtkIdType const cellCount = dataset->GetNumberOfCells();
+  if( method == CellReordering::none || grid == nullptr || cellCount == 0 )
+  {
+    return dataset;
+  }
+
+  // Sort the cells along a Hilbert curve over their centers, quantized in the bounding box of the grid
+  constexpr int bitCount = 21;
+  double bounds[6];
+  grid->GetBounds( bounds );
+  std::vector< std::array< double, 3 > > const centers = computeCellCenters( *grid );
+  std::vector< std::uint64_t > curveIndices( cellCount );
+  forAll< parallelHostPolicy >( cellCount, [&]( localIndex const cellId )
+  {
+    std::array< std::uint32_t, 3 > coordinates;
+    for( int d = 0; d < 3; ++d )
+    {
+      double const extent = bounds[2 * d + 1] - bounds[2 * d];
+      double const position = extent > 0 ? ( centers[cellId][d] - bounds[2 * d] ) / extent : 0.0;
+      coordinates[d] = static_cast< std::uint32_t >( std::clamp( position, 0.0, 1.0 ) * ( ( 1u << bitCount ) - 1 ));
+    }
+    curveIndices[cellId] = hilbertIndex3d( coordinates, bitCount );
+  } );
+  std::vector< vtkIdType > cellOrder( cellCount );
+  std::iota( cellOrder.begin(), cellOrder.end(), 0 );
+  std::stable_sort( cellOrder.begin(), cellOrder.end(), [&curveIndices]( vtkIdType const a, vtkIdType const b )
+  {
+    return curveIndices[a] < curveIndices[b];
+  } );
+
+  // The points are numbered in the order the reordered cells first use them
+  vtkIdType const pointCount = grid->GetNumberOfPoints();
+  std::vector< vtkIdType > newPointIds( pointCount, -1 );
+  std::vector< vtkIdType > pointOrder;
+  pointOrder.reserve( pointCount );
+  auto const renumber = [&]( vtkIdType const pointId )
+  {
+    if( newPointIds[pointId] < 0 )
+    {
+      newPointIds[pointId] = LvArray::integerConversion< vtkIdType >( pointOrder.size() );
+      pointOrder.push_back( pointId );
+    }
+    return newPointIds[pointId];
+  };
+
+  auto reordered = vtkSmartPointer< vtkUnstructuredGrid >::New();
+  reordered->Allocate( cellCount );
+  vtkNew< vtkIdList > pointIds;
+  for( vtkIdType const cellId : cellOrder )
+  {
+    int const cellType = grid->GetCellType( cellId );
+    if( cellType == VTK_POLYHEDRON )
+    {
+      // The face stream is (numCellFaces, numFace0Pts, id1, id2, ..., numFace1Pts, id1, id2, ...)
+      grid->GetFaceStream( cellId, pointIds );
+      vtkIdType position = 1;
+      for( vtkIdType face = 0; face < pointIds->GetId( 0 ); ++face )
       {
-        const unsigned int localNodeCount = grid->getNodeCountOfFaceOfCell( cellIndex, localFaceIndex );
-        idList->InsertNextId( localNodeCount );
-        ULONG64 const *nodeIndices = grid->getNodeIndicesOfFaceOfCell( cellIndex, localFaceIndex );
-        for( unsigned int i = 0; i < localNodeCount; ++i )
+        vtkIdType const facePointCount = pointIds->GetId( position++ );
+        for( vtkIdType i = 0; i < facePointCount; ++i, ++position )
         {
-          idList->InsertNextId( nodeIndices[i] );
+          pointIds->SetId( position, renumber( pointIds->GetId( position )));
         }
       }
-
-      vtk_unstructuredGrid->InsertNextCell( VTK_POLYHEDRON, idList );
     }
+    else
+    {
+      grid->GetCellPoints( cellId, pointIds );
+      for( vtkIdType i = 0; i < pointIds->GetNumberOfIds(); ++i )
+      {
+        pointIds->SetId( i, renumber( pointIds->GetId( i )));
+      }
+    }
+    reordered->InsertNextCell( cellType, pointIds );
   }
 
-  grid->unloadGeometry();
+  // Points used by no cell keep their relative order after the used ones
+  for( vtkIdType pointId = 0; pointId < pointCount; ++pointId )
+  {
+    renumber( pointId );
+  }
 
-  return vtkDataSet::SafeDownCast( vtk_unstructuredGrid );
+  vtkNew< vtkPoints > points;
+  points->SetDataType( grid->GetPoints()->GetDataType());
+  points->SetNumberOfPoints( pointCount );
+  vtkPointData * const pointData = reordered->GetPointData();
+  pointData->CopyAllOn();
+  pointData->CopyGlobalIdsOn();
+  pointData->CopyAllocate( grid->GetPointData(), pointCount );
+  for( vtkIdType newPointId = 0; newPointId < pointCount; ++newPointId )
+  {
+    points->SetPoint( newPointId, grid->GetPoint( pointOrder[newPointId] ));
+    pointData->CopyData( grid->GetPointData(), pointOrder[newPointId], newPointId );
+  }
+  reordered->SetPoints( points );
+
+  vtkCellData * const cellData = reordered->GetCellData();
+  cellData->CopyAllOn();
+  cellData->CopyGlobalIdsOn();
+  cellData->CopyAllocate( grid->GetCellData(), cellCount );
+  for( vtkIdType newCellId = 0; newCellId < cellCount; ++newCellId )
+  {
+    cellData->CopyData( grid->GetCellData(), cellOrder[newCellId], newCellId );
+  }
+  reordered->GetFieldData()->ShallowCopy( grid->GetFieldData());
+
+  return reordered;
 }
 
-vtkSmartPointer< vtkDataSet >
-loadProperty( vtkSmartPointer< vtkDataSet > dataset, RESQML2_NS::AbstractValuesProperty *valuesProperty, string fieldNameInGEOS )
+/**
+ * @brief Keep the values of the cells of a compacted grid in a cell array of all the RESQML cells
+ * @param dataset the dataset
+ * @param name the name of the cell array
+ */
+static void compactCellArray( vtkDataSet * dataset, string const & name )
+{
+  vtkIdTypeArray * const cellIndices = vtkIdTypeArray::SafeDownCast( dataset->GetCellData()->GetArray( resqmlCellIndexArrayName ));
+  vtkDataArray * const values = dataset->GetCellData()->GetArray( name.c_str());
+  if( cellIndices == nullptr || values == nullptr )
+  {
+    return;
+  }
+
+  vtkSmartPointer< vtkDataArray > compactedValues = vtkSmartPointer< vtkDataArray >::Take( values->NewInstance() );
+  compactedValues->SetName( name.c_str());
+  compactedValues->SetNumberOfComponents( values->GetNumberOfComponents());
+  compactedValues->SetNumberOfTuples( cellIndices->GetNumberOfTuples());
+  for( vtkIdType cellId = 0; cellId < cellIndices->GetNumberOfTuples(); ++cellId )
+  {
+    compactedValues->SetTuple( cellId, cellIndices->GetValue( cellId ), values );
+  }
+
+  // Replaces the array of all the RESQML cells
+  dataset->GetCellData()->AddArray( compactedValues );
+}
+
+vtkSmartPointer< vtkDataArray >
+readProperty( RESQML2_NS::AbstractValuesProperty *valuesProperty, string fieldNameInGEOS )
 {
   const gsoap_eml2_3::eml23__IndexableElement element = valuesProperty->getAttachmentKind();
 
@@ -732,60 +1580,469 @@ loadProperty( vtkSmartPointer< vtkDataSet > dataset, RESQML2_NS::AbstractValuesP
   std::string typeProperty = valuesProperty->getXmlTag();
   if( typeProperty == RESQML2_NS::ContinuousProperty::XML_TAG )
   {
-    readContinuousProperty( valuesProperty, fieldNameInGEOS, dataset->GetCellData() );
+    return readContinuousProperty( valuesProperty, fieldNameInGEOS );
   }
   else if( typeProperty == RESQML2_NS::DiscreteProperty::XML_TAG ||
            typeProperty == RESQML2_NS::CategoricalProperty::XML_TAG )
   {
-    readDiscreteOrCategoricalProperty( valuesProperty, fieldNameInGEOS, dataset->GetCellData() );
+    return readDiscreteOrCategoricalProperty( valuesProperty, fieldNameInGEOS );
   }
-  else
+
+  GEOS_ERROR( GEOS_FMT( "Property {} not supported...", valuesProperty->getUuid() ) );
+  return nullptr;
+}
+
+vtkSmartPointer< vtkDataSet >
+addProperty( vtkSmartPointer< vtkDataSet > dataset, vtkSmartPointer< vtkDataArray > values )
+{
+  dataset->GetCellData()->AddArray( values );
+  compactCellArray( dataset, values->GetName() );
+
+  return dataset;
+}
+
+vtkSmartPointer< vtkDataSet >
+loadProperty( vtkSmartPointer< vtkDataSet > dataset, RESQML2_NS::AbstractValuesProperty *valuesProperty, string fieldNameInGEOS )
+{
+  return addProperty( dataset, readProperty( valuesProperty, fieldNameInGEOS ));
+}
+
+/// Number of element indices of a subrepresentation read at once
+static constexpr hsize_t regionReadChunkSize = 1 << 20;
+
+/**
+ * @brief Add cell indices to a set of cells, setting their bits in parallel
+ * @param cells the set of cells
+ * @param cellIndices the RESQML indices of the cells
+ * @param cellCount the number of cell indices
+ */
+static void insertCells( CellBitset & cells, std::uint64_t const * const cellIndices, std::size_t const cellCount )
+{
+  if( cellCount == 0 )
   {
-    GEOS_ERROR( GEOS_FMT( "Property {} not supported...", valuesProperty->getUuid() ) );
+    return;
   }
 
-  return dataset;
+  std::uint64_t const maxCellIndex = *std::max_element( cellIndices, cellIndices + cellCount );
+  if( maxCellIndex / 64 >= cells.words.size())
+  {
+    cells.words.resize( maxCellIndex / 64 + 1, 0 );
+  }
+
+  std::uint64_t * const words = cells.words.data();
+  forAll< parallelHostPolicy >( LvArray::integerConversion< localIndex >( cellCount ), [=]( localIndex const i )
+  {
+    RAJA::atomicOr< parallelHostAtomic >( &words[cellIndices[i] / 64], std::uint64_t( 1 ) << ( cellIndices[i] % 64 ) );
+  } );
+}
+
+/**
+ * @brief Read the element indices of the first patch of a subrepresentation by ranges
+ * @param subrep the subrepresentation
+ * @param lambda the function called with each range: its indices, which it may modify, their number, and the position of the first one
+ * @details The ranges are read from the HDF5 dataset of the indices when it can be located, so that all the indices are never held at once.
+ * Otherwise, all the indices are read by fesapi in a single range.
+ */
+template< typename LAMBDA >
+static void forElementIndexRanges( RESQML2_NS::SubRepresentation * subrep, LAMBDA && lambda )
+{
+  Hdf5DatasetLocation location;
+  std::unique_lock< std::recursive_mutex > lock( hdf5Mutex() );
+  if( locateSubRepresentationElements( subrep, location ))
+  {
+    lock.unlock();
+    Hdf5RangeReader const reader( location );
+    std::vector< std::uint64_t > elementIndices( std::min( reader.size(), regionReadChunkSize ));
+    for( hsize_t offset = 0; offset < reader.size(); offset += regionReadChunkSize )
+    {
+      hsize_t const count = std::min( reader.size() - offset, regionReadChunkSize );
+      reader.read( H5T_NATIVE_UINT64, offset, count, elementIndices.data() );
+      lambda( elementIndices.data(), std::size_t( count ), std::size_t( offset ));
+    }
+    return;
+  }
+
+  std::vector< std::uint64_t > elementIndices( subrep->getElementCountOfPatch( 0 ));
+  subrep->getElementIndicesOfPatch( 0, 0, elementIndices.data() );
+  lock.unlock();
+  lambda( elementIndices.data(), elementIndices.size(), std::size_t( 0 ));
+}
+
+CellBitset
+readRegionCells( RESQML2_NS::SubRepresentation * region )
+{
+  CellBitset cells;
+
+  {
+    std::lock_guard< std::recursive_mutex > const lock( hdf5Mutex() );
+    if( region->getElementKindOfPatch( 0, 0 ) == gsoap_eml2_3::eml23__IndexableElement::faces )
+    {
+      return cells;
+    }
+  }
+
+  forElementIndexRanges( region, [&cells]( std::uint64_t const * const elementIndices, std::size_t const count, std::size_t )
+  {
+    insertCells( cells, elementIndices, count );
+  } );
+  return cells;
 }
 
 vtkSmartPointer< vtkDataSet >
 createRegions( vtkSmartPointer< vtkDataSet > dataset, std::vector< RESQML2_NS::SubRepresentation * > regions, string attributeName )
 {
-  if( regions.empty())
-    return dataset;
+  std::vector< CellBitset > regionCells;
+  for( RESQML2_NS::SubRepresentation * region : regions )
+  {
+    regionCells.emplace_back( readRegionCells( region ));
+  }
 
-  int region_id = 0;
+  return createRegions( dataset, regionCells, attributeName );
+}
 
-  vtkIntArray * arr = vtkIntArray::New();
-  arr->SetName( attributeName.c_str());
-  arr->SetNumberOfComponents( 1 );
-  arr->SetNumberOfTuples( dataset->GetNumberOfCells());
-  arr->FillValue( region_id );
+/**
+ * @brief Create a cell array of region ids with the smallest integer type holding a region id
+ * @param maxRegionId the largest region id to hold
+ * @param cellCount the number of cells
+ * @param name the name of the cell array
+ * @return the cell array, whose values are not initialized
+ */
+static vtkSmartPointer< vtkDataArray > newRegionIdArray( integer const maxRegionId, vtkIdType const cellCount, string const & name )
+{
+  vtkSmartPointer< vtkDataArray > regionIds;
+  if( maxRegionId <= std::numeric_limits< signed char >::max())
+  {
+    regionIds = vtkSmartPointer< vtkSignedCharArray >::New();
+  }
+  else if( maxRegionId <= std::numeric_limits< short >::max())
+  {
+    regionIds = vtkSmartPointer< vtkShortArray >::New();
+  }
+  else
+  {
+    regionIds = vtkSmartPointer< vtkIntArray >::New();
+  }
+  regionIds->SetName( name.c_str());
+  regionIds->SetNumberOfComponents( 1 );
+  regionIds->SetNumberOfTuples( cellCount );
+  return regionIds;
+}
+
+/**
+ * @brief Call a function on the values of a cell array of region ids created by newRegionIdArray
+ * @param regionIds the cell array
+ * @param lambda the function, called with a pointer to the values
+ */
+template< typename LAMBDA >
+static void forRegionIdValues( vtkDataArray * const regionIds, LAMBDA && lambda )
+{
+  if( auto * const charIds = vtkSignedCharArray::SafeDownCast( regionIds ))
+  {
+    lambda( charIds->GetPointer( 0 ));
+  }
+  else if( auto * const shortIds = vtkShortArray::SafeDownCast( regionIds ))
+  {
+    lambda( shortIds->GetPointer( 0 ));
+  }
+  else if( auto * const intIds = vtkIntArray::SafeDownCast( regionIds ))
+  {
+    lambda( intIds->GetPointer( 0 ));
+  }
+  else
+  {
+    GEOS_ERROR( GEOS_FMT( "The region cell array {} must be of an integer type", regionIds->GetName() ) );
+  }
+}
 
-  vtkDataArrayAccessor< vtkIntArray > attribute( arr );
+/**
+ * @brief Get the cell array of region ids of a dataset, able to hold a region id
+ * @param dataset the dataset
+ * @param name the name of the cell array
+ * @param maxRegionId the largest region id to hold
+ * @return the cell array, filled with 0 if it did not exist, or converted to a larger integer type if needed
+ */
+static vtkDataArray * regionIdArrayHolding( vtkDataSet & dataset, string const & name, integer const maxRegionId )
+{
+  vtkDataArray * const regionIds = dataset.GetCellData()->GetArray( name.c_str());
+  if( regionIds != nullptr && regionIds->GetDataTypeMax() >= maxRegionId )
+  {
+    return regionIds;
+  }
 
-  for( std::size_t i = 0; i < regions.size(); ++i )
+  vtkSmartPointer< vtkDataArray > largerRegionIds;
+  if( regionIds == nullptr )
   {
-    region_id+=1;
+    largerRegionIds = newRegionIdArray( maxRegionId, dataset.GetNumberOfCells(), name );
+    largerRegionIds->Fill( 0 );
+  }
+  else
+  {
+    integer const maxPreviousRegionId = static_cast< integer >( regionIds->GetRange( 0 )[1] );
+    largerRegionIds = newRegionIdArray( std::max( maxRegionId, maxPreviousRegionId ), regionIds->GetNumberOfTuples(), name );
+    largerRegionIds->DeepCopy( regionIds );
+    largerRegionIds->SetName( name.c_str());
+  }
+
+  // Replaces the previous array
+  dataset.GetCellData()->AddArray( largerRegionIds );
+  return largerRegionIds;
+}
 
-    RESQML2_NS::SubRepresentation * region = regions[i];
+vtkSmartPointer< vtkDataSet >
+createRegions( vtkSmartPointer< vtkDataSet > dataset, std::vector< CellBitset > const & regionCells, string attributeName )
+{
+  if( regionCells.empty())
+    return dataset;
 
-    if( region->getElementKindOfPatch( 0, 0 ) != gsoap_eml2_3::eml23__IndexableElement::faces )
+  // The cells already in a previous region are found with a single AND pass per region
+  std::vector< std::uint64_t > previousRegionsCells;
+  for( std::size_t i = 0; i < regionCells.size(); ++i )
+  {
+    std::vector< std::uint64_t > const & words = regionCells[i].words;
+    std::size_t overlapCount = 0;
+    for( std::size_t w = 0; w < std::min( words.size(), previousRegionsCells.size()); ++w )
+    {
+      overlapCount += std::bitset< 64 >( words[w] & previousRegionsCells[w] ).count();
+    }
+    GEOS_WARNING_IF( overlapCount > 0,
+                     GEOS_FMT( "The region {} overlaps the previous regions on {} cells, which get its region id", i + 1, overlapCount ) );
+
+    previousRegionsCells.resize( std::max( words.size(), previousRegionsCells.size()), 0 );
+    for( std::size_t w = 0; w < words.size(); ++w )
     {
-      uint64_t elementCountOfPatch = region->getElementCountOfPatch( 0 );
-      std::unique_ptr< uint64_t[] > elementIndices( new uint64_t[elementCountOfPatch] );
-      region->getElementIndicesOfPatch( 0, 0, elementIndices.get() );
+      previousRegionsCells[w] |= words[w];
+    }
+  }
 
-      for( std::size_t j = 0; j < elementCountOfPatch; ++j )
+  vtkIdType const cellCount = dataset->GetNumberOfCells();
+  vtkSmartPointer< vtkDataArray > regionIds = newRegionIdArray( LvArray::integerConversion< integer >( regionCells.size()), cellCount, attributeName );
+
+  // The cells of a compacted grid are found from their RESQML index
+  vtkIdTypeArray * const cellIndices = vtkIdTypeArray::SafeDownCast( dataset->GetCellData()->GetArray( resqmlCellIndexArrayName ));
+  vtkIdType const * const resqmlIndices = cellIndices == nullptr ? nullptr : cellIndices->GetPointer( 0 );
+  CellBitset const * const regions = regionCells.data();
+  std::size_t const regionCount = regionCells.size();
+
+  forRegionIdValues( regionIds, [&]( auto * const cellRegionIds )
+  {
+    using RegionId = std::remove_pointer_t< decltype( cellRegionIds ) >;
+    forAll< parallelHostPolicy >( cellCount, [=]( localIndex const cellId )
+    {
+      vtkIdType const resqmlIndex = resqmlIndices == nullptr ? vtkIdType( cellId ) : resqmlIndices[cellId];
+      std::size_t regionId = 0;
+      for( std::size_t i = regionCount; i > 0 && resqmlIndex >= 0; --i )
       {
-        attribute.Set( vtkIdType( elementIndices[j] ), 0, region_id );
+        if( regions[i - 1].contains( std::uint64_t( resqmlIndex )))
+        {
+          regionId = i;
+          break;
+        }
       }
+      cellRegionIds[cellId] = static_cast< RegionId >( regionId );
+    } );
+  } );
+  dataset->GetCellData()->AddArray( regionIds );
+
+  return dataset;
+}
+
+vtkSmartPointer< vtkDataSet >
+createRegionsFromProperty( vtkSmartPointer< vtkDataSet > dataset,
+                           vtkSmartPointer< vtkDataArray > values,
+                           std::map< integer, integer > const & regionIdOfValue,
+                           string attributeName )
+{
+  vtkIntArray * const propertyValues = vtkIntArray::SafeDownCast( values );
+  GEOS_ERROR_IF( propertyValues == nullptr || propertyValues->GetNumberOfComponents() != 1,
+                 GEOS_FMT( "Regions can only be defined by a discrete or categorical property with one value per cell. Error with {}", values->GetName() ) );
+  if( regionIdOfValue.empty())
+    return dataset;
+
+  // Lookup table of the region ids from the smallest to the largest value, -1 for the values keeping their region id.
+  // Sparse values spanning more than maxLookupSpan are looked up by binary search in the sorted values instead.
+  constexpr std::int64_t maxLookupSpan = 1 << 20;
+  integer const minValue = regionIdOfValue.begin()->first;
+  integer const maxValue = regionIdOfValue.rbegin()->first;
+  bool const isDense = std::int64_t( maxValue ) - std::int64_t( minValue ) < maxLookupSpan;
+  integer maxRegionId = 0;
+  std::vector< integer > lookup( isDense ? std::size_t( std::int64_t( maxValue ) - std::int64_t( minValue ) + 1 ) : 0, -1 );
+  std::vector< integer > sortedValues;
+  std::vector< integer > sortedRegionIds;
+  for( auto const & [value, regionId] : regionIdOfValue )
+  {
+    if( isDense )
+    {
+      lookup[std::size_t( std::int64_t( value ) - std::int64_t( minValue ))] = regionId;
     }
+    else
+    {
+      sortedValues.push_back( value );
+      sortedRegionIds.push_back( regionId );
+    }
+    maxRegionId = std::max( maxRegionId, regionId );
   }
-  dataset->GetCellData()->AddArray( arr );
+
+  vtkIdType const cellCount = dataset->GetNumberOfCells();
+  vtkDataArray * const regionIds = regionIdArrayHolding( *dataset, attributeName, maxRegionId );
+
+  vtkSignedCharArray * propertyRegionCells = vtkSignedCharArray::SafeDownCast( dataset->GetCellData()->GetArray( propertyRegionCellArrayName ));
+  if( propertyRegionCells == nullptr )
+  {
+    vtkNew< vtkSignedCharArray > newPropertyRegionCells;
+    newPropertyRegionCells->SetName( propertyRegionCellArrayName );
+    newPropertyRegionCells->SetNumberOfValues( cellCount );
+    newPropertyRegionCells->Fill( 0 );
+    dataset->GetCellData()->AddArray( newPropertyRegionCells );
+    propertyRegionCells = newPropertyRegionCells;
+  }
+  signed char * const isPropertyRegionCell = propertyRegionCells->GetPointer( 0 );
+
+  // The values of the cells of a compacted grid are found from their RESQML index
+  vtkIdTypeArray * const cellIndices = vtkIdTypeArray::SafeDownCast( dataset->GetCellData()->GetArray( resqmlCellIndexArrayName ));
+  vtkIdType const * const resqmlIndices = cellIndices == nullptr ? nullptr : cellIndices->GetPointer( 0 );
+  int const * const cellValues = propertyValues->GetPointer( 0 );
+  vtkIdType const valueCount = propertyValues->GetNumberOfTuples();
+  integer const * const regionIdOfCellValue = lookup.data();
+  integer const * const valuesBegin = sortedValues.data();
+  integer const * const valuesEnd = sortedValues.data() + sortedValues.size();
+  integer const * const regionIdOfSortedValue = sortedRegionIds.data();
+
+  forRegionIdValues( regionIds, [&]( auto * const cellRegionIds )
+  {
+    using RegionId = std::remove_pointer_t< decltype( cellRegionIds ) >;
+    forAll< parallelHostPolicy >( cellCount, [=]( localIndex const cellId )
+    {
+      vtkIdType const valueIndex = resqmlIndices == nullptr ? vtkIdType( cellId ) : resqmlIndices[cellId];
+      if( valueIndex < 0 || valueIndex >= valueCount )
+      {
+        return;
+      }
+      int const value = cellValues[valueIndex];
+      if( value >= minValue && value <= maxValue )
+      {
+        integer regionId = -1;
+        if( isDense )
+        {
+          regionId = regionIdOfCellValue[std::int64_t( value ) - std::int64_t( minValue )];
+        }
+        else
+        {
+          integer const * const found = std::lower_bound( valuesBegin, valuesEnd, value );
+          if( found != valuesEnd && *found == value )
+          {
+            regionId = regionIdOfSortedValue[found - valuesBegin];
+          }
+        }
+        if( regionId >= 0 )
+        {
+          cellRegionIds[cellId] = static_cast< RegionId >( regionId );
+          isPropertyRegionCell[cellId] = 1;
+        }
+      }
+    } );
+  } );
 
   return dataset;
 }
 
+void
+convertRegionIdsToInt( vtkDataSet & dataset, string const & attributeName )
+{
+  vtkDataArray * const regionIds = dataset.GetCellData()->GetArray( attributeName.c_str());
+  if( regionIds == nullptr || vtkIntArray::SafeDownCast( regionIds ) != nullptr )
+  {
+    return;
+  }
+
+  vtkNew< vtkIntArray > intRegionIds;
+  intRegionIds->DeepCopy( regionIds );
+  intRegionIds->SetName( attributeName.c_str());
+
+  // Replaces the compact array
+  dataset.GetCellData()->AddArray( intRegionIds );
+}
+
+/**
+ * @brief Make the cell array of regions of a grid, if any, able to hold the region ids of surfaces
+ * @param grid the grid
+ * @param surfaces the surfaces with their region ids
+ * @param regionAttributeName the name of the cell array of regions
+ */
+static void holdSurfaceRegionIds( vtkUnstructuredGrid & grid,
+                                  std::vector< std::pair< integer, RESQML2_NS::SubRepresentation * > > const & surfaces,
+                                  string const & regionAttributeName )
+{
+  if( grid.GetCellData()->GetArray( regionAttributeName.c_str()) != nullptr )
+  {
+    integer maxRegionId = 0;
+    for( auto const & surface : surfaces )
+    {
+      maxRegionId = std::max( maxRegionId, std::get< 0 >( surface ));
+    }
+    regionIdArrayHolding( grid, regionAttributeName, maxRegionId );
+  }
+}
+
+/**
+ * @brief Insert a face of a surface as a cell of a grid
+ * @param grid the grid
+ * @param nodes the ids of the nodes of the face in the grid
+ * @param globalId the global id of the cell
+ * @param regionId the region id of the surface
+ * @param regionAttributeName the name of the cell array of regions
+ */
+static void insertSurfaceCell( vtkUnstructuredGrid & grid,
+                               vtkIdList * const nodes,
+                               vtkIdType const globalId,
+                               integer const regionId,
+                               string const & regionAttributeName )
+{
+  vtkCellData * cell_data = grid.GetCellData();
+  vtkIdTypeArray * globalIds = vtkIdTypeArray::SafeDownCast( cell_data->GetGlobalIds());
+
+  vtkIdType cell_type = VTK_POLYGON;
+  if( nodes->GetNumberOfIds() == 3 )
+  {
+    cell_type = VTK_TRIANGLE;
+  }
+  else if( nodes->GetNumberOfIds() == 4 )
+  {
+    cell_type = VTK_QUAD;
+  }
+
+  vtkIdType newCellId = grid.InsertNextCell( cell_type, nodes );
+
+  for( int arrayIdx = 0; arrayIdx < cell_data->GetNumberOfArrays(); ++arrayIdx )
+  {
+    auto * abArray = cell_data->GetAbstractArray( arrayIdx );
+    if( abArray == globalIds )
+    {
+      globalIds->InsertValue( newCellId, globalId );
+    }
+    else if( abArray->GetName() == string( resqmlCellIndexArrayName ))
+    {
+      vtkArrayDownCast< vtkIdTypeArray >( abArray )->InsertValue( newCellId, -1 );
+    }
+    else if( abArray->GetName()==regionAttributeName )
+    {
+      vtkDataArray * ar = vtkArrayDownCast< vtkDataArray >( abArray );
+      ar->InsertTuple1( newCellId, regionId );
+    }
+    else
+    {
+      int numComps = abArray->GetNumberOfComponents();
+      vtkDoubleArray * ar = vtkArrayDownCast< vtkDoubleArray >( abArray );
+      if( ar != nullptr )
+      {
+        for( int comp = 0; comp < numComps; ++comp )
+        {
+          ar->InsertTypedComponent( newCellId, comp, -9999. );
+        }
+      }
+    }
+  }
+}
+
 vtkSmartPointer< vtkDataSet >
 createSurfaces( vtkSmartPointer< vtkDataSet > dataset, std::vector< std::pair< integer, RESQML2_NS::SubRepresentation * > > surfaces, string regionAttributeName )
 {
@@ -795,9 +2052,15 @@ createSurfaces( vtkSmartPointer< vtkDataSet > dataset, std::vector< std::pair< i
   vtkUnstructuredGrid * grid = vtkUnstructuredGrid::SafeDownCast( dataset );
 
   vtkCellData * cell_data = grid->GetCellData();
-  // auto * region_ids = vtkIntArray::SafeDownCast( cell_data->GetAbstractArray( regionAttributeName.c_str()));
-  // auto * min_max = region_ids->GetRange();
-  // int region_id = min_max[1];
+
+  // The region array may have to hold larger ids than the ones of the regions
+  holdSurfaceRegionIds( *grid, surfaces, regionAttributeName );
+
+  // The surface cells get global ids following the ones of the grid cells
+  vtkIdTypeArray * globalIds = vtkIdTypeArray::SafeDownCast( cell_data->GetGlobalIds());
+  vtkIdType nextGlobalId = globalIds == nullptr || globalIds->GetNumberOfTuples() == 0
+                           ? 0
+                           : *std::max_element( globalIds->GetPointer( 0 ), globalIds->GetPointer( 0 ) + globalIds->GetNumberOfTuples() ) + 1;
 
   for( std::size_t i = 0; i < surfaces.size(); ++i )
   {
@@ -819,56 +2082,363 @@ createSurfaces( vtkSmartPointer< vtkDataSet > dataset, std::vector< std::pair< i
     std::unique_ptr< uint64_t[] > elementIndices( new uint64_t[subFaceCount] );
     surface->getElementIndicesOfPatch( 0, 0, elementIndices.get());
 
-    // region_id += 1;
     for( uint64_t subFaceIndex =0; subFaceIndex < subFaceCount; ++subFaceIndex )
     {
       uint64_t faceIndex = elementIndices[subFaceIndex];
       auto first_indiceValue = faceIndex == 0 ? 0 : nodeCountOfFaces[faceIndex - 1];
       uint64_t nodeCount_OfFaceIndex = nodeCountOfFaces[faceIndex] - first_indiceValue;
 
-      vtkIdType cell_type = VTK_POLYGON;
-      if( nodeCount_OfFaceIndex == 3 )
+      vtkNew< vtkIdList > idList;
+      for( uint64_t nodeIndex = 0; nodeIndex < nodeCount_OfFaceIndex; ++nodeIndex, ++first_indiceValue )
       {
-        cell_type = VTK_TRIANGLE;
+        idList->InsertId( nodeIndex, nodeIndices[first_indiceValue] );
       }
-      else if( nodeCount_OfFaceIndex == 4 )
+
+      insertSurfaceCell( *grid, idList, nextGlobalId++, region_id, regionAttributeName );
+    }
+  }
+
+  return vtkDataSet::SafeDownCast( grid );
+}
+
+/**
+ * @brief Sort the cells or the points of a dataset by global id
+ * @param globalIds the global ids of the cells or of the points
+ * @return the pairs (global id, id) of the cells or of the points, sorted by global id
+ */
+static std::vector< std::pair< vtkIdType, vtkIdType > > sortByGlobalId( vtkDataArray * const globalIds )
+{
+  vtkIdTypeArray * const ids = vtkIdTypeArray::SafeDownCast( globalIds );
+  GEOS_ERROR_IF( ids == nullptr, "The RESQML indices of the cells and of the points must be their global ids" );
+
+  std::vector< std::pair< vtkIdType, vtkIdType > > sortedIds( ids->GetNumberOfTuples());
+  for( vtkIdType id = 0; id < ids->GetNumberOfTuples(); ++id )
+  {
+    sortedIds[id] = { ids->GetValue( id ), id };
+  }
+  std::sort( sortedIds.begin(), sortedIds.end());
+  return sortedIds;
+}
+
+vtkSmartPointer< vtkDataSet >
+createOwnedRegions( vtkSmartPointer< vtkDataSet > dataset, std::vector< RESQML2_NS::SubRepresentation * > regions, string attributeName )
+{
+  if( regions.empty())
+  {
+    dataset->GetCellData()->RemoveArray( propertyRegionCellArrayName );
+    return dataset;
+  }
+
+  std::vector< std::pair< vtkIdType, vtkIdType > > const sortedCells = sortByGlobalId( dataset->GetCellData()->GetGlobalIds());
+
+  // Region id of the last region holding each cell, 0 if the cell is in none of them
+  std::vector< integer > regionIdOfCell( sortedCells.size(), 0 );
+  for( std::size_t i = 0; i < regions.size(); ++i )
+  {
+    integer const regionId = LvArray::integerConversion< integer >( i + 1 );
+    forElementIndexRanges( regions[i], [&]( std::uint64_t * const elementIndices, std::size_t const count, std::size_t )
+    {
+      // Sorted intersection of the range with the cells
+      std::sort( elementIndices, elementIndices + count );
+      auto cell = sortedCells.begin();
+      for( std::size_t j = 0; j < count && cell != sortedCells.end(); ++j )
       {
-        cell_type = VTK_QUAD;
+        vtkIdType const cellIndex = LvArray::integerConversion< vtkIdType >( elementIndices[j] );
+        while( cell != sortedCells.end() && cell->first < cellIndex )
+        {
+          ++cell;
+        }
+        if( cell != sortedCells.end() && cell->first == cellIndex )
+        {
+          regionIdOfCell[cell->second] = regionId;
+        }
       }
+    } );
+  }
 
-      vtkNew< vtkIdList > idList;
-      for( uint64_t nodeIndex = 0; nodeIndex < nodeCount_OfFaceIndex; ++nodeIndex, ++first_indiceValue )
+  // The regions of the property values, applied on rank 0 over the regions of the subrepresentations, are kept
+  vtkSignedCharArray * const propertyRegionCells = vtkSignedCharArray::SafeDownCast( dataset->GetCellData()->GetArray( propertyRegionCellArrayName ));
+  signed char const * const isPropertyRegionCell = propertyRegionCells == nullptr ? nullptr : propertyRegionCells->GetPointer( 0 );
+
+  vtkDataArray * const regionIds = regionIdArrayHolding( *dataset, attributeName, LvArray::integerConversion< integer >( regions.size()));
+  integer const * const regionIdOfCellPtr = regionIdOfCell.data();
+  forRegionIdValues( regionIds, [&]( auto * const cellRegionIds )
+  {
+    using RegionId = std::remove_pointer_t< decltype( cellRegionIds ) >;
+    forAll< parallelHostPolicy >( LvArray::integerConversion< localIndex >( regionIdOfCell.size()), [=]( localIndex const cellId )
+    {
+      bool const isAssigned = regionIdOfCellPtr[cellId] > 0;
+      if( isAssigned && ( isPropertyRegionCell == nullptr || isPropertyRegionCell[cellId] == 0 ))
       {
-        idList->InsertId( nodeIndex, nodeIndices[first_indiceValue] );
+        cellRegionIds[cellId] = static_cast< RegionId >( regionIdOfCellPtr[cellId] );
+      }
+    } );
+  } );
+  dataset->GetCellData()->RemoveArray( propertyRegionCellArrayName );
+
+  return dataset;
+}
+
+vtkSmartPointer< vtkDataSet >
+createOwnedSurfaces( vtkSmartPointer< vtkDataSet > dataset,
+                     std::vector< std::pair< integer, RESQML2_NS::SubRepresentation * > > surfaces,
+                     string regionAttributeName,
+                     vtkIdType firstGlobalId )
+{
+  if( surfaces.empty())
+    return dataset;
+
+  vtkUnstructuredGrid * grid = vtkUnstructuredGrid::SafeDownCast( dataset );
+  holdSurfaceRegionIds( *grid, surfaces, regionAttributeName );
+
+  std::vector< std::pair< vtkIdType, vtkIdType > > const sortedPoints = sortByGlobalId( grid->GetPointData()->GetGlobalIds());
+  auto const findPoint = [&sortedPoints]( ULONG64 const nodeIndex ) -> vtkIdType
+  {
+    vtkIdType const globalId = LvArray::integerConversion< vtkIdType >( nodeIndex );
+    auto const point = std::lower_bound( sortedPoints.begin(), sortedPoints.end(), std::make_pair( globalId, vtkIdType( 0 )));
+    return point != sortedPoints.end() && point->first == globalId ? point->second : -1;
+  };
+
+  vtkIdType surfaceFirstGlobalId = firstGlobalId;
+  for( auto const & [regionId, surface] : surfaces )
+  {
+    auto * supportingGrid = dynamic_cast< RESQML2_NS::UnstructuredGridRepresentation * >( surface->getSupportingRepresentation( 0 ));
+    GEOS_ERROR_IF( supportingGrid == nullptr, GEOS_FMT( "The surface {} must be made of faces of an unstructured grid", surface->getUuid() ) );
+
+    Hdf5GridTopology topology;
+    std::unique_ptr< UnstructuredGridTopologyReader > topologyReader;
+    std::vector< ULONG64 > allNodeOffsets;
+    std::vector< ULONG64 > allNodeIndices;
+    {
+      std::lock_guard< std::recursive_mutex > const lock( hdf5Mutex() );
+      if( locateGridTopology( supportingGrid, topology ))
+      {
+        topologyReader = std::make_unique< UnstructuredGridTopologyReader >( topology );
+      }
+      else
+      {
+        // Without HDF5 datasets to read by ranges, each rank reads the whole face topology
+        allNodeOffsets.assign( supportingGrid->getFaceCount() + 1, 0 );
+        supportingGrid->getCumulativeNodeCountPerFace( allNodeOffsets.data() + 1 );
+        allNodeIndices.resize( allNodeOffsets.back());
+        supportingGrid->getNodeIndicesOfFaces( allNodeIndices.data());
       }
+    }
 
-      vtkIdType newCellId = grid->InsertNextCell( cell_type, idList );
+    std::size_t faceCount = 0;
+    std::vector< std::pair< std::uint64_t, std::size_t > > faces;
+    std::vector< ULONG64 > nodeOffsets;
+    std::vector< ULONG64 > nodeIndices;
+    forElementIndexRanges( surface, [&]( std::uint64_t const * const elementIndices, std::size_t const count, std::size_t const offset )
+    {
+      faceCount += count;
 
-      for( int arrayIdx = 0; arrayIdx < cell_data->GetNumberOfArrays(); ++arrayIdx )
+      // The faces are visited by increasing index, so that the node indices of close faces are read at once
+      faces.resize( count );
+      for( std::size_t j = 0; j < count; ++j )
       {
-        auto * abArray = cell_data->GetAbstractArray( arrayIdx );
-        if( abArray->GetName()==regionAttributeName )
+        faces[j] = { elementIndices[j], offset + j };
+      }
+      std::sort( faces.begin(), faces.end());
+
+      for( std::size_t first = 0; first < count; )
+      {
+        std::size_t last = first;
+        ULONG64 firstFace = 0;
+        if( topologyReader != nullptr )
         {
-          vtkIntArray * ar = vtkArrayDownCast< vtkIntArray >( abArray );
-          ar->InsertValue( newCellId, region_id );
+          while( last < count && faces[last].first - faces[first].first < regionReadChunkSize )
+          {
+            ++last;
+          }
+          firstFace = faces[first].first;
+          topologyReader->readNodeOffsets( firstFace, faces[last - 1].first - firstFace + 1, nodeOffsets );
+          nodeIndices.resize( nodeOffsets.back() - nodeOffsets.front());
+          topologyReader->nodesPerFace().read( H5T_NATIVE_ULLONG, nodeOffsets.front(), nodeIndices.size(), nodeIndices.data() );
         }
         else
         {
-          int numComps = abArray->GetNumberOfComponents();
-          vtkDoubleArray * ar = vtkArrayDownCast< vtkDoubleArray >( abArray );
-          if( ar != nullptr )
+          last = count;
+        }
+        ULONG64 const * const offsets = topologyReader != nullptr ? nodeOffsets.data() : allNodeOffsets.data();
+        ULONG64 const * const indices = topologyReader != nullptr ? nodeIndices.data() : allNodeIndices.data();
+
+        // A face is kept by each rank holding all its nodes
+        for( std::size_t j = first; j < last; ++j )
+        {
+          ULONG64 const face = faces[j].first - firstFace;
+          vtkNew< vtkIdList > idList;
+          for( ULONG64 k = offsets[face]; k < offsets[face + 1]; ++k )
           {
-            for( int comp = 0; comp < numComps; ++comp )
+            vtkIdType const pointId = findPoint( indices[k - offsets[0]] );
+            if( pointId < 0 )
             {
-              ar->InsertTypedComponent( newCellId, comp, -9999. );
+              idList->Reset();
+              break;
             }
+            idList->InsertNextId( pointId );
+          }
+          if( idList->GetNumberOfIds() > 0 )
+          {
+            insertSurfaceCell( *grid, idList, surfaceFirstGlobalId + LvArray::integerConversion< vtkIdType >( faces[j].second ), regionId, regionAttributeName );
           }
         }
+        first = last;
       }
-    }
+    } );
+    surfaceFirstGlobalId += LvArray::integerConversion< vtkIdType >( faceCount );
   }
 
   return vtkDataSet::SafeDownCast( grid );
 }
 
+RESQML2_NS::SubRepresentation *
+getPropertySubRepresentation( RESQML2_NS::AbstractValuesProperty * valuesProperty )
+{
+  std::lock_guard< std::recursive_mutex > const lock( hdf5Mutex() );
+  return dynamic_cast< RESQML2_NS::SubRepresentation * >( valuesProperty->getRepresentation());
+}
+
+/**
+ * @brief Read the values of a property supported by a subrepresentation in the cells of a rank
+ * @tparam ARRAY the type of the VTK array of the values
+ * @param valuesProperty the property
+ * @param subrep the subrepresentation supporting the property
+ * @param sortedCells the pairs (global id, id) of the cells of the rank, sorted by global id
+ * @param name the name of the VTK array
+ * @param defaultValue the value of the cells out of the subrepresentation
+ * @return the values of the cells of the rank
+ */
+template< typename ARRAY >
+static vtkSmartPointer< vtkDataArray >
+readOwnedSparseValues( RESQML2_NS::AbstractValuesProperty * const valuesProperty,
+                       RESQML2_NS::SubRepresentation * const subrep,
+                       std::vector< std::pair< vtkIdType, vtkIdType > > const & sortedCells,
+                       string const & name,
+                       real64 const defaultValue )
+{
+  using T = typename ARRAY::ValueType;
+  bool constexpr isContinuous = std::is_same< T, double >::value;
+
+  std::unique_lock< std::recursive_mutex > lock( hdf5Mutex() );
+  unsigned int const componentCount = valuesProperty->getElementCountPerValue();
+  lock.unlock();
+
+  auto values = vtkSmartPointer< ARRAY >::New();
+  values->SetName( name.c_str());
+  values->SetNumberOfComponents( componentCount );
+  values->SetNumberOfTuples( LvArray::integerConversion< vtkIdType >( sortedCells.size()));
+  values->Fill( defaultValue );
+
+  // The values of a single component are read by the same ranges as the element indices,
+  // the other ones are read at once
+  Hdf5DatasetLocation location;
+  std::unique_ptr< Hdf5RangeReader > valuesReader;
+  std::vector< T > allValues;
+  if( componentCount == 1 && locatePropertyValues( valuesProperty, location ))
+  {
+    valuesReader = std::make_unique< Hdf5RangeReader >( location );
+  }
+  else
+  {
+    lock.lock();
+    allValues.resize( valuesProperty->getValuesCountOfPatch( 0 ));
+    if constexpr ( isContinuous )
+    {
+      valuesProperty->getDoubleValuesOfPatch( 0, allValues.data() );
+    }
+    else
+    {
+      valuesProperty->getInt32ValuesOfPatch( 0, allValues.data() );
+    }
+    lock.unlock();
+  }
+
+  std::vector< T > rangeValues;
+  std::vector< std::pair< std::uint64_t, std::size_t > > elements;
+  forElementIndexRanges( subrep, [&]( std::uint64_t const * const elementIndices, std::size_t const count, std::size_t const offset )
+  {
+    T const * elementValues = allValues.data() + offset * componentCount;
+    if( valuesReader != nullptr )
+    {
+      rangeValues.resize( count );
+      valuesReader->read( isContinuous ? H5T_NATIVE_DOUBLE : H5T_NATIVE_INT, offset, count, rangeValues.data() );
+      elementValues = rangeValues.data();
+    }
+
+    // Sorted intersection of the range with the cells
+    elements.resize( count );
+    for( std::size_t j = 0; j < count; ++j )
+    {
+      elements[j] = { elementIndices[j], j };
+    }
+    std::sort( elements.begin(), elements.end());
+
+    auto cell = sortedCells.begin();
+    for( std::size_t j = 0; j < count && cell != sortedCells.end(); ++j )
+    {
+      vtkIdType const cellIndex = LvArray::integerConversion< vtkIdType >( elements[j].first );
+      while( cell != sortedCells.end() && cell->first < cellIndex )
+      {
+        ++cell;
+      }
+      if( cell == sortedCells.end() || cell->first != cellIndex )
+      {
+        continue;
+      }
+      for( unsigned int c = 0; c < componentCount; ++c )
+      {
+        T value = elementValues[elements[j].second * componentCount + c];
+        if constexpr ( isContinuous )
+        {
+          // An undefined value keeps the default value
+          value = std::isnan( value ) ? defaultValue : value;
+        }
+        values->SetTypedComponent( cell->second, int( c ), value );
+      }
+    }
+  } );
+
+  return values;
+}
+
+vtkSmartPointer< vtkDataSet >
+createOwnedSparseProperty( vtkSmartPointer< vtkDataSet > dataset,
+                           RESQML2_NS::AbstractValuesProperty * valuesProperty,
+                           string fieldNameInGEOS,
+                           real64 defaultValue )
+{
+  RESQML2_NS::SubRepresentation * const subrep = getPropertySubRepresentation( valuesProperty );
+  GEOS_ERROR_IF( subrep == nullptr, GEOS_FMT( "Property {} is not supported by a subrepresentation", valuesProperty->getUuid() ) );
+
+  std::unique_lock< std::recursive_mutex > lock( hdf5Mutex() );
+  if( valuesProperty->getAttachmentKind() != gsoap_eml2_3::eml23__IndexableElement::cells ||
+      subrep->getElementKindOfPatch( 0, 0 ) != gsoap_eml2_3::eml23__IndexableElement::cells )
+  {
+    GEOS_ERROR( GEOS_FMT( "Property indexable element must be cells. Error with {}", valuesProperty->getUuid() ) );
+  }
+  std::string const typeProperty = valuesProperty->getXmlTag();
+  lock.unlock();
+
+  std::vector< std::pair< vtkIdType, vtkIdType > > const sortedCells = sortByGlobalId( dataset->GetCellData()->GetGlobalIds());
+
+  vtkSmartPointer< vtkDataArray > values;
+  if( typeProperty == RESQML2_NS::ContinuousProperty::XML_TAG )
+  {
+    values = readOwnedSparseValues< vtkDoubleArray >( valuesProperty, subrep, sortedCells, fieldNameInGEOS, defaultValue );
+  }
+  else if( typeProperty == RESQML2_NS::DiscreteProperty::XML_TAG ||
+           typeProperty == RESQML2_NS::CategoricalProperty::XML_TAG )
+  {
+    values = readOwnedSparseValues< vtkIntArray >( valuesProperty, subrep, sortedCells, fieldNameInGEOS, defaultValue );
+  }
+  else
+  {
+    GEOS_ERROR( GEOS_FMT( "Property {} not supported...", valuesProperty->getUuid() ) );
+  }
+
+  dataset->GetCellData()->AddArray( values );
+  return dataset;
+}
+
 } // namespace geos
@@ -20,48 +20,213 @@
 #define GEOS_EXTERNALCOMPONENTS_RESQML_RESQMLUTILITIES_HPP
 
 #include "common/DataTypes.hpp"
+#include "common/format/EnumStrings.hpp"
 
 #include <vtkSmartPointer.h>
 #include <vtkUnstructuredGrid.h>
-#include <vtkExplicitStructuredGrid.h>
 #include <vtkDataSet.h>
+#include <vtkDataArray.h>
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <vector>
 
 #include "fesapi/resqml2/UnstructuredGridRepresentation.h"
 #include "fesapi/resqml2/AbstractIjkGridRepresentation.h"
+#include "fesapi/resqml2/SubRepresentation.h"
 
 namespace geos
 {
 
+/**
+ * @brief Sizes of a RESQML grid and of its properties, read without any array payload
+ */
+struct GridProbe
+{
+  /// Number of cells of the grid
+  globalIndex cellCount = 0;
+
+  /// Number of nodes of the grid
+  globalIndex nodeCount = 0;
+
+  /// Number of faces of the grid
+  globalIndex faceCount = 0;
+
+  /// Number of cells of each shape
+  std::map< string, globalIndex > cellShapes;
+
+  /// Size in bytes of the values of each property, by title
+  std::map< string, globalIndex > propertyBytes;
+
+  /// Estimated size in bytes of the loaded mesh and properties
+  globalIndex estimatedBytes = 0;
+};
+
+/**
+ * @brief Probe the sizes of a RESQML grid from its XML metadata
+ *
+ * @param[in] rep The RESQML grid as an AbstractObject
+ * @return the sizes of the grid, without its properties
+ * @details The cell shape histogram is exact when the number of faces per cell is constant,
+ * otherwise all the cells are counted with the cell shape declared by the grid.
+ */
+GridProbe
+probeGridRepresentation( COMMON_NS::AbstractObject *rep );
+
+/**
+ * @brief Probe the size of the values of a property from the shape of its HDF5 datasets
+ *
+ * @param[in] valuesProperty The RESQML Property
+ * @return the size in bytes of the values
+ */
+globalIndex
+probePropertyBytes( RESQML2_NS::AbstractValuesProperty *valuesProperty );
+
+/// Name of the cell array holding the RESQML index of the cells of a compacted grid
+constexpr char const * resqmlCellIndexArrayName = "RESQMLCellIndex";
+
+/// Name of the cell array marking the cells given a region by the values of a property, until the regions are loaded on each rank
+constexpr char const * propertyRegionCellArrayName = "RESQMLPropertyRegionCell";
+
+/**
+ * @brief Options of the conversion of a RESQML grid
+ */
+struct GridLoadOptions
+{
+  /// Number of cells of an unstructured grid whose topology is read at once, 0 to read the whole topology
+  globalIndex streamingChunkSize = 0;
+
+  /// Whether the cells of an IJK grid without geometry and the points they only use are dropped
+  bool compactInactiveCells = false;
+};
+
 /**
  * @brief Load a RESQML Grid
  *
  * @param[in] rep The RESQML grid ad an AbstractObject
+ * @param[in] options The conversion options
  * @return the loaded dataset
  *
- * @todo Handle hyperslab
- * @details Handles UnstructuredGridRepresentation and IjkGridRepresentation
+ * @details Handles UnstructuredGridRepresentation and IjkGridRepresentation.
+ * The RESQML indices of the cells and of the points are attached as their global ids,
+ * so that the GEOS global indices are the RESQML indices in the grid.
  */
 vtkSmartPointer< vtkDataSet >
-loadGridRepresentation( COMMON_NS::AbstractObject *rep );
+loadGridRepresentation( COMMON_NS::AbstractObject *rep, GridLoadOptions const & options = {} );
 
 /**
  * @brief Load an IjkGridRepresentation
  *
  * @param[in] rep
+ * @param[in] options The conversion options
  * @return The loaded dataset
+ * @details The grid is loaded as a vtkUnstructuredGrid of hexahedra whose connectivity is filled from the cell corners.
+ * A compacted grid only holds the hexahedra of the cells with a geometry.
+ * The RESQML index of its cells, i + j * ni + k * ni * nj, is stored in the resqmlCellIndexArrayName cell array,
+ * which is used to load the properties and the regions.
  */
 vtkSmartPointer< vtkDataSet >
-loadIjkGridRepresentation( RESQML2_NS::AbstractIjkGridRepresentation * rep );
+loadIjkGridRepresentation( RESQML2_NS::AbstractIjkGridRepresentation * rep, GridLoadOptions const & options = {} );
 
 
 /**
  * @brief Load a RESQML UnstructuredGriRepresentation in a vtkUnstructuredGrid
  *
  * @param[in] grid The RESQML UnstructuredGriRepresentation
+ * @param[in] options The conversion options
  * @return The loaded dataset
+ * @details With a streaming chunk size, the topology is read from the HDF5 datasets by ranges of cells
+ * which are released once converted, instead of being loaded at once.
+ */
+vtkSmartPointer< vtkDataSet >
+loadUnstructuredGridRepresentation( RESQML2_NS::UnstructuredGridRepresentation *grid, GridLoadOptions const & options = {} );
+
+/**
+ * @brief Methods assigning the cells of an IJK grid to partitions from their logical indices
+ */
+enum class StructuredPartitionMethod : integer
+{
+  none,      ///< The cells are partitioned by the generic mesh partitioner
+  cartesian, ///< Recursive bisection of the (i,j,k) box, balancing the loaded cells
+  hilbert    ///< Consecutive ranges of cells along a Hilbert curve over (i,j,k)
+};
+
+/// Strings for StructuredPartitionMethod
+ENUM_STRINGS( StructuredPartitionMethod,
+              "none",
+              "cartesian",
+              "hilbert" );
+
+/**
+ * @brief Compute the index of a point along a 3D Hilbert curve
+ *
+ * @param[in] coordinates The integer coordinates of the point, lower than 2^bitCount
+ * @param[in] bitCount The number of bits of each coordinate, at most 21
+ * @return The index of the point along the curve
+ */
+std::uint64_t
+hilbertIndex3d( std::array< std::uint32_t, 3 > coordinates, int bitCount );
+
+/**
+ * @brief Assign the cells of a loaded IJK grid to partitions
+ *
+ * @param[in] dataset The loaded IJK grid
+ * @param[in] grid The RESQML IJK grid
+ * @param[in] method The partition method
+ * @param[in] partitionCount The number of partitions
+ * @return The partition of each cell of the dataset
+ * @details The cells are found in the grid from the resqmlCellIndexArrayName cell array of a compacted grid,
+ * otherwise from their index. Each partition gets the same number of loaded cells, within one.
+ */
+std::vector< int >
+partitionIjkGrid( vtkDataSet * dataset, RESQML2_NS::AbstractIjkGridRepresentation * grid, StructuredPartitionMethod method, int partitionCount );
+
+/**
+ * @brief Methods reordering the cells of a partition for memory locality
+ */
+enum class CellReordering : integer
+{
+  none,   ///< The cells keep the order of the redistribution
+  hilbert ///< The cells are sorted along a Hilbert curve over their centers
+};
+
+/// Strings for CellReordering
+ENUM_STRINGS( CellReordering,
+              "none",
+              "hilbert" );
+
+/**
+ * @brief Reorder the cells and the points of a vtkUnstructuredGrid
+ *
+ * @param[in] dataset The grid
+ * @param[in] method The reordering method
+ * @return The reordered grid, with its cell and point data, or the dataset if it is not reordered
+ * @details The points are numbered in the order the reordered cells first use them.
+ */
+vtkSmartPointer< vtkDataSet >
+reorderCells( vtkSmartPointer< vtkDataSet > dataset, CellReordering method );
+
+/**
+ * @brief Read the values of a Property in a cell array
+ *
+ * @param[in] valuesProperty The RESQML Property
+ * @param[in] fieldNameInGEOS The name of property in GEOS
+ * @return The values of all the cells of the grid
+ * @details The HDF5 calls hold hdf5Mutex, so that the values can be read by another thread than the grid.
+ */
+vtkSmartPointer< vtkDataArray >
+readProperty( RESQML2_NS::AbstractValuesProperty *valuesProperty, string fieldNameInGEOS );
+
+/**
+ * @brief Add the values of a Property read by readProperty in an existing dataset
+ *
+ * @param[in] dataset The existing dataset
+ * @param[in] values The values of all the cells of the grid
+ * @return The dataset with the property, restricted to its cells for a compacted grid
  */
 vtkSmartPointer< vtkDataSet >
-loadUnstructuredGridRepresentation( RESQML2_NS::UnstructuredGridRepresentation *grid );
+addProperty( vtkSmartPointer< vtkDataSet > dataset, vtkSmartPointer< vtkDataArray > values );
 
 /**
  * @brief Load a Property in an existing dataset
@@ -74,6 +239,61 @@ loadUnstructuredGridRepresentation( RESQML2_NS::UnstructuredGridRepresentation *
 vtkSmartPointer< vtkDataSet >
 loadProperty( vtkSmartPointer< vtkDataSet > dataset, RESQML2_NS::AbstractValuesProperty *valuesProperty, string fieldNameInGEOS );
 
+/**
+ * @brief Set of RESQML cell indices, stored as one bit per cell index
+ */
+struct CellBitset
+{
+  /// The bits of the cell indices, 64 per word, up to the largest index of the set
+  std::vector< std::uint64_t > words;
+
+  /**
+   * @param[in] cellIndex A RESQML cell index
+   * @return Whether the cell is in the set
+   */
+  bool contains( std::uint64_t const cellIndex ) const
+  {
+    return cellIndex / 64 < words.size() && ( ( words[cellIndex / 64] >> ( cellIndex % 64 ) ) & 1 ) != 0;
+  }
+};
+
+/**
+ * @brief Get the subrepresentation supporting a property
+ *
+ * @param[in] valuesProperty The RESQML Property
+ * @return The subrepresentation, nullptr if the property is supported by a grid
+ */
+RESQML2_NS::SubRepresentation *
+getPropertySubRepresentation( RESQML2_NS::AbstractValuesProperty * valuesProperty );
+
+/**
+ * @brief Create a cell array with the values of a property supported by a subrepresentation, in the cells of a rank
+ *
+ * @param dataset The cells of the rank, whose global ids are their RESQML indices
+ * @param valuesProperty The RESQML Property, supported by a subrepresentation of the cells of the grid
+ * @param fieldNameInGEOS The name of property in GEOS
+ * @param defaultValue The value of the cells out of the subrepresentation
+ * @return The dataset with the property
+ * @details The element indices of the subrepresentation are read by ranges with the values of a single component property,
+ * and intersected with the sorted global ids of the cells, so that no array of all the cells of the grid is allocated.
+ */
+vtkSmartPointer< vtkDataSet >
+createOwnedSparseProperty( vtkSmartPointer< vtkDataSet > dataset,
+                           RESQML2_NS::AbstractValuesProperty * valuesProperty,
+                           string fieldNameInGEOS,
+                           real64 defaultValue );
+
+/**
+ * @brief Read the cells of a region
+ *
+ * @param[in] region The RESQML SubRepresentation of the region
+ * @return The RESQML indices of the cells of the region, none if the region is made of faces
+ * @details The indices are read by ranges from their HDF5 dataset when it can be located, and their bits are set in parallel.
+ * The HDF5 calls hold hdf5Mutex, so that the cells can be read by another thread than the grid.
+ */
+CellBitset
+readRegionCells( RESQML2_NS::SubRepresentation * region );
+
 /**
  * @brief Create a cell array of regions with an array of RESQML SubRepresentations
  *
@@ -85,6 +305,49 @@ loadProperty( vtkSmartPointer< vtkDataSet > dataset, RESQML2_NS::AbstractValuesP
 vtkSmartPointer< vtkDataSet >
 createRegions( vtkSmartPointer< vtkDataSet > dataset, std::vector< RESQML2_NS::SubRepresentation * > regions, string attributeName );
 
+/**
+ * @brief Create a cell array of regions with the cells of the regions read by readRegionCells
+ *
+ * @param dataset The existing dataset
+ * @param regionCells The RESQML indices of the cells of each region
+ * @param attributeName The name of the vtk cell array
+ * @return The dataset with the loaded regions
+ * @details The cells shared by several regions are reported, they get the id of the last of them.
+ * The region ids are stored with the smallest integer type holding them.
+ */
+vtkSmartPointer< vtkDataSet >
+createRegions( vtkSmartPointer< vtkDataSet > dataset, std::vector< CellBitset > const & regionCells, string attributeName );
+
+/**
+ * @brief Mark the cells of a dataset with the region ids of the values of a discrete or categorical property
+ *
+ * @param dataset The existing dataset
+ * @param values The values of all the cells of the grid, read by readProperty
+ * @param regionIdOfValue The region id of each value
+ * @param attributeName The name of the vtk cell array
+ * @return The dataset with the regions
+ * @details The region ids are looked up in a table spanning the values, in one pass over the cells,
+ * or by binary search in the sorted values when they span more than 2^20 integers.
+ * The cells whose value is not in regionIdOfValue keep their region id, 0 if the cell array did not exist.
+ * The cells given a region are marked in the propertyRegionCellArrayName cell array.
+ */
+vtkSmartPointer< vtkDataSet >
+createRegionsFromProperty( vtkSmartPointer< vtkDataSet > dataset,
+                           vtkSmartPointer< vtkDataArray > values,
+                           std::map< integer, integer > const & regionIdOfValue,
+                           string attributeName );
+
+/**
+ * @brief Convert the cell array of regions to a vtkIntArray
+ *
+ * @param dataset The dataset
+ * @param attributeName The name of the vtk cell array
+ * @details The regions are stored with the smallest integer type holding their ids while the mesh is loaded and redistributed,
+ * the cell map of GEOS reads them as int.
+ */
+void
+convertRegionIdsToInt( vtkDataSet & dataset, string const & attributeName );
+
 /**
  * @brief Create as many surfaces in a dataset as RESQML SubRepresentations
  *
@@ -96,6 +359,38 @@ createRegions( vtkSmartPointer< vtkDataSet > dataset, std::vector< RESQML2_NS::S
 vtkSmartPointer< vtkDataSet >
 createSurfaces( vtkSmartPointer< vtkDataSet > dataset, std::vector< std::pair< integer, RESQML2_NS::SubRepresentation * > > surfaces, string regionAttributeName );
 
+/**
+ * @brief Create a cell array of regions in the cells of a rank after the redistribution
+ *
+ * @param dataset The cells of the rank, whose global ids are their RESQML indices
+ * @param regions The array of RESQML SubRepresentations
+ * @param attributeName The name of the vtk cell array
+ * @return The dataset with the loaded regions
+ * @details The element indices of each region are read by ranges and intersected with the sorted global ids of the cells.
+ * The cells shared by several regions get the id of the last of them, as in createRegions.
+ * The cells marked in the propertyRegionCellArrayName cell array keep the region of their property value,
+ * which createRegionsFromProperty applied over the regions of the subrepresentations, and the array is removed.
+ */
+vtkSmartPointer< vtkDataSet >
+createOwnedRegions( vtkSmartPointer< vtkDataSet > dataset, std::vector< RESQML2_NS::SubRepresentation * > regions, string attributeName );
+
+/**
+ * @brief Create the surfaces in the cells of a rank after the redistribution
+ *
+ * @param dataset The cells of the rank, whose point global ids are their RESQML indices
+ * @param surfaces The array of RESQML SubRepresentations
+ * @param regionAttributeName The name of the region array name
+ * @param firstGlobalId The global id of the first face of the first surface, larger than the ones of the cells of all the ranks
+ * @return The dataset with the loaded surfaces
+ * @details The faces are read by ranges, and a face is added by each rank holding all its nodes.
+ * The global id of a face only depends on its position in the surfaces, so that a face added by several ranks has a single global id.
+ */
+vtkSmartPointer< vtkDataSet >
+createOwnedSurfaces( vtkSmartPointer< vtkDataSet > dataset,
+                     std::vector< std::pair< integer, RESQML2_NS::SubRepresentation * > > surfaces,
+                     string regionAttributeName,
+                     vtkIdType firstGlobalId );
+
 
 } // namespace geos
 
@@ -38,8 +38,12 @@
 #include "fesapi/resqml2_0_1/DiscreteProperty.h"
 
 // System includes
+#include <algorithm>
+#include <limits>
+#include <numeric>
 #include <random>
 #include <sstream>
+#include <tuple>
 
 #include "hdf5.h"
 
@@ -290,6 +294,18 @@ void RESQMLWriterInterface::initializeOutput()
   // dynamic_cast< EML2_0_NS::HdfProxyMPI * >(m_hdfProxy)->setCollectiveIO();
   m_outputRepository->setDefaultHdfProxy( m_hdfProxy );
 
+  // The packed fields are exposed through virtual datasets stored in a companion file
+  if( m_packScalarFields )
+  {
+    string packedFieldsProxy = uuid::generate_uuid_v4();
+    MpiWrapper::broadcast( packedFieldsProxy, 0 );
+
+    m_packedFieldsProxy = m_outputRepository->createHdfProxy(
+      packedFieldsProxy, "Packed fields virtual datasets", m_outputDir, m_outputName + "_fields.h5",
+      COMMON_NS::DataObjectRepository::openingMode::OVERWRITE );
+
+  }
+
 
   // TODO need local3dCrs ?
   //  local3dCrs = repo.createLocalDepth3dCrs("", "Default local CRS", .0, .0,
@@ -305,6 +321,53 @@ void RESQMLWriterInterface::enableCompression() const
 }
 
 
+void RESQMLWriterInterface::writePackedFieldDatasets()
+{
+  if( m_packedFieldsProxy == nullptr )
+  {
+    return;
+  }
+
+  // The file is only written by the first rank, once no rank holds it open through the proxy
+  m_packedFieldsProxy->close();
+  MpiWrapper::barrier();
+
+  if( MpiWrapper::commRank() == 0 )
+  {
+    hid_t const file = H5Fcreate( joinPath( m_outputDir, m_outputName + "_fields.h5" ).c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT );
+    GEOS_ERROR_IF( file < 0, GEOS_FMT( "Could not create the packed fields file of {}", m_outputName ) );
+
+    hid_t const linkProperties = H5Pcreate( H5P_LINK_CREATE );
+    H5Pset_create_intermediate_group( linkProperties, 1 );
+
+    for( PackedFieldDataset const & fieldDataset : m_packedFieldDatasets )
+    {
+      hsize_t const virtualDimensions[1] = { fieldDataset.dimensions[0] };
+      hsize_t const sourceDimensions[2] = { fieldDataset.dimensions[0], fieldDataset.dimensions[1] };
+      hid_t const virtualSpace = H5Screate_simple( 1, virtualDimensions, nullptr );
+      hid_t const sourceSpace = H5Screate_simple( 2, sourceDimensions, nullptr );
+
+      hsize_t const start[2] = { 0, fieldDataset.column };
+      hsize_t const count[2] = { fieldDataset.dimensions[0], 1 };
+      H5Sselect_hyperslab( sourceSpace, H5S_SELECT_SET, start, nullptr, count, nullptr );
+
+      hid_t const datasetProperties = H5Pcreate( H5P_DATASET_CREATE );
+      H5Pset_virtual( datasetProperties, virtualSpace, ( m_outputName + ".h5" ).c_str(), fieldDataset.packedPath.c_str(), sourceSpace );
+      hid_t const dataset = H5Dcreate2( file, fieldDataset.path.c_str(), fieldDataset.nativeType, virtualSpace, linkProperties, datasetProperties, H5P_DEFAULT );
+      GEOS_ERROR_IF( dataset < 0, GEOS_FMT( "Could not create the virtual dataset {}", fieldDataset.path ) );
+      H5Dclose( dataset );
+      H5Pclose( datasetProperties );
+      H5Sclose( sourceSpace );
+      H5Sclose( virtualSpace );
+    }
+
+    H5Pclose( linkProperties );
+    H5Fclose( file );
+  }
+
+  m_packedFieldDatasets.clear();
+}
+
 void RESQMLWriterInterface::generateOutput() const
 {
   string outputFilename = joinPath( m_outputDir, m_outputName ) + ".epc";
@@ -317,8 +380,8 @@ void RESQMLWriterInterface::generateOutput() const
   pck.serializeFrom( *m_outputRepository );
 }
 
-void RESQMLWriterInterface::generateSubRepresentation(
-  ElementRegionManager const & elemManager, string const & field )
+std::vector< uint64_t > RESQMLWriterInterface::gatherOwnedGlobalIndices(
+  ElementRegionManager const & elemManager, string const & field ) const
 {
   std::vector< uint64_t > data;
 
@@ -330,20 +393,23 @@ void RESQMLWriterInterface::generateSubRepresentation(
       {
         arrayView1d< globalIndex const > const & localToGlobal =
           elementSubRegion.localToGlobalMap();
-        arrayView1d< integer const > const & elemGhostRank =
-          elementSubRegion.ghostRank();
 
-        for( localIndex k = 0; k < elementSubRegion.size(); ++k )
+        for( localIndex const k : getOutputElements( region, elementSubRegion ))
         {
-          if( elemGhostRank[k] < 0 )
-          {
-            data.push_back( localToGlobal[k] );
-          }
+          data.push_back( localToGlobal[k] );
         }
       }
     } );
   } );
 
+  return data;
+}
+
+void RESQMLWriterInterface::generateSubRepresentation(
+  ElementRegionManager const & elemManager, string const & field )
+{
+  std::vector< uint64_t > data = gatherOwnedGlobalIndices( elemManager, field );
+
   // Exchange the sizes of the data across all ranks.
   array1d< int > dataSizes( MpiWrapper::commSize());
   MpiWrapper::allGather( LvArray::integerConversion< int >( data.size()), dataSizes,
@@ -376,6 +442,284 @@ void RESQMLWriterInterface::generateSubRepresentation(
   m_countPerProp.insert( {field, dataSizes} );
 }
 
+/**
+ * @brief Exchange blocks of values between all the ranks
+ * @param sendBuffer the values sent to each rank, ordered by destination rank
+ * @param sendCounts the number of items sent to each rank
+ * @param recvBuffer the values received from each rank, ordered by source rank
+ * @param recvCounts the number of items received from each rank
+ * @param itemSize the number of values of each item
+ * @details The blocks larger than the int count of MPI are exchanged in several messages,
+ * which MPI delivers in order between two ranks.
+ */
+template< typename T >
+static void exchangeValues( T const * const sendBuffer, arrayView1d< int const > const & sendCounts,
+                            T * const recvBuffer, arrayView1d< int const > const & recvCounts,
+                            localIndex const itemSize = 1 )
+{
+  constexpr int exchangeTag = 4810;
+  constexpr localIndex maxMessageSize = std::numeric_limits< int >::max();
+  int const numRanks = MpiWrapper::commSize();
+
+  std::vector< MPI_Request > requests;
+  requests.reserve( 2 * numRanks );
+  localIndex offset = 0;
+  for( int r = 0; r < numRanks; ++r )
+  {
+    localIndex const blockSize = recvCounts[r] * itemSize;
+    for( localIndex messageOffset = 0; messageOffset < blockSize; messageOffset += maxMessageSize )
+    {
+      int const messageSize = LvArray::integerConversion< int >( std::min( maxMessageSize, blockSize - messageOffset ));
+      requests.emplace_back();
+      MpiWrapper::iRecv( recvBuffer + offset + messageOffset, messageSize, r, exchangeTag, MPI_COMM_GEOS, &requests.back() );
+    }
+    offset += blockSize;
+  }
+  offset = 0;
+  for( int r = 0; r < numRanks; ++r )
+  {
+    localIndex const blockSize = sendCounts[r] * itemSize;
+    for( localIndex messageOffset = 0; messageOffset < blockSize; messageOffset += maxMessageSize )
+    {
+      int const messageSize = LvArray::integerConversion< int >( std::min( maxMessageSize, blockSize - messageOffset ));
+      requests.emplace_back();
+      MpiWrapper::iSend( sendBuffer + offset + messageOffset, messageSize, r, exchangeTag, MPI_COMM_GEOS, &requests.back() );
+    }
+    offset += blockSize;
+  }
+
+  MpiWrapper::waitAll( LvArray::integerConversion< int >( requests.size() ), requests.data(), MPI_STATUSES_IGNORE );
+}
+
+void RESQMLWriterInterface::generateParentGridOrdering(
+  ElementRegionManager const & elemManager, string const & field )
+{
+  std::vector< uint64_t > const globalIndices = gatherOwnedGlobalIndices( elemManager, field );
+
+  int const numRanks = MpiWrapper::commSize();
+  int const rank = MpiWrapper::commRank();
+
+  ParentGridOrdering ordering;
+
+  // Each rank writes one contiguous block of the parent grid cells
+  globalIndex const blockLength = ( m_parentCellCount + numRanks - 1 ) / numRanks;
+  ordering.blockOffset = std::min( rank * blockLength, m_parentCellCount );
+  ordering.blockSize = LvArray::integerConversion< localIndex >( std::min( ordering.blockOffset + blockLength, m_parentCellCount ) - ordering.blockOffset );
+
+  // Count the values sent to each block owner
+  ordering.sendCounts.resize( numRanks );
+  ordering.recvCounts.resize( numRanks );
+  for( uint64_t const index : globalIndices )
+  {
+    GEOS_ERROR_IF_GE_MSG( LvArray::integerConversion< globalIndex >( index ), m_parentCellCount,
+                          GEOS_FMT( "RESQML writer: the global index of a cell holding {} is out of the parent grid", field ) );
+    ++ordering.sendCounts[ LvArray::integerConversion< int >( index / blockLength ) ];
+  }
+
+  array1d< int > unitCounts( numRanks );
+  unitCounts.setValues< serialPolicy >( 1 );
+  exchangeValues( ordering.sendCounts.data(), unitCounts.toViewConst(),
+                  ordering.recvCounts.data(), unitCounts.toViewConst() );
+
+  array1d< int > sendDisplacements( numRanks );
+  std::exclusive_scan( ordering.sendCounts.begin(), ordering.sendCounts.end(), sendDisplacements.begin(), 0 );
+
+  // Sort the owned global indices by destination rank
+  array1d< int > nextPosition( sendDisplacements );
+  ordering.sendPositions.resize( LvArray::integerConversion< localIndex >( globalIndices.size() ));
+  array1d< globalIndex > sendIndices( ordering.sendPositions.size() );
+  for( std::size_t i = 0; i < globalIndices.size(); ++i )
+  {
+    int const position = nextPosition[ LvArray::integerConversion< int >( globalIndices[i] / blockLength ) ]++;
+    ordering.sendPositions[i] = position;
+    sendIndices[position] = LvArray::integerConversion< globalIndex >( globalIndices[i] );
+  }
+
+  array1d< globalIndex > recvIndices( std::accumulate( ordering.recvCounts.begin(), ordering.recvCounts.end(), 0 ));
+  exchangeValues( sendIndices.data(), ordering.sendCounts.toViewConst(),
+                  recvIndices.data(), ordering.recvCounts.toViewConst() );
+
+  ordering.recvPositions.resize( recvIndices.size() );
+  for( localIndex i = 0; i < recvIndices.size(); ++i )
+  {
+    ordering.recvPositions[i] = LvArray::integerConversion< localIndex >( recvIndices[i] - ordering.blockOffset );
+  }
+
+  m_parentGridOrderings.insert( {field, std::move( ordering )} );
+}
+
+/**
+ * @brief Index the cells of several cell subrepresentations
+ * @param regions the cell subrepresentations
+ * @return the (cell index, region) pairs sorted by cell index, then by region for the cells shared by several regions
+ */
+static std::vector< std::pair< globalIndex, integer > >
+indexRegionCells( std::vector< RESQML2_NS::SubRepresentation * > const & regions )
+{
+  std::vector< std::pair< globalIndex, integer > > regionCells;
+  for( std::size_t r = 0; r < regions.size(); ++r )
+  {
+    RESQML2_NS::SubRepresentation * const subrep = regions[r];
+    std::vector< uint64_t > indices( subrep->getElementCountOfPatch( 0 ));
+    subrep->getElementIndicesOfPatch( 0, 0, indices.data() );
+    for( uint64_t const index : indices )
+    {
+      regionCells.emplace_back( LvArray::integerConversion< globalIndex >( index ), LvArray::integerConversion< integer >( r ) );
+    }
+  }
+  // A cell listed several times by a region is counted once
+  std::sort( regionCells.begin(), regionCells.end() );
+  regionCells.erase( std::unique( regionCells.begin(), regionCells.end() ), regionCells.end() );
+
+  return regionCells;
+}
+
+/**
+ * @brief Find the regions of a cell
+ * @param regionCells the indexed cells of the regions
+ * @param index the global index of the cell
+ * @return the range of the (cell index, region) pairs of the cell, empty if the cell is outside of all the regions
+ */
+static std::pair< std::vector< std::pair< globalIndex, integer > >::const_iterator,
+                  std::vector< std::pair< globalIndex, integer > >::const_iterator >
+findRegions( std::vector< std::pair< globalIndex, integer > > const & regionCells,
+             globalIndex const index )
+{
+  auto const first = std::lower_bound( regionCells.begin(), regionCells.end(), index,
+                                       []( auto const & cell, globalIndex const value ) { return cell.first < value; } );
+  auto last = first;
+  while( last != regionCells.end() && last->first == index )
+  {
+    ++last;
+  }
+  return { first, last };
+}
+
+arrayView1d< localIndex const > RESQMLWriterInterface::getOutputElements( CellElementRegion const & region,
+                                                                         ElementSubRegionBase const & elementSubRegion ) const
+{
+  return m_outputElements.at( region.getName() + "/" + elementSubRegion.getName() ).toViewConst();
+}
+
+void RESQMLWriterInterface::generateOutputElements( ElementRegionManager const & elemManager )
+{
+  std::vector< std::pair< globalIndex, integer > > const regionCells = indexRegionCells( m_outputRegions );
+
+  elemManager.forElementRegions< CellElementRegion >(
+    [&]( CellElementRegion const & region ) {
+    region.forElementSubRegions(
+      [&]( ElementSubRegionBase const & elementSubRegion ) {
+      arrayView1d< globalIndex const > const & localToGlobal =
+        elementSubRegion.localToGlobalMap();
+      arrayView1d< integer const > const & elemGhostRank =
+        elementSubRegion.ghostRank();
+      arrayView2d< real64 const > const & elemCenter =
+        elementSubRegion.getElementCenter();
+
+      array1d< localIndex > & outputElements = m_outputElements[region.getName() + "/" + elementSubRegion.getName()];
+      outputElements.clear();
+
+      for( localIndex k = 0; k < elementSubRegion.size(); ++k )
+      {
+        if( elemGhostRank[k] >= 0 )
+        {
+          continue;
+        }
+
+        if( !m_outputRegions.empty() )
+        {
+          auto const regions = findRegions( regionCells, localToGlobal[k] );
+          if( regions.first == regions.second )
+          {
+            continue;
+          }
+        }
+
+        if( !m_outputBoundingBox.empty() )
+        {
+          bool inside = true;
+          for( int d = 0; d < 3; ++d )
+          {
+            inside = inside && elemCenter[k][d] >= m_outputBoundingBox[d] && elemCenter[k][d] <= m_outputBoundingBox[d + 3];
+          }
+          if( !inside )
+          {
+            continue;
+          }
+        }
+
+        outputElements.emplace_back( k );
+      }
+    } );
+  } );
+}
+
+void RESQMLWriterInterface::checkSummaryFields( ElementRegionManager const & elemManager ) const
+{
+  std::vector< string > fields = m_summaryFields;
+  if( !m_summaryWeightField.empty() )
+  {
+    fields.push_back( m_summaryWeightField );
+  }
+
+  for( string const & field : fields )
+  {
+    integer isFound = 0;
+    integer isScalar = 1;
+    elemManager.forElementRegions< CellElementRegion >(
+      [&]( CellElementRegion const & region ) {
+      region.forElementSubRegions(
+        [&]( ElementSubRegionBase const & elementSubRegion ) {
+        if( elementSubRegion.hasWrapper( field ))
+        {
+          isFound = 1;
+          if( dynamic_cast< Wrapper< array1d< real64 > > const * >( &elementSubRegion.getWrapperBase( field )) == nullptr )
+          {
+            isScalar = 0;
+          }
+        }
+      } );
+    } );
+
+    GEOS_THROW_IF( MpiWrapper::max( isFound, MPI_COMM_GEOS ) == 0,
+                   GEOS_FMT( "RESQML writer: the summary field {} is not defined on any cell", field ),
+                   InputError );
+    GEOS_THROW_IF( MpiWrapper::min( isScalar, MPI_COMM_GEOS ) == 0,
+                   GEOS_FMT( "RESQML writer: the summary field {} must be a scalar real64 field", field ),
+                   InputError );
+  }
+}
+
+void RESQMLWriterInterface::generateSummaryRegionIndices( ElementRegionManager const & elemManager )
+{
+  std::vector< std::pair< globalIndex, integer > > const regionCells = indexRegionCells( m_summaryRegions );
+
+  elemManager.forElementRegions< CellElementRegion >(
+    [&]( CellElementRegion const & region ) {
+    region.forElementSubRegions(
+      [&]( ElementSubRegionBase const & elementSubRegion ) {
+      arrayView1d< globalIndex const > const & localToGlobal =
+        elementSubRegion.localToGlobalMap();
+
+      ArrayOfArrays< integer > & regionIndices = m_summaryRegionIndices[region.getName() + "/" + elementSubRegion.getName()];
+      regionIndices.resize( 0 );
+
+      // A cell shared by several regions is summarized in each of them
+      std::vector< integer > cellRegions;
+      for( localIndex k = 0; k < elementSubRegion.size(); ++k )
+      {
+        auto const regions = findRegions( regionCells, localToGlobal[k] );
+        cellRegions.clear();
+        for( auto it = regions.first; it != regions.second; ++it )
+        {
+          cellRegions.push_back( it->second );
+        }
+        regionIndices.appendArray( cellRegions.begin(), cellRegions.end() );
+      }
+    } );
+  } );
+}
+
 void RESQMLWriterInterface::generateSubRepresentations(
   DomainPartition const & domain )
 {
@@ -403,364 +747,889 @@ void RESQMLWriterInterface::generateSubRepresentations(
         } );
       } );
 
-      for( string const & field : m_regularFields )
-      {
-        generateSubRepresentation( elemManager, field );
-      }
-    } );
-  } );
-}
-
-void RESQMLWriterInterface::write( real64 const time,
-                                   integer const GEOS_UNUSED_PARAM( cycle ),
-                                   DomainPartition const & domain )
-{
-  m_property_uuid.clear();
-  auto as_duration =
-    std::chrono::duration_cast< std::chrono::system_clock::duration >(
-      std::chrono::duration< real64 >( time ));
-  // duration seconds from start of epoch
-  std::chrono::system_clock::time_point time_point( as_duration );
-  time_t timestamp = std::chrono::system_clock::to_time_t( time_point );
-
-  m_timeSeries->pushBackTimestamp( timestamp );
+      generateOutputElements( elemManager );
 
-  // loop over all mesh levels and mesh bodies
-  domain.forMeshBodies( [&]( MeshBody const & meshBody ) {
-    meshBody.forMeshLevels( [&]( MeshLevel const & meshLevel ) {
-      if( meshLevel.isShallowCopy())
+      if( !m_summaryFields.empty() )
       {
-        return;
+        checkSummaryFields( elemManager );
+        generateSummaryRegionIndices( elemManager );
       }
 
+      // Fields held by the same elements share their subrepresentation when packing is enabled
+      std::vector< std::pair< string, std::vector< uint64_t > > > generatedSubRepresentations;
+
       for( string const & field : m_regularFields )
       {
-
-        ElementRegionManager const & elemManager = meshLevel.getElemManager();
-
-        // 1. init data buffer for each rank
-        vtkSmartPointer< vtkDataArray > data;
-
-        localIndex numElements = 0;
-        bool first = true;
-        int numDims = 0;
-        elemManager.forElementRegions< CellElementRegion >(
-          [&]( CellElementRegion const & region ) {
-          region.forElementSubRegions(
-            [&]( ElementSubRegionBase const & subRegion ) {
-            if( subRegion.hasWrapper( field ))
-            {
-              numElements += (subRegion.size() - subRegion.getNumberOfGhosts());
-              WrapperBase const & wrapper = subRegion.getWrapperBase( field );
-              if( first )
-              {
-                types::dispatch( types::ListofTypeList< types::StandardArrays >{}, [&]( auto tupleOfTypes )
-                {
-                  using ArrayType = camp::first< decltype(tupleOfTypes) >;
-                  using T = typename ArrayType::ValueType;
-                  auto typedData = vtkAOSDataArrayTemplate< T >::New();
-                  data.TakeReference( typedData );
-                  setComponentMetadata( Wrapper< ArrayType >::cast( wrapper ), typedData );
-                }, wrapper );
-                first = false;
-                numDims = wrapper.numArrayDims();
-              }
-              else
-              {
-                // Sanity check
-                GEOS_ERROR_IF_NE_MSG(
-                  wrapper.numArrayDims(), numDims,
-                  "VTK writer: sanity check failed for "
-                    << field << " (inconsistent array dimensions)" );
-                GEOS_ERROR_IF_NE_MSG(
-                  wrapper.numArrayComp(), data->GetNumberOfComponents(),
-                  "VTK writer: sanity check failed for "
-                    << field << " (inconsistent array sizes)" );
-              }
-            }
-          } );
-        } );
-
-        data->SetNumberOfTuples( numElements );
-        data->SetName( field.c_str());
-       
-
-        //RESQML Property same for all ranks
-        string property = uuid::generate_uuid_v4();
-        MpiWrapper::broadcast( property, 0 );
-
-        if( data->GetDataType() == VTK_FLOAT ||
-            data->GetDataType() == VTK_DOUBLE )
-        {
-          RESQML2_0_1_NS::ContinuousProperty *contProp1 =
-            m_outputRepository->createContinuousProperty(
-              m_subrepresentations[field], property, field, data->GetNumberOfComponents(),
-              gsoap_eml2_3::eml23__IndexableElement::cells,
-              gsoap_resqml2_0_1::resqml20__ResqmlUom::m,
-              gsoap_resqml2_0_1::resqml20__ResqmlPropertyKind::length );
-
-          contProp1->setTimeSeries( m_timeSeries );
-          contProp1->setSingleTimestamp( timestamp );
-
-          m_property_uuid[field] = contProp1;
-        }
-        else
+        if( m_writeOnParentGrid )
         {
-          RESQML2_NS::DiscreteProperty *discProp1 =
-            m_outputRepository->createDiscreteProperty(
-              m_subrepresentations[field], property, field, data->GetNumberOfComponents(),
-              gsoap_eml2_3::eml23__IndexableElement::cells,
-              gsoap_resqml2_0_1::resqml20__ResqmlPropertyKind::length );
-
-          discProp1->setTimeSeries( m_timeSeries );
-          discProp1->setSingleTimestamp( timestamp );
-
-          m_property_uuid[field] = discProp1;
+          generateParentGridOrdering( elemManager, field );
         }
-
-        globalIndex maxCount =
-          m_subrepresentations[field]->getElementCountOfPatch( 0 );
-
-        if( data->GetNumberOfComponents() == 1 ) // scalar data
+        else if( m_packScalarFields )
         {
-          if( data->GetDataType() == VTK_DOUBLE )
-          {
-            m_property_uuid[field]->pushBackHdf5Array1dOfValues(
-              COMMON_NS::AbstractObject::numericalDatatypeEnum::DOUBLE,
-              maxCount );
-          }
-          else if( data->GetDataType() == VTK_FLOAT )
+          std::vector< uint64_t > indices = gatherOwnedGlobalIndices( elemManager, field );
+          auto const shared = std::find_if( generatedSubRepresentations.begin(), generatedSubRepresentations.end(),
+                                            [&indices]( auto const & generated )
           {
-            m_property_uuid[field]->pushBackHdf5Array1dOfValues(
-              COMMON_NS::AbstractObject::numericalDatatypeEnum::FLOAT,
-              maxCount );
-          }
-          else if( data->GetDataType() == VTK_INT )
-          {
-            m_property_uuid[field]->pushBackHdf5Array1dOfValues(
-              COMMON_NS::AbstractObject::numericalDatatypeEnum::INT32,
-              maxCount );
-          }
-          else if( data->GetDataType() == VTK_LONG )
-          {
-            #if VTK_SIZEOF_LONG == 4
-            m_property_uuid[field]->pushBackHdf5Array1dOfValues(
-              COMMON_NS::AbstractObject::numericalDatatypeEnum::INT32,
-              maxCount );
-            #elif VTK_SIZEOF_LONG == 8
-            m_property_uuid[field]->pushBackHdf5Array1dOfValues(
-              COMMON_NS::AbstractObject::numericalDatatypeEnum::INT64,
-              maxCount );
-            #endif
-          }
-          else if( data->GetDataType() == VTK_LONG_LONG )
+            return MpiWrapper::min( generated.second == indices ? 1 : 0, MPI_COMM_GEOS ) == 1;
+          } );
+
+          if( shared != generatedSubRepresentations.end() )
           {
-            m_property_uuid[field]->pushBackHdf5Array1dOfValues(
-              COMMON_NS::AbstractObject::numericalDatatypeEnum::INT64,
-              maxCount );
+            m_subrepresentations.insert( {field, m_subrepresentations.at( shared->first )} );
+            m_countPerProp.insert( {field, m_countPerProp.at( shared->first )} );
           }
           else
           {
-            GEOS_LOG_RANK_0( GEOS_FMT( "data type {} for property {} not handled yet", data->GetDataTypeAsString(), data->GetName()));
+            generateSubRepresentation( elemManager, field );
+            generatedSubRepresentations.emplace_back( field, std::move( indices ) );
           }
         }
-        else // numDims >= 2 vectorial data
+        else
         {
-          if( data->GetDataType() == VTK_DOUBLE )
-          {
-            m_property_uuid[field]->pushBackHdf5Array2dOfValues(
-              COMMON_NS::AbstractObject::numericalDatatypeEnum::DOUBLE,
-              data->GetNumberOfComponents(), maxCount );
-          }
-          else if( data->GetDataType() == VTK_FLOAT )
-          {
-            m_property_uuid[field]->pushBackHdf5Array2dOfValues(
-              COMMON_NS::AbstractObject::numericalDatatypeEnum::FLOAT,
-              data->GetNumberOfComponents(), maxCount );
-          }
-          else if( data->GetDataType() == VTK_INT )
-          {
-            m_property_uuid[field]->pushBackHdf5Array2dOfValues(
-              COMMON_NS::AbstractObject::numericalDatatypeEnum::INT32,
-              data->GetNumberOfComponents(), maxCount );
-          }
-          else if( data->GetDataType() == VTK_LONG )
-          {
-            #if VTK_SIZEOF_LONG == 4
-            m_property_uuid[field]->pushBackHdf5Array2dOfValues(
-              COMMON_NS::AbstractObject::numericalDatatypeEnum::INT32,
-              data->GetNumberOfComponents(), maxCount );
-            #elif VTK_SIZEOF_LONG == 8
-            m_property_uuid[field]->pushBackHdf5Array2dOfValues(
-              COMMON_NS::AbstractObject::numericalDatatypeEnum::INT64,
-              data->GetNumberOfComponents(), maxCount );
-            #endif
-          }
-          else if( data->GetDataType() == VTK_LONG_LONG )
-          {
-            m_property_uuid[field]->pushBackHdf5Array2dOfValues(
-              COMMON_NS::AbstractObject::numericalDatatypeEnum::INT64,
-              data->GetNumberOfComponents(), maxCount );
-          }
-          else
-          {
-            GEOS_LOG_RANK_0( GEOS_FMT( "data type {} for property {} not handled yet", data->GetDataTypeAsString(), data->GetName()));
-          }
+          generateSubRepresentation( elemManager, field );
         }
+      }
+    } );
+  } );
+}
 
-        // 2. Fill data buffer for each rank
-        localIndex offset = 0;
-        elemManager.forElementRegions< CellElementRegion >(
-          [&]( CellElementRegion const & region ) {
-          region.forElementSubRegions(
-            [&]( ElementSubRegionBase const & elementSubRegion ) {
-            if( elementSubRegion.hasWrapper( field ))
-            {
-              arrayView1d< integer const > const & elemGhostRank =
-                elementSubRegion.ghostRank();
-              WrapperBase const & wrapper = elementSubRegion.getWrapperBase( field );
-              types::dispatch( types::ListofTypeList< types::StandardArrays >{}, [&]( auto tupleOfTypes )
-              {
-                using ArrayType = camp::first< decltype(tupleOfTypes) >;
-                using T = typename ArrayType::ValueType;
-                vtkAOSDataArrayTemplate< T > *typedData =
-                  vtkAOSDataArrayTemplate< T >::FastDownCast(
-                    data.GetPointer());
-                auto const sourceArray = Wrapper< ArrayType >::cast( wrapper )
-                                           .reference()
-                                           .toViewConst();
-
-                forAll< parallelHostPolicy >(
-                  sourceArray.size( 0 ),
-                  [sourceArray, offset, typedData,
-                   &elemGhostRank]( localIndex const i ) {
-                  if( elemGhostRank[i] < 0 )
-                  {
-                    LvArray::forValuesInSlice(
-                      sourceArray[i],
-                      [&, compIndex = 0]( T const & value ) mutable {
-                      typedData->SetTypedComponent(
-                        offset + i, compIndex++, value );
-                    } );
-                  }
-                } );
-              }, wrapper );
-              offset += (elementSubRegion.size() - elementSubRegion.getNumberOfGhosts());
-            }
-          } );
-        } );
-
-        // 3. Write data buffer in each rank
-        auto dataSizes = m_countPerProp[field];
-        int const rankOffset =
-          std::accumulate( dataSizes.begin(), std::next( dataSizes.begin(), MpiWrapper::commRank()), 0 );
+vtkSmartPointer< vtkDataArray > RESQMLWriterInterface::gatherField( ElementRegionManager const & elemManager,
+                                                                   string const & field ) const
+{
+  // 1. init data buffer for each rank
+  vtkSmartPointer< vtkDataArray > data;
 
-        if( data->GetNumberOfComponents() == 1 )
+  localIndex numElements = 0;
+  bool first = true;
+  int numDims = 0;
+  elemManager.forElementRegions< CellElementRegion >(
+    [&]( CellElementRegion const & region ) {
+    region.forElementSubRegions(
+      [&]( ElementSubRegionBase const & subRegion ) {
+      if( subRegion.hasWrapper( field ))
+      {
+        numElements += getOutputElements( region, subRegion ).size();
+        WrapperBase const & wrapper = subRegion.getWrapperBase( field );
+        if( first )
         {
-
-          if( data->GetDataType() == VTK_DOUBLE )
-          {
-            m_property_uuid[field]->setValuesOfDoubleHdf5Array1dOfValues(
-              static_cast< double * >(data->GetVoidPointer( 0 )),
-              data->GetNumberOfTuples(),
-              rankOffset );
-          }
-          else if( data->GetDataType() == VTK_FLOAT )
-          {
-            m_property_uuid[field]->setValuesOfFloatHdf5Array1dOfValues(
-              static_cast< float * >(data->GetVoidPointer( 0 )),
-              data->GetNumberOfTuples(),
-              rankOffset );
-          }
-          else if( data->GetDataType() == VTK_INT )
+          types::dispatch( types::ListofTypeList< types::StandardArrays >{}, [&]( auto tupleOfTypes )
           {
-            m_property_uuid[field]->setValuesOfInt32Hdf5Array1dOfValues(
-              static_cast< int * >(data->GetVoidPointer( 0 )),
-              data->GetNumberOfTuples(),
-              rankOffset );
-          }
-          else if( data->GetDataType() == VTK_LONG )
-          {
-            #if VTK_SIZEOF_LONG == 4
-            m_property_uuid[field]->setValuesOfInt32Hdf5Array1dOfValues(
-              static_cast< long * >(data->GetVoidPointer( 0 )),
-              data->GetNumberOfTuples(),
-              rankOffset );
-            #elif VTK_SIZEOF_LONG == 8
-            m_property_uuid[field]->setValuesOfInt64Hdf5Array1dOfValues(
-              static_cast< long * >(data->GetVoidPointer( 0 )),
-              data->GetNumberOfTuples(),
-              rankOffset );
-            #endif
-          }
-          else if( data->GetDataType() == VTK_LONG_LONG )
-          {
-            m_property_uuid[field]->setValuesOfInt64Hdf5Array1dOfValues(
-              static_cast< int64_t * >(data->GetVoidPointer( 0 )),
-              data->GetNumberOfTuples(),
-              rankOffset );
-          }
+            using ArrayType = camp::first< decltype(tupleOfTypes) >;
+            using T = typename ArrayType::ValueType;
+            auto typedData = vtkAOSDataArrayTemplate< T >::New();
+            data.TakeReference( typedData );
+            setComponentMetadata( Wrapper< ArrayType >::cast( wrapper ), typedData );
+          }, wrapper );
+          first = false;
+          numDims = wrapper.numArrayDims();
         }
         else
         {
-          if( data->GetDataType() == VTK_DOUBLE )
-          {
-            m_property_uuid[field]->setValuesOfDoubleHdf5Array2dOfValues(
-              static_cast< double * >(data->GetVoidPointer( 0 )),
-              data->GetNumberOfComponents(),
-              data->GetNumberOfTuples(),
-              0,
-              rankOffset );
-          }
-          else if( data->GetDataType() == VTK_FLOAT )
-          {
-            m_property_uuid[field]->setValuesOfFloatHdf5Array2dOfValues(
-              static_cast< float * >(data->GetVoidPointer( 0 )),
-              data->GetNumberOfComponents(),
-              data->GetNumberOfTuples(),
-              0,
-              rankOffset );
-          }
-          else if( data->GetDataType() == VTK_INT )
+          // Sanity check
+          GEOS_ERROR_IF_NE_MSG(
+            wrapper.numArrayDims(), numDims,
+            "VTK writer: sanity check failed for "
+              << field << " (inconsistent array dimensions)" );
+          GEOS_ERROR_IF_NE_MSG(
+            wrapper.numArrayComp(), data->GetNumberOfComponents(),
+            "VTK writer: sanity check failed for "
+              << field << " (inconsistent array sizes)" );
+        }
+      }
+    } );
+  } );
+
+  data->SetNumberOfTuples( numElements );
+  data->SetName( field.c_str());
+
+  // 2. Fill data buffer for each rank
+  localIndex offset = 0;
+  elemManager.forElementRegions< CellElementRegion >(
+    [&]( CellElementRegion const & region ) {
+    region.forElementSubRegions(
+      [&]( ElementSubRegionBase const & elementSubRegion ) {
+      if( elementSubRegion.hasWrapper( field ))
+      {
+        arrayView1d< localIndex const > const outputElements =
+          getOutputElements( region, elementSubRegion );
+        WrapperBase const & wrapper = elementSubRegion.getWrapperBase( field );
+        types::dispatch( types::ListofTypeList< types::StandardArrays >{}, [&]( auto tupleOfTypes )
+        {
+          using ArrayType = camp::first< decltype(tupleOfTypes) >;
+          using T = typename ArrayType::ValueType;
+          vtkAOSDataArrayTemplate< T > *typedData =
+            vtkAOSDataArrayTemplate< T >::FastDownCast(
+              data.GetPointer());
+          auto const sourceArray = Wrapper< ArrayType >::cast( wrapper )
+                                     .reference()
+                                     .toViewConst();
+
+          forAll< parallelHostPolicy >(
+            outputElements.size(),
+            [sourceArray, offset, typedData,
+             outputElements]( localIndex const i ) {
+            LvArray::forValuesInSlice(
+              sourceArray[outputElements[i]],
+              [&, compIndex = 0]( T const & value ) mutable {
+              typedData->SetTypedComponent(
+                offset + i, compIndex++, value );
+            } );
+          } );
+        }, wrapper );
+        offset += outputElements.size();
+      }
+    } );
+  } );
+
+  return data;
+}
+
+vtkSmartPointer< vtkDataArray > RESQMLWriterInterface::redistributeToParentGrid( string const & field,
+                                                                                vtkDataArray & data ) const
+{
+  ParentGridOrdering const & ordering = m_parentGridOrderings.at( field );
+
+  // Values are exchanged as raw bytes, one tuple at a time
+  localIndex const tupleSize = data.GetDataTypeSize() * data.GetNumberOfComponents();
+  char const * const values = static_cast< char const * >( data.GetVoidPointer( 0 ));
+
+  std::vector< char > sendBuffer( ordering.sendPositions.size() * tupleSize );
+  for( localIndex i = 0; i < ordering.sendPositions.size(); ++i )
+  {
+    std::copy_n( values + i * tupleSize, tupleSize, sendBuffer.data() + ordering.sendPositions[i] * tupleSize );
+  }
+
+  std::vector< char > recvBuffer( ordering.recvPositions.size() * tupleSize );
+  exchangeValues( sendBuffer.data(), ordering.sendCounts.toViewConst(),
+                  recvBuffer.data(), ordering.recvCounts.toViewConst(), tupleSize );
+
+  // Cells of the block without any value for this field are set to zero
+  vtkSmartPointer< vtkDataArray > block;
+  block.TakeReference( data.NewInstance() );
+  block->SetNumberOfComponents( data.GetNumberOfComponents() );
+  block->SetNumberOfTuples( ordering.blockSize );
+  block->SetName( data.GetName() );
+  block->Fill( 0 );
+
+  char * const blockValues = static_cast< char * >( block->GetVoidPointer( 0 ));
+  for( localIndex i = 0; i < ordering.recvPositions.size(); ++i )
+  {
+    std::copy_n( recvBuffer.data() + i * tupleSize, tupleSize, blockValues + ordering.recvPositions[i] * tupleSize );
+  }
+
+  return block;
+}
+
+RESQML2_NS::AbstractRepresentation * RESQMLWriterInterface::prepareValues( string const & field,
+                                                                            vtkSmartPointer< vtkDataArray > & data,
+                                                                            globalIndex & maxCount,
+                                                                            globalIndex & rankOffset ) const
+{
+  // In parent grid mode, each rank writes a contiguous block of the parent grid
+  if( m_writeOnParentGrid )
+  {
+    ParentGridOrdering const & ordering = m_parentGridOrderings.at( field );
+    data = redistributeToParentGrid( field, *data );
+    maxCount = m_parentCellCount;
+    rankOffset = ordering.blockOffset;
+    return m_parent;
+  }
+
+  RESQML2_NS::SubRepresentation * const subrep = m_subrepresentations.at( field );
+  maxCount = subrep->getElementCountOfPatch( 0 );
+
+  auto const & dataSizes = m_countPerProp.at( field );
+  rankOffset =
+    std::accumulate( dataSizes.begin(), std::next( dataSizes.begin(), MpiWrapper::commRank()), 0 );
+  return subrep;
+}
+
+RESQML2_NS::AbstractValuesProperty * RESQMLWriterInterface::createProperty( RESQML2_NS::AbstractRepresentation * supportingRepresentation,
+                                                                            string const & title,
+                                                                            vtkDataArray const & data,
+                                                                            time_t const timestamp )
+{
+  //RESQML Property same for all ranks
+  string property = uuid::generate_uuid_v4();
+  MpiWrapper::broadcast( property, 0 );
+
+  if( data.GetDataType() == VTK_FLOAT ||
+      data.GetDataType() == VTK_DOUBLE )
+  {
+    RESQML2_0_1_NS::ContinuousProperty *contProp1 =
+      m_outputRepository->createContinuousProperty(
+        supportingRepresentation, property, title, data.GetNumberOfComponents(),
+        gsoap_eml2_3::eml23__IndexableElement::cells,
+        gsoap_resqml2_0_1::resqml20__ResqmlUom::m,
+        gsoap_resqml2_0_1::resqml20__ResqmlPropertyKind::length );
+
+    contProp1->setTimeSeries( m_timeSeries );
+    contProp1->setSingleTimestamp( timestamp );
+
+    m_property_uuid[title] = contProp1;
+  }
+  else
+  {
+    RESQML2_NS::DiscreteProperty *discProp1 =
+      m_outputRepository->createDiscreteProperty(
+        supportingRepresentation, property, title, data.GetNumberOfComponents(),
+        gsoap_eml2_3::eml23__IndexableElement::cells,
+        gsoap_resqml2_0_1::resqml20__ResqmlPropertyKind::length );
+
+    discProp1->setTimeSeries( m_timeSeries );
+    discProp1->setSingleTimestamp( timestamp );
+
+    m_property_uuid[title] = discProp1;
+  }
+
+  return m_property_uuid[title];
+}
+
+void RESQMLWriterInterface::writePackedProperties( std::vector< string > const & fields,
+                                                   std::vector< vtkSmartPointer< vtkDataArray > > & data,
+                                                   time_t const timestamp )
+{
+  globalIndex maxCount = 0;
+  globalIndex rankOffset = 0;
+  RESQML2_NS::AbstractRepresentation * supportingRepresentation = nullptr;
+  for( std::size_t f = 0; f < fields.size(); ++f )
+  {
+    supportingRepresentation = prepareValues( fields[f], data[f], maxCount, rankOffset );
+  }
+
+  uint64_t const numFields = fields.size();
+  uint64_t const numValues = LvArray::integerConversion< uint64_t >( data[0]->GetNumberOfTuples() );
+  int const valueSize = data[0]->GetDataTypeSize();
+
+  // Interleave the values: the field index is the fastest dimension
+  std::vector< char > packedValues( numValues * numFields * valueSize );
+  for( uint64_t f = 0; f < numFields; ++f )
+  {
+    char const * const values = static_cast< char const * >( data[f]->GetVoidPointer( 0 ));
+    for( uint64_t i = 0; i < numValues; ++i )
+    {
+      std::copy_n( values + i * valueSize, valueSize, packedValues.data() + ( i * numFields + f ) * valueSize );
+    }
+  }
+
+  string packedDataset = uuid::generate_uuid_v4();
+  MpiWrapper::broadcast( packedDataset, 0 );
+  string const groupName = "/RESQML/" + packedDataset;
+
+  COMMON_NS::AbstractObject::numericalDatatypeEnum datatype = COMMON_NS::AbstractObject::numericalDatatypeEnum::DOUBLE;
+  hid_t nativeType = H5T_NATIVE_DOUBLE;
+  switch( data[0]->GetDataType() )
+  {
+    case VTK_DOUBLE: break;
+    case VTK_FLOAT:
+      datatype = COMMON_NS::AbstractObject::numericalDatatypeEnum::FLOAT;
+      nativeType = H5T_NATIVE_FLOAT;
+      break;
+    case VTK_INT:
+      datatype = COMMON_NS::AbstractObject::numericalDatatypeEnum::INT32;
+      nativeType = H5T_NATIVE_INT;
+      break;
+    case VTK_LONG:
+      #if VTK_SIZEOF_LONG == 4
+      datatype = COMMON_NS::AbstractObject::numericalDatatypeEnum::INT32;
+      #elif VTK_SIZEOF_LONG == 8
+      datatype = COMMON_NS::AbstractObject::numericalDatatypeEnum::INT64;
+      #endif
+      nativeType = H5T_NATIVE_LONG;
+      break;
+    case VTK_LONG_LONG:
+      datatype = COMMON_NS::AbstractObject::numericalDatatypeEnum::INT64;
+      nativeType = H5T_NATIVE_LLONG;
+      break;
+    default:
+      GEOS_ERROR( GEOS_FMT( "data type {} for packed property {} not handled yet", data[0]->GetDataTypeAsString(), fields[0] ) );
+  }
+
+  // One dataset creation and one collective write for all the fields
+  EML2_NS::AbstractHdfProxy * const hdfProxy = m_outputRepository->getDefaultHdfProxy();
+  uint64_t const dimensions[2] = { LvArray::integerConversion< uint64_t >( maxCount ), numFields };
+  uint64_t const counts[2] = { numValues, numFields };
+  uint64_t const offsets[2] = { LvArray::integerConversion< uint64_t >( rankOffset ), 0 };
+  hdfProxy->createArrayNd( groupName, "values", datatype, dimensions, 2 );
+  hdfProxy->writeArrayNdSlab( groupName, "values", datatype, packedValues.data(), counts, offsets, 2 );
+
+  // Each field is exposed as a virtual dataset selecting its column of the packed dataset,
+  // created by writePackedFieldDatasets() once the proxy of their file is closed
+  for( std::size_t f = 0; f < fields.size(); ++f )
+  {
+    string const & field = fields[f];
+    RESQML2_NS::AbstractValuesProperty * const prop = createProperty( supportingRepresentation, field, *data[0], timestamp );
+    string const fieldDataset = "/RESQML/" + prop->getUuid() + "/values_patch0";
+    if( datatype == COMMON_NS::AbstractObject::numericalDatatypeEnum::DOUBLE ||
+        datatype == COMMON_NS::AbstractObject::numericalDatatypeEnum::FLOAT )
+    {
+      prop->pushBackRefToExistingFloatingPointDataset( m_packedFieldsProxy, fieldDataset );
+    }
+    else
+    {
+      prop->pushBackRefToExistingIntegerDataset( m_packedFieldsProxy, fieldDataset, std::numeric_limits< int64_t >::lowest() );
+    }
+    m_packedFieldDatasets.push_back( { fieldDataset, groupName + "/values", f, { dimensions[0], dimensions[1] }, nativeType } );
+  }
+}
+
+void RESQMLWriterInterface::writeProperty( string const & field,
+                                           string const & title,
+                                           vtkDataArray & inputData,
+                                           time_t const timestamp )
+{
+  vtkSmartPointer< vtkDataArray > data = &inputData;
+  globalIndex maxCount = 0;
+  globalIndex rankOffset = 0;
+  RESQML2_NS::AbstractRepresentation * const supportingRepresentation = prepareValues( field, data, maxCount, rankOffset );
+
+  createProperty( supportingRepresentation, title, *data, timestamp );
+
+  RESQML2_NS::AbstractValuesProperty * const prop = m_property_uuid[title];
+
+  if( data->GetNumberOfComponents() == 1 ) // scalar data
+  {
+    if( data->GetDataType() == VTK_DOUBLE )
+    {
+      prop->pushBackHdf5Array1dOfValues(
+        COMMON_NS::AbstractObject::numericalDatatypeEnum::DOUBLE,
+        maxCount );
+    }
+    else if( data->GetDataType() == VTK_FLOAT )
+    {
+      prop->pushBackHdf5Array1dOfValues(
+        COMMON_NS::AbstractObject::numericalDatatypeEnum::FLOAT,
+        maxCount );
+    }
+    else if( data->GetDataType() == VTK_INT )
+    {
+      prop->pushBackHdf5Array1dOfValues(
+        COMMON_NS::AbstractObject::numericalDatatypeEnum::INT32,
+        maxCount );
+    }
+    else if( data->GetDataType() == VTK_LONG )
+    {
+      #if VTK_SIZEOF_LONG == 4
+      prop->pushBackHdf5Array1dOfValues(
+        COMMON_NS::AbstractObject::numericalDatatypeEnum::INT32,
+        maxCount );
+      #elif VTK_SIZEOF_LONG == 8
+      prop->pushBackHdf5Array1dOfValues(
+        COMMON_NS::AbstractObject::numericalDatatypeEnum::INT64,
+        maxCount );
+      #endif
+    }
+    else if( data->GetDataType() == VTK_LONG_LONG )
+    {
+      prop->pushBackHdf5Array1dOfValues(
+        COMMON_NS::AbstractObject::numericalDatatypeEnum::INT64,
+        maxCount );
+    }
+    else
+    {
+      GEOS_LOG_RANK_0( GEOS_FMT( "data type {} for property {} not handled yet", data->GetDataTypeAsString(), data->GetName()));
+    }
+  }
+  else // numDims >= 2 vectorial data
+  {
+    if( data->GetDataType() == VTK_DOUBLE )
+    {
+      prop->pushBackHdf5Array2dOfValues(
+        COMMON_NS::AbstractObject::numericalDatatypeEnum::DOUBLE,
+        data->GetNumberOfComponents(), maxCount );
+    }
+    else if( data->GetDataType() == VTK_FLOAT )
+    {
+      prop->pushBackHdf5Array2dOfValues(
+        COMMON_NS::AbstractObject::numericalDatatypeEnum::FLOAT,
+        data->GetNumberOfComponents(), maxCount );
+    }
+    else if( data->GetDataType() == VTK_INT )
+    {
+      prop->pushBackHdf5Array2dOfValues(
+        COMMON_NS::AbstractObject::numericalDatatypeEnum::INT32,
+        data->GetNumberOfComponents(), maxCount );
+    }
+    else if( data->GetDataType() == VTK_LONG )
+    {
+      #if VTK_SIZEOF_LONG == 4
+      prop->pushBackHdf5Array2dOfValues(
+        COMMON_NS::AbstractObject::numericalDatatypeEnum::INT32,
+        data->GetNumberOfComponents(), maxCount );
+      #elif VTK_SIZEOF_LONG == 8
+      prop->pushBackHdf5Array2dOfValues(
+        COMMON_NS::AbstractObject::numericalDatatypeEnum::INT64,
+        data->GetNumberOfComponents(), maxCount );
+      #endif
+    }
+    else if( data->GetDataType() == VTK_LONG_LONG )
+    {
+      prop->pushBackHdf5Array2dOfValues(
+        COMMON_NS::AbstractObject::numericalDatatypeEnum::INT64,
+        data->GetNumberOfComponents(), maxCount );
+    }
+    else
+    {
+      GEOS_LOG_RANK_0( GEOS_FMT( "data type {} for property {} not handled yet", data->GetDataTypeAsString(), data->GetName()));
+    }
+  }
+
+  // 3. Write data buffer in each rank
+  if( data->GetNumberOfComponents() == 1 )
+  {
+
+    if( data->GetDataType() == VTK_DOUBLE )
+    {
+      prop->setValuesOfDoubleHdf5Array1dOfValues(
+        static_cast< double * >(data->GetVoidPointer( 0 )),
+        data->GetNumberOfTuples(),
+        rankOffset );
+    }
+    else if( data->GetDataType() == VTK_FLOAT )
+    {
+      prop->setValuesOfFloatHdf5Array1dOfValues(
+        static_cast< float * >(data->GetVoidPointer( 0 )),
+        data->GetNumberOfTuples(),
+        rankOffset );
+    }
+    else if( data->GetDataType() == VTK_INT )
+    {
+      prop->setValuesOfInt32Hdf5Array1dOfValues(
+        static_cast< int * >(data->GetVoidPointer( 0 )),
+        data->GetNumberOfTuples(),
+        rankOffset );
+    }
+    else if( data->GetDataType() == VTK_LONG )
+    {
+      #if VTK_SIZEOF_LONG == 4
+      prop->setValuesOfInt32Hdf5Array1dOfValues(
+        static_cast< long * >(data->GetVoidPointer( 0 )),
+        data->GetNumberOfTuples(),
+        rankOffset );
+      #elif VTK_SIZEOF_LONG == 8
+      prop->setValuesOfInt64Hdf5Array1dOfValues(
+        static_cast< long * >(data->GetVoidPointer( 0 )),
+        data->GetNumberOfTuples(),
+        rankOffset );
+      #endif
+    }
+    else if( data->GetDataType() == VTK_LONG_LONG )
+    {
+      prop->setValuesOfInt64Hdf5Array1dOfValues(
+        static_cast< int64_t * >(data->GetVoidPointer( 0 )),
+        data->GetNumberOfTuples(),
+        rankOffset );
+    }
+  }
+  else
+  {
+    if( data->GetDataType() == VTK_DOUBLE )
+    {
+      prop->setValuesOfDoubleHdf5Array2dOfValues(
+        static_cast< double * >(data->GetVoidPointer( 0 )),
+        data->GetNumberOfComponents(),
+        data->GetNumberOfTuples(),
+        0,
+        rankOffset );
+    }
+    else if( data->GetDataType() == VTK_FLOAT )
+    {
+      prop->setValuesOfFloatHdf5Array2dOfValues(
+        static_cast< float * >(data->GetVoidPointer( 0 )),
+        data->GetNumberOfComponents(),
+        data->GetNumberOfTuples(),
+        0,
+        rankOffset );
+    }
+    else if( data->GetDataType() == VTK_INT )
+    {
+      prop->setValuesOfInt32Hdf5Array2dOfValues(
+        static_cast< int * >(data->GetVoidPointer( 0 )),
+        data->GetNumberOfComponents(),
+        data->GetNumberOfTuples(),
+        0,
+        rankOffset );
+    }
+    else if( data->GetDataType() == VTK_LONG )
+    {
+      #if VTK_SIZEOF_LONG == 4
+      prop->setValuesOfInt32Hdf5Array2dOfValues(
+        static_cast< long * >(data->GetVoidPointer( 0 )),
+        data->GetNumberOfComponents(),
+        data->GetNumberOfTuples(),
+        0,
+        rankOffset );
+      #elif VTK_SIZEOF_LONG == 8
+      prop->setValuesOfInt64Hdf5Array2dOfValues(
+        static_cast< long * >(data->GetVoidPointer( 0 )),
+        data->GetNumberOfComponents(),
+        data->GetNumberOfTuples(),
+        0,
+        rankOffset );
+      #endif
+    }
+    else if( data->GetDataType() == VTK_LONG_LONG )
+    {
+      prop->setValuesOfInt64Hdf5Array2dOfValues(
+        static_cast< int64_t * >(data->GetVoidPointer( 0 )),
+        data->GetNumberOfComponents(),
+        data->GetNumberOfTuples(),
+        0,
+        rankOffset );
+    }
+  }
+}
+
+/**
+ * @brief Convert a simulation time into a timestamp
+ * @param time the simulation time, in seconds
+ * @return the timestamp, as a duration in seconds from start of epoch
+ */
+static time_t toTimestamp( real64 const time )
+{
+  auto as_duration =
+    std::chrono::duration_cast< std::chrono::system_clock::duration >(
+      std::chrono::duration< real64 >( time ));
+  // duration seconds from start of epoch
+  std::chrono::system_clock::time_point time_point( as_duration );
+  return std::chrono::system_clock::to_time_t( time_point );
+}
+
+void RESQMLWriterInterface::write( real64 const time,
+                                   integer const GEOS_UNUSED_PARAM( cycle ),
+                                   DomainPartition const & domain )
+{
+  m_property_uuid.clear();
+  time_t const timestamp = toTimestamp( time );
+
+  m_timeSeries->pushBackTimestamp( timestamp );
+
+  // loop over all mesh levels and mesh bodies
+  domain.forMeshBodies( [&]( MeshBody const & meshBody ) {
+    meshBody.forMeshLevels( [&]( MeshLevel const & meshLevel ) {
+      if( meshLevel.isShallowCopy())
+      {
+        return;
+      }
+
+      ElementRegionManager const & elemManager = meshLevel.getElemManager();
+
+      // Same-typed scalar fields sharing their support are packed together.
+      // The supports are identified by UUID so that all the ranks write the packs in the same order.
+      std::map< std::tuple< string, globalIndex, int >, std::vector< string > > packs;
+      std::map< string, vtkSmartPointer< vtkDataArray > > packedData;
+
+      for( string const & field : m_regularFields )
+      {
+        vtkSmartPointer< vtkDataArray > data = gatherField( elemManager, field );
+        if( m_packScalarFields && data->GetNumberOfComponents() == 1 )
+        {
+          if( m_writeOnParentGrid )
           {
-            m_property_uuid[field]->setValuesOfInt32Hdf5Array2dOfValues(
-              static_cast< int * >(data->GetVoidPointer( 0 )),
-              data->GetNumberOfComponents(),
-              data->GetNumberOfTuples(),
-              0,
-              rankOffset );
+            packs[{ m_parent->getUuid(), m_parentCellCount, data->GetDataType() }].push_back( field );
           }
-          else if( data->GetDataType() == VTK_LONG )
+          else
           {
-            #if VTK_SIZEOF_LONG == 4
-            m_property_uuid[field]->setValuesOfInt32Hdf5Array2dOfValues(
-              static_cast< long * >(data->GetVoidPointer( 0 )),
-              data->GetNumberOfComponents(),
-              data->GetNumberOfTuples(),
-              0,
-              rankOffset );
-            #elif VTK_SIZEOF_LONG == 8
-            m_property_uuid[field]->setValuesOfInt64Hdf5Array2dOfValues(
-              static_cast< long * >(data->GetVoidPointer( 0 )),
-              data->GetNumberOfComponents(),
-              data->GetNumberOfTuples(),
-              0,
-              rankOffset );
-            #endif
+            packs[{ m_subrepresentations.at( field )->getUuid(), 0, data->GetDataType() }].push_back( field );
           }
-          else if( data->GetDataType() == VTK_LONG_LONG )
+          packedData[field] = data;
+        }
+        else
+        {
+          writeProperty( field, field, *data, timestamp );
+        }
+      }
+
+      for( auto const & pack : packs )
+      {
+        std::vector< string > const & fields = pack.second;
+        if( fields.size() == 1 )
+        {
+          writeProperty( fields[0], fields[0], *packedData.at( fields[0] ), timestamp );
+        }
+        else
+        {
+          std::vector< vtkSmartPointer< vtkDataArray > > data;
+          for( string const & field : fields )
           {
-            m_property_uuid[field]->setValuesOfInt64Hdf5Array2dOfValues(
-              static_cast< int64_t * >(data->GetVoidPointer( 0 )),
-              data->GetNumberOfComponents(),
-              data->GetNumberOfTuples(),
-              0,
-              rankOffset );
+            data.push_back( packedData.at( field ));
           }
+          writePackedProperties( fields, data, timestamp );
+        }
+      }
+    } );
+  } );
+}
+
+void RESQMLWriterInterface::accumulateReductions( DomainPartition const & domain )
+{
+  domain.forMeshBodies( [&]( MeshBody const & meshBody ) {
+    meshBody.forMeshLevels( [&]( MeshLevel const & meshLevel ) {
+      if( meshLevel.isShallowCopy())
+      {
+        return;
+      }
+
+      ElementRegionManager const & elemManager = meshLevel.getElemManager();
+
+      for( string const & field : m_regularFields )
+      {
+        // The running reductions are updated from the arrays of the field, without gathering them
+        localIndex numElements = 0;
+        int numComponents = 0;
+        elemManager.forElementRegions< CellElementRegion >(
+          [&]( CellElementRegion const & region ) {
+          region.forElementSubRegions(
+            [&]( ElementSubRegionBase const & elementSubRegion ) {
+            if( elementSubRegion.hasWrapper( field ))
+            {
+              numElements += getOutputElements( region, elementSubRegion ).size();
+              numComponents = elementSubRegion.getWrapperBase( field ).numArrayComp();
+            }
+          } );
+        } );
+
+        TemporalReduction & reduction = m_reductions[field];
+        if( reduction.count == 0 )
+        {
+          // The ranks without any subregion holding the field write an empty slab with the same component count
+          reduction.numComponents = MpiWrapper::max( numComponents );
+          localIndex const numValues = numElements * reduction.numComponents;
+          reduction.min.resize( numValues );
+          reduction.max.resize( numValues );
+          reduction.sum.resize( numValues );
+          reduction.min.setValues< serialPolicy >( std::numeric_limits< real64 >::max() );
+          reduction.max.setValues< serialPolicy >( std::numeric_limits< real64 >::lowest() );
+          reduction.sum.zero();
         }
+
+        arrayView1d< real64 > const min = reduction.min.toView();
+        arrayView1d< real64 > const max = reduction.max.toView();
+        arrayView1d< real64 > const sum = reduction.sum.toView();
+        localIndex offset = 0;
+        elemManager.forElementRegions< CellElementRegion >(
+          [&]( CellElementRegion const & region ) {
+          region.forElementSubRegions(
+            [&]( ElementSubRegionBase const & elementSubRegion ) {
+            if( !elementSubRegion.hasWrapper( field ))
+            {
+              return;
+            }
+
+            arrayView1d< localIndex const > const outputElements =
+              getOutputElements( region, elementSubRegion );
+            WrapperBase const & wrapper = elementSubRegion.getWrapperBase( field );
+            types::dispatch( types::ListofTypeList< types::StandardArrays >{}, [&]( auto tupleOfTypes )
+            {
+              using ArrayType = camp::first< decltype(tupleOfTypes) >;
+              using T = typename ArrayType::ValueType;
+              auto const sourceArray = Wrapper< ArrayType >::cast( wrapper )
+                                         .reference()
+                                         .toViewConst();
+
+              forAll< parallelHostPolicy >(
+                outputElements.size(),
+                [=]( localIndex const i ) {
+                LvArray::forValuesInSlice(
+                  sourceArray[outputElements[i]],
+                  [&, k = ( offset + i ) * numComponents]( T const & value ) mutable {
+                  real64 const realValue = static_cast< real64 >( value );
+                  min[k] = std::min( min[k], realValue );
+                  max[k] = std::max( max[k], realValue );
+                  sum[k] += realValue;
+                  ++k;
+                } );
+              } );
+            }, wrapper );
+            offset += outputElements.size();
+          } );
+        } );
+        ++reduction.count;
       }
     } );
   } );
 }
 
+void RESQMLWriterInterface::writeReductions( real64 const time,
+                                             integer const GEOS_UNUSED_PARAM( cycle ),
+                                             DomainPartition const & GEOS_UNUSED_PARAM( domain ) )
+{
+  m_property_uuid.clear();
+  time_t const timestamp = toTimestamp( time );
+
+  m_timeSeries->pushBackTimestamp( timestamp );
+
+  for( auto & [field, reduction] : m_reductions )
+  {
+    // The field is held by no subregion of any rank
+    if( reduction.numComponents == 0 )
+    {
+      continue;
+    }
+
+    for( string const & reductionName : m_temporalReductions )
+    {
+      vtkNew< vtkDoubleArray > data;
+      data->SetNumberOfComponents( reduction.numComponents );
+      data->SetNumberOfTuples( reduction.sum.size() / reduction.numComponents );
+      data->SetName( ( field + "_" + reductionName ).c_str() );
+
+      for( localIndex k = 0; k < reduction.sum.size(); ++k )
+      {
+        real64 value = reduction.sum[k] / reduction.count;
+        if( reductionName == "min" )
+        {
+          value = reduction.min[k];
+        }
+        else if( reductionName == "max" )
+        {
+          value = reduction.max[k];
+        }
+        data->SetValue( k, value );
+      }
+
+      writeProperty( field, field + "_" + reductionName, *data, timestamp );
+    }
+
+    // Start a new reduction window
+    reduction.count = 0;
+  }
+}
+
+void RESQMLWriterInterface::writeSummary( real64 const time,
+                                          DomainPartition const & domain )
+{
+  if( m_summaryRegions.empty() )
+  {
+    return;
+  }
+
+  std::size_t const numFields = m_summaryFields.size();
+  std::size_t const stride = 2 * numFields;
+
+  // (regions x fields x (weight, weighted sum)) of the owned elements
+  std::vector< real64 > sums( m_summaryRegions.size() * stride, 0.0 );
+
+  domain.forMeshBodies( [&]( MeshBody const & meshBody ) {
+    meshBody.forMeshLevels( [&]( MeshLevel const & meshLevel ) {
+      if( meshLevel.isShallowCopy())
+      {
+        return;
+      }
+
+      ElementRegionManager const & elemManager = meshLevel.getElemManager();
+      elemManager.forElementRegions< CellElementRegion >(
+        [&]( CellElementRegion const & region ) {
+        region.forElementSubRegions(
+          [&]( ElementSubRegionBase const & elementSubRegion ) {
+          auto const regionIndices = m_summaryRegionIndices.find( region.getName() + "/" + elementSubRegion.getName() );
+          if( regionIndices == m_summaryRegionIndices.end() )
+          {
+            return;
+          }
+
+          arrayView1d< integer const > const & elemGhostRank = elementSubRegion.ghostRank();
+          arrayView1d< real64 const > const & volume = elementSubRegion.getElementVolume();
+          bool const isWeighted = !m_summaryWeightField.empty() && elementSubRegion.hasWrapper( m_summaryWeightField );
+          arrayView1d< real64 const > const weight = isWeighted
+                                                     ? elementSubRegion.getReference< array1d< real64 > >( m_summaryWeightField ).toViewConst()
+                                                     : arrayView1d< real64 const >();
+
+          for( std::size_t f = 0; f < numFields; ++f )
+          {
+            if( !elementSubRegion.hasWrapper( m_summaryFields[f] ))
+            {
+              continue;
+            }
+
+            arrayView1d< real64 const > const values =
+              elementSubRegion.getReference< array1d< real64 > >( m_summaryFields[f] ).toViewConst();
+
+            for( localIndex k = 0; k < elementSubRegion.size(); ++k )
+            {
+              if( elemGhostRank[k] >= 0 )
+              {
+                continue;
+              }
+              real64 const w = isWeighted ? volume[k] * weight[k] : volume[k];
+              for( integer const r : regionIndices->second[k] )
+              {
+                sums[r * stride + 2 * f] += w;
+                sums[r * stride + 2 * f + 1] += w * values[k];
+              }
+            }
+          }
+        } );
+      } );
+    } );
+  } );
+
+  std::vector< real64 > globalSums( sums.size() );
+  MpiWrapper::allReduce( sums.data(), globalSums.data(), LvArray::integerConversion< int >( sums.size() ), MPI_SUM, MPI_COMM_GEOS );
+
+  std::size_t const numRegions = m_summaryRegions.size();
+
+  // One property per field and statistic, whose patches hold the summaries of the successive timestamps
+  if( m_summaryTimeSeries == nullptr )
+  {
+    string timeSeries = uuid::generate_uuid_v4();
+    MpiWrapper::broadcast( timeSeries, 0 );
+    m_summaryTimeSeries = m_outputRepository->createTimeSeries( timeSeries, "Region summaries time series" );
+
+    // The values of the summaries follow the order of the regions
+    string regionTitles;
+    for( auto const * subrep : m_summaryRegions )
+    {
+      regionTitles += ( regionTitles.empty() ? "" : "," ) + subrep->getTitle();
+    }
+
+    for( std::size_t f = 0; f < numFields; ++f )
+    {
+      for( string const statistic : { "total", "mean" } )
+      {
+        string property = uuid::generate_uuid_v4();
+        MpiWrapper::broadcast( property, 0 );
+
+        RESQML2_0_1_NS::ContinuousProperty * const prop =
+          m_outputRepository->createContinuousProperty(
+            m_parent, property, m_summaryFields[f] + "_" + statistic + "_by_region", 1,
+            gsoap_eml2_3::eml23__IndexableElement::regions,
+            gsoap_resqml2_0_1::resqml20__ResqmlUom::Euc,
+            gsoap_resqml2_0_1::resqml20__ResqmlPropertyKind::continuous );
+        prop->setTimeSeries( m_summaryTimeSeries );
+        prop->pushBackExtraMetadata( "regions", regionTitles );
+        prop->pushBackExtraMetadata( "patches", "one per timestamp of the time series" );
+        m_summaryProperties.push_back( prop );
+      }
+    }
+  }
+  m_summaryTimeSeries->pushBackTimestamp( toTimestamp( time ));
+
+  for( std::size_t f = 0; f < numFields; ++f )
+  {
+    // The totals, then the means
+    for( std::size_t statistic = 0; statistic < 2; ++statistic )
+    {
+      std::vector< double > values( numRegions );
+      for( std::size_t r = 0; r < numRegions; ++r )
+      {
+        real64 const w = globalSums[r * stride + 2 * f];
+        real64 const wv = globalSums[r * stride + 2 * f + 1];
+        values[r] = statistic == 0 ? wv : ( w > 0.0 ? wv / w : 0.0 );
+      }
+
+      RESQML2_NS::AbstractValuesProperty * const prop = m_summaryProperties[2 * f + statistic];
+      prop->pushBackHdf5Array1dOfValues(
+        COMMON_NS::AbstractObject::numericalDatatypeEnum::DOUBLE,
+        numRegions );
+
+      // The summaries are identical on all ranks: only the first one writes them
+      prop->setValuesOfDoubleHdf5Array1dOfValues(
+        values.data(),
+        MpiWrapper::commRank() == 0 ? numRegions : 0,
+        0 );
+    }
+  }
+}
+
 } // namespace geos
@@ -27,6 +27,9 @@
 
 #include <vtkDataArray.h>
 
+#include "hdf5.h"
+
+#include <array>
 #include <map>
 #include <unordered_set>
 namespace geos
@@ -75,6 +78,81 @@ public:
     m_onlyPlotSpecifiedFieldNames = onlyPlotSpecifiedFieldNames;
   }
 
+  /**
+   * @brief Set the flag to write the properties directly on the parent grid, in its global cell order
+   * @param[in] writeOnParentGrid the flag
+   */
+  void setWriteOnParentGrid( integer const writeOnParentGrid )
+  {
+    m_writeOnParentGrid = writeOnParentGrid;
+  }
+
+  /**
+   * @brief Set the number of cells of the parent grid
+   * @param[in] cellCount the number of cells, including the cells which are not simulated
+   */
+  void setParentCellCount( globalIndex const cellCount )
+  {
+    m_parentCellCount = cellCount;
+  }
+
+  /**
+   * @brief Set the flag to pack the same-typed scalar fields sharing a support into a single dataset
+   * @param[in] packScalarFields the flag
+   */
+  void setPackScalarFields( integer const packScalarFields )
+  {
+    m_packScalarFields = packScalarFields;
+  }
+
+  /**
+   * @brief Set the temporal reductions accumulated between two dumps
+   * @param[in] reductions the reductions, among "min", "max" and "mean"
+   */
+  void setTemporalReductions( arrayView1d< string const > const & reductions )
+  {
+    m_temporalReductions.assign( reductions.begin(), reductions.end() );
+  }
+
+  /**
+   * @brief Set the fields aggregated over the regions at each execution
+   * @param[in] fieldNames the scalar real64 fields to aggregate
+   * @param[in] weightFieldName the field weighting the cell volumes, or an empty string to weight by the volume only
+   */
+  void setSummaryFields( arrayView1d< string const > const & fieldNames,
+                         string const & weightFieldName )
+  {
+    m_summaryFields.assign( fieldNames.begin(), fieldNames.end() );
+    m_summaryWeightField = weightFieldName;
+  }
+
+  /**
+   * @brief Set the regions over which the summary fields are aggregated
+   * @param[in] regions the cell subrepresentations of the input repository
+   */
+  void setSummaryRegions( std::vector< RESQML2_NS::SubRepresentation * > const & regions )
+  {
+    m_summaryRegions = regions;
+  }
+
+  /**
+   * @brief Restrict the output to the cells of some regions
+   * @param[in] regions the cell subrepresentations of the input repository, or an empty list to output all the cells
+   */
+  void setOutputRegions( std::vector< RESQML2_NS::SubRepresentation * > const & regions )
+  {
+    m_outputRegions = regions;
+  }
+
+  /**
+   * @brief Restrict the output to the cells centered in a bounding box
+   * @param[in] boundingBox the box (xmin, ymin, zmin, xmax, ymax, zmax), or an empty array to output all the cells
+   */
+  void setOutputBoundingBox( arrayView1d< real64 const > const & boundingBox )
+  {
+    m_outputBoundingBox.assign( boundingBox.begin(), boundingBox.end() );
+  }
+
   /**
    * @brief Set the names of the fields to output
    * @param[in] fieldNames the fields to output
@@ -103,6 +181,37 @@ public:
    */
   void write( real64 time, integer cycle, DomainPartition const & domain );
 
+  /**
+   * @brief Update the running temporal reductions of the fields with their current values
+   * @param[in] domain the computation domain of this rank
+   */
+  void accumulateReductions( DomainPartition const & domain );
+
+  /**
+   * @brief Write the temporal reductions accumulated since the last dump, and reset them
+   * @param[in] time the time step to be written
+   * @param[in] cycle the current cycle of event
+   * @param[in] domain the computation domain of this rank
+   */
+  void writeReductions( real64 time, integer cycle, DomainPartition const & domain );
+
+  /**
+   * @brief Aggregate the summary fields over each region, in one global reduction, and write them
+   * @param[in] time the time step being summarized
+   * @param[in] domain the computation domain of this rank
+   * @details The totals and the means of the fields are weighted by the element volumes,
+   * multiplied by the weight field if any. They are appended as a new patch of one property of the regions
+   * per field and statistic, created at the first call, and the time step is pushed to their time series.
+   * @note This is a collective call.
+   */
+  void writeSummary( real64 time, DomainPartition const & domain );
+
+  /**
+   * @brief Create the virtual datasets exposing the columns of the packed fields
+   * @note This is a collective call, to be made once all the time steps are written.
+   */
+  void writePackedFieldDatasets();
+
   /**
    * @brief Generates the output .epc and .hdf5 files from the data in the output repository
    */
@@ -124,6 +233,106 @@ public:
 
 private:
 
+  /**
+   * @brief Communication plan redistributing the owned values of a field
+   * into contiguous blocks of the parent grid global cell order
+   */
+  struct ParentGridOrdering
+  {
+    /// First parent grid cell written by this rank
+    globalIndex blockOffset = 0;
+
+    /// Number of parent grid cells written by this rank
+    localIndex blockSize = 0;
+
+    /// Position in the send buffer of each owned value, in gathering order
+    array1d< localIndex > sendPositions;
+
+    /// Number of values sent to each rank
+    array1d< int > sendCounts;
+
+    /// Number of values received from each rank
+    array1d< int > recvCounts;
+
+    /// Position in the local block of each received value
+    array1d< localIndex > recvPositions;
+  };
+
+  /**
+   * @brief Virtual dataset selecting the column of a field in a packed dataset
+   */
+  struct PackedFieldDataset
+  {
+    /// Path of the virtual dataset in the packed fields file
+    string path;
+
+    /// Path of the packed dataset in the main file
+    string packedPath;
+
+    /// Column of the field in the packed dataset
+    hsize_t column;
+
+    /// Number of values and number of fields of the packed dataset
+    std::array< hsize_t, 2 > dimensions;
+
+    /// HDF5 native type of the values
+    hid_t nativeType;
+  };
+
+  /**
+   * @brief Running temporal reductions of the owned values of a field
+   */
+  struct TemporalReduction
+  {
+    /// Number of components of the field, agreed over the ranks when the reduction window opens
+    int numComponents = 0;
+
+    /// Number of accumulated steps
+    integer count = 0;
+
+    /// Running minimum, maximum and sum of each owned value
+    array1d< real64 > min;
+    array1d< real64 > max;
+    array1d< real64 > sum;
+  };
+
+  /**
+   * @brief Compute the compact list of the owned elements to output in each subregion
+   * @param[in] elemManager ElementRegion being written
+   */
+  void generateOutputElements( ElementRegionManager const & elemManager );
+
+  /**
+   * @brief Get the owned elements to output of a subregion
+   * @param[in] region the region of the subregion
+   * @param[in] elementSubRegion the subregion
+   * @return the local indices of the elements
+   */
+  arrayView1d< localIndex const > getOutputElements( CellElementRegion const & region,
+                                                     ElementSubRegionBase const & elementSubRegion ) const;
+
+  /**
+   * @brief Check that the summary fields and the weight field are scalar real64 fields of the cells
+   * @param[in] elemManager ElementRegion being summarized
+   * @note This is a collective call, throwing an InputError on all the ranks.
+   */
+  void checkSummaryFields( ElementRegionManager const & elemManager ) const;
+
+  /**
+   * @brief Compute the summary regions of each element of the mesh
+   * @param[in] elemManager ElementRegion being summarized
+   */
+  void generateSummaryRegionIndices( ElementRegionManager const & elemManager );
+
+  /**
+   * @brief Collect the global indices of the owned elements holding a field
+   * @param[in] elemManager ElementRegion being written
+   * @param[in] field field associated to the elements
+   * @return the global indices, in the order used to gather the field values
+   */
+  std::vector< uint64_t > gatherOwnedGlobalIndices( ElementRegionManager const & elemManager,
+                                                    string const & field ) const;
+
   /**
    * @brief Generate a subRepresentation for a field
    * @param[in] elemManager ElementRegion being written
@@ -132,6 +341,82 @@ private:
   void generateSubRepresentation( ElementRegionManager const & elemManager,
                                   string const & field );
 
+  /**
+   * @brief Build the communication plan to write a field on the parent grid
+   * @param[in] elemManager ElementRegion being written
+   * @param[in] field field associated to the elements
+   */
+  void generateParentGridOrdering( ElementRegionManager const & elemManager,
+                                   string const & field );
+
+  /**
+   * @brief Gather the owned values of a field in a contiguous buffer
+   * @param[in] elemManager ElementRegion being written
+   * @param[in] field field associated to the elements
+   * @return the buffer of this rank
+   */
+  vtkSmartPointer< vtkDataArray > gatherField( ElementRegionManager const & elemManager,
+                                               string const & field ) const;
+
+  /**
+   * @brief Redistribute the owned values of a field to the parent grid block of each rank
+   * @param[in] field field associated to the elements
+   * @param[in] data the owned values, in gathering order
+   * @return the values of the parent grid block of this rank
+   */
+  vtkSmartPointer< vtkDataArray > redistributeToParentGrid( string const & field,
+                                                            vtkDataArray & data ) const;
+
+  /**
+   * @brief Select the supporting representation of a field and the part of the dataset written by this rank
+   * @param[in] field field associated to the elements
+   * @param[inout] data the owned values, replaced by the values written by this rank
+   * @param[out] maxCount the number of values of the whole dataset
+   * @param[out] rankOffset the offset of the values of this rank in the dataset
+   * @return the supporting representation of the property
+   */
+  RESQML2_NS::AbstractRepresentation * prepareValues( string const & field,
+                                                      vtkSmartPointer< vtkDataArray > & data,
+                                                      globalIndex & maxCount,
+                                                      globalIndex & rankOffset ) const;
+
+  /**
+   * @brief Create a RESQML property without any values
+   * @param[in] supportingRepresentation the supporting representation of the property
+   * @param[in] title title of the RESQML property
+   * @param[in] data the values, used to select the kind of property
+   * @param[in] timestamp the timestamp of the property
+   * @return the property
+   */
+  RESQML2_NS::AbstractValuesProperty * createProperty( RESQML2_NS::AbstractRepresentation * supportingRepresentation,
+                                                       string const & title,
+                                                       vtkDataArray const & data,
+                                                       time_t timestamp );
+
+  /**
+   * @brief Write several scalar fields of the same type and support in a single (cells x fields) dataset
+   * @param[in] fields the fields to pack
+   * @param[in] data the owned values of each field
+   * @param[in] timestamp the timestamp of the properties
+   * @details Each field is still exposed as its own RESQML property, which references a virtual dataset
+   * selecting its column of the packed dataset.
+   */
+  void writePackedProperties( std::vector< string > const & fields,
+                              std::vector< vtkSmartPointer< vtkDataArray > > & data,
+                              time_t timestamp );
+
+  /**
+   * @brief Create a RESQML property and write its values in parallel
+   * @param[in] field field associated to the elements
+   * @param[in] title title of the RESQML property
+   * @param[in] data the values of this rank
+   * @param[in] timestamp the timestamp of the property
+   */
+  void writeProperty( string const & field,
+                      string const & title,
+                      vtkDataArray & data,
+                      time_t timestamp );
+
 private:
 
   /// Output repository of RESQML data objects
@@ -158,6 +443,57 @@ private:
   /// Keep track of subrepresentation throw the time: field name -> Subrep
   std::map< string, RESQML2_NS::SubRepresentation * > m_subrepresentations;
 
+  /// Flag to write the properties on the parent grid instead of subrepresentations
+  integer m_writeOnParentGrid = 0;
+
+  /// Number of cells of the parent grid, whose global cell order is written in parent grid mode
+  globalIndex m_parentCellCount = 0;
+
+  /// Parent grid communication plan for each field
+  std::map< string, ParentGridOrdering > m_parentGridOrderings;
+
+  /// Flag to pack the same-typed scalar fields sharing a support into a single dataset
+  integer m_packScalarFields = 0;
+
+  /// Hdf proxy of the file holding the virtual datasets of the packed fields
+  EML2_NS::AbstractHdfProxy * m_packedFieldsProxy = nullptr;
+
+  /// Virtual datasets of the packed fields, created by writePackedFieldDatasets()
+  std::vector< PackedFieldDataset > m_packedFieldDatasets;
+
+  /// Temporal reductions dumped instead of the raw values
+  std::vector< string > m_temporalReductions;
+
+  /// Running temporal reductions of each field
+  std::map< string, TemporalReduction > m_reductions;
+
+  /// Regions restricting the output, all the cells are written if empty
+  std::vector< RESQML2_NS::SubRepresentation * > m_outputRegions;
+
+  /// Bounding box (xmin, ymin, zmin, xmax, ymax, zmax) restricting the output, all the cells are written if empty
+  std::vector< real64 > m_outputBoundingBox;
+
+  /// Owned elements to output: "region/subRegion" -> local indices
+  std::map< string, array1d< localIndex > > m_outputElements;
+
+  /// Fields aggregated over the regions
+  std::vector< string > m_summaryFields;
+
+  /// Field weighting the element volumes in the region summaries
+  string m_summaryWeightField;
+
+  /// Regions over which the summary fields are aggregated
+  std::vector< RESQML2_NS::SubRepresentation * > m_summaryRegions;
+
+  /// Summary regions of each element, none if outside of all the regions: "region/subRegion" -> indices
+  std::map< string, ArrayOfArrays< integer > > m_summaryRegionIndices;
+
+  /// Time series of the region summaries
+  EML2_NS::TimeSeries * m_summaryTimeSeries = nullptr;
+
+  /// Total and mean of each summary field over the regions, with one patch per timestamp of the time series
+  std::vector< RESQML2_NS::AbstractValuesProperty * > m_summaryProperties;
+
 };
 
 }
@@ -0,0 +1,449 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 TotalEnergies
+ * Copyright (c) 2019-     GEOSX Contributors
+ * All rights reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+// Source includes
+#include "RESQMLHdf5Utilities.hpp"
+#include "common/initializeEnvironment.hpp"
+
+// TPL includes
+#include <gtest/gtest.h>
+
+#include "fesapi/common/DataObjectRepository.h"
+#include "fesapi/common/EpcDocument.h"
+#include "fesapi/eml2/AbstractHdfProxy.h"
+#include "fesapi/resqml2/ContinuousProperty.h"
+#include "fesapi/resqml2/DiscreteProperty.h"
+
+#include "hdf5.h"
+
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+using namespace geos;
+
+namespace
+{
+
+/**
+ * @brief Write one-dimensional datasets of doubles in a new HDF5 file of the temporary directory
+ * @param[in] fileName The name of the file
+ * @param[in] datasets The names and the values of the datasets, written in this order
+ * @param[in] datasetProperties The creation properties of the datasets
+ * @param[in] fileProperties The creation properties of the file
+ * @return the path of the file
+ */
+std::string writeDatasets( std::string const & fileName,
+                           std::vector< std::pair< std::string, std::vector< double > > > const & datasets,
+                           hid_t const datasetProperties = H5P_DEFAULT,
+                           hid_t const fileProperties = H5P_DEFAULT )
+{
+  std::string const filePath = ( std::filesystem::temp_directory_path() / fileName ).string();
+  hid_t const file = H5Fcreate( filePath.c_str(), H5F_ACC_TRUNC, fileProperties, H5P_DEFAULT );
+  EXPECT_GE( file, 0 );
+
+  for( auto const & [name, values] : datasets )
+  {
+    hsize_t const dimensions[1] = { values.size() };
+    hid_t const space = H5Screate_simple( 1, dimensions, nullptr );
+    hid_t const dataset = H5Dcreate2( file, name.c_str(), H5T_NATIVE_DOUBLE, space, H5P_DEFAULT, datasetProperties, H5P_DEFAULT );
+    EXPECT_GE( dataset, 0 );
+    EXPECT_GE( H5Dwrite( dataset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, values.data()), 0 );
+    H5Dclose( dataset );
+    H5Sclose( space );
+  }
+
+  H5Fclose( file );
+  return filePath;
+}
+
+/**
+ * @brief Get the position of the values of a dataset in its file
+ * @param[in] location The location of the dataset
+ * @return the offset of the values from the beginning of the file, including the user block
+ */
+haddr_t getDatasetFileOffset( Hdf5DatasetLocation const & location )
+{
+  hid_t const file = H5Fopen( location.filePath.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT );
+  hid_t const fcpl = H5Fget_create_plist( file );
+  hsize_t userBlockSize = 0;
+  H5Pget_userblock( fcpl, &userBlockSize );
+  H5Pclose( fcpl );
+  hid_t const dataset = H5Dopen( file, location.datasetPath.c_str(), H5P_DEFAULT );
+  haddr_t const offset = H5Dget_offset( dataset );
+  H5Dclose( dataset );
+  H5Fclose( file );
+  return offset + userBlockSize;
+}
+
+/**
+ * @brief Write a chunked dataset of doubles compressed with shuffle and deflate, leaving its last chunks unwritten
+ * @param[in] fileName The name of the file
+ * @param[in] values The written values, at the beginning of the dataset
+ * @param[in] datasetSize The number of values of the dataset, larger than the number of written values
+ * @param[in] chunkSize The number of values of a chunk
+ * @param[in] fillValue The value of the unwritten values
+ * @return the location of the dataset
+ */
+Hdf5DatasetLocation writeDeflatedDataset( std::string const & fileName,
+                                          std::vector< double > const & values,
+                                          hsize_t const datasetSize,
+                                          hsize_t const chunkSize,
+                                          double const fillValue )
+{
+  Hdf5DatasetLocation location;
+  location.filePath = ( std::filesystem::temp_directory_path() / fileName ).string();
+  location.datasetPath = "/values";
+
+  hid_t const file = H5Fcreate( location.filePath.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT );
+  hid_t const datasetProperties = H5Pcreate( H5P_DATASET_CREATE );
+  H5Pset_chunk( datasetProperties, 1, &chunkSize );
+  H5Pset_shuffle( datasetProperties );
+  H5Pset_deflate( datasetProperties, 5 );
+  H5Pset_fill_value( datasetProperties, H5T_NATIVE_DOUBLE, &fillValue );
+
+  hid_t const space = H5Screate_simple( 1, &datasetSize, nullptr );
+  hid_t const dataset = H5Dcreate2( file, "values", H5T_NATIVE_DOUBLE, space, H5P_DEFAULT, datasetProperties, H5P_DEFAULT );
+  hsize_t const start = 0;
+  hsize_t const writtenCount = values.size();
+  H5Sselect_hyperslab( space, H5S_SELECT_SET, &start, nullptr, &writtenCount, nullptr );
+  hid_t const memorySpace = H5Screate_simple( 1, &writtenCount, nullptr );
+  EXPECT_GE( H5Dwrite( dataset, H5T_NATIVE_DOUBLE, memorySpace, space, H5P_DEFAULT, values.data()), 0 );
+
+  H5Sclose( memorySpace );
+  H5Dclose( dataset );
+  H5Sclose( space );
+  H5Pclose( datasetProperties );
+  H5Fclose( file );
+  return location;
+}
+
+/**
+ * @brief Read all the values of a dataset with HDF5
+ * @param[in] location The location of the dataset
+ * @param[in] nativeType The HDF5 native type of the values
+ * @param[out] values The values, allocated by the caller
+ */
+void readHdf5Dataset( Hdf5DatasetLocation const & location, hid_t const nativeType, void * const values )
+{
+  hid_t const file = H5Fopen( location.filePath.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT );
+  hid_t const dataset = H5Dopen( file, location.datasetPath.c_str(), H5P_DEFAULT );
+  EXPECT_GE( H5Dread( dataset, nativeType, H5S_ALL, H5S_ALL, H5P_DEFAULT, values ), 0 );
+  H5Dclose( dataset );
+  H5Fclose( file );
+}
+
+/**
+ * @brief Values of a test dataset
+ * @param[in] count The number of values
+ * @return the values
+ */
+std::vector< double > createValues( std::size_t const count )
+{
+  std::vector< double > values( count );
+  for( std::size_t i = 0; i < count; ++i )
+  {
+    values[i] = 0.5 * static_cast< double >( i ) - 3.0;
+  }
+  return values;
+}
+
+}
+
+TEST( RESQMLHdf5Utilities, mapContiguousDataset )
+{
+  std::vector< double > const values = createValues( 1000 );
+  Hdf5DatasetLocation location;
+  location.filePath = writeDatasets( "testMapContiguousDataset.h5", { { "values", values } } );
+  location.datasetPath = "/values";
+
+  hsize_t count = 0;
+  double * const mappedValues = static_cast< double * >( mapHdf5Dataset( location, H5T_NATIVE_DOUBLE, count ));
+  ASSERT_NE( mappedValues, nullptr );
+  ASSERT_EQ( count, values.size());
+  for( std::size_t i = 0; i < values.size(); ++i )
+  {
+    EXPECT_EQ( mappedValues[i], values[i] ) << "value " << i;
+  }
+
+  // The mapping is private: modifying the values does not modify the file
+  mappedValues[0] = 42.0;
+  unmapHdf5Dataset( mappedValues );
+  double * const remappedValues = static_cast< double * >( mapHdf5Dataset( location, H5T_NATIVE_DOUBLE, count ));
+  ASSERT_NE( remappedValues, nullptr );
+  EXPECT_EQ( remappedValues[0], values[0] );
+  unmapHdf5Dataset( remappedValues );
+
+  // The values stored with another type are not mapped
+  EXPECT_EQ( mapHdf5Dataset( location, H5T_NATIVE_INT, count ), nullptr );
+  EXPECT_EQ( count, 0 );
+
+  // Neither is a missing dataset
+  location.datasetPath = "/missing";
+  EXPECT_EQ( mapHdf5Dataset( location, H5T_NATIVE_DOUBLE, count ), nullptr );
+}
+
+TEST( RESQMLHdf5Utilities, mapDatasetAfterUserBlock )
+{
+  // The values are shifted by the user block at the beginning of the file
+  hid_t const fileProperties = H5Pcreate( H5P_FILE_CREATE );
+  H5Pset_userblock( fileProperties, 512 );
+  std::vector< double > const values = createValues( 100 );
+  Hdf5DatasetLocation location;
+  location.filePath = writeDatasets( "testMapDatasetAfterUserBlock.h5", { { "values", values } }, H5P_DEFAULT, fileProperties );
+  location.datasetPath = "/values";
+  H5Pclose( fileProperties );
+
+  hsize_t count = 0;
+  double * const mappedValues = static_cast< double * >( mapHdf5Dataset( location, H5T_NATIVE_DOUBLE, count ));
+  ASSERT_NE( mappedValues, nullptr );
+  ASSERT_EQ( count, values.size());
+  for( std::size_t i = 0; i < values.size(); ++i )
+  {
+    EXPECT_EQ( mappedValues[i], values[i] ) << "value " << i;
+  }
+  unmapHdf5Dataset( mappedValues );
+}
+
+TEST( RESQMLHdf5Utilities, mapMisalignedDataset )
+{
+  // The raw data of the datasets follow each other, so that the values are not aligned after an odd sized dataset
+  std::vector< double > const values = createValues( 100 );
+  Hdf5DatasetLocation location;
+  location.filePath = writeDatasets( "testMapMisalignedDataset.h5", { { "padding", { 1.0 } }, { "values", values } } );
+  location.datasetPath = "/values";
+
+  hid_t const file = H5Fopen( location.filePath.c_str(), H5F_ACC_RDWR, H5P_DEFAULT );
+  hid_t const space = H5Screate( H5S_SCALAR );
+  hid_t const padding = H5Dcreate2( file, "bytePadding", H5T_NATIVE_CHAR, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT );
+  char const byte = 1;
+  H5Dwrite( padding, H5T_NATIVE_CHAR, H5S_ALL, H5S_ALL, H5P_DEFAULT, &byte );
+  H5Dclose( padding );
+  hsize_t const dimensions[1] = { values.size() };
+  hid_t const datasetSpace = H5Screate_simple( 1, dimensions, nullptr );
+  hid_t const dataset = H5Dcreate2( file, "misalignedValues", H5T_NATIVE_DOUBLE, datasetSpace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT );
+  H5Dwrite( dataset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, values.data());
+  H5Dclose( dataset );
+  H5Sclose( datasetSpace );
+  H5Sclose( space );
+  H5Fclose( file );
+
+  // The values are either mapped where they are aligned, or left to be read otherwise
+  for( std::string const datasetPath : { "/values", "/misalignedValues" } )
+  {
+    location.datasetPath = datasetPath;
+    hsize_t count = 0;
+    double * const mappedValues = static_cast< double * >( mapHdf5Dataset( location, H5T_NATIVE_DOUBLE, count ));
+    if( getDatasetFileOffset( location ) % sizeof( double ) != 0 )
+    {
+      EXPECT_EQ( mappedValues, nullptr ) << datasetPath;
+      continue;
+    }
+    ASSERT_NE( mappedValues, nullptr ) << datasetPath;
+    ASSERT_EQ( count, values.size());
+    for( std::size_t i = 0; i < values.size(); ++i )
+    {
+      EXPECT_EQ( mappedValues[i], values[i] ) << datasetPath << ", value " << i;
+    }
+    unmapHdf5Dataset( mappedValues );
+  }
+}
+
+TEST( RESQMLHdf5Utilities, chunkedDatasetIsNotMapped )
+{
+  hid_t const datasetProperties = H5Pcreate( H5P_DATASET_CREATE );
+  hsize_t const chunkDimensions[1] = { 64 };
+  H5Pset_chunk( datasetProperties, 1, chunkDimensions );
+  Hdf5DatasetLocation location;
+  location.filePath = writeDatasets( "testChunkedDatasetIsNotMapped.h5", { { "values", createValues( 100 ) } }, datasetProperties );
+  location.datasetPath = "/values";
+  H5Pclose( datasetProperties );
+
+  hsize_t count = 0;
+  EXPECT_EQ( mapHdf5Dataset( location, H5T_NATIVE_DOUBLE, count ), nullptr );
+  EXPECT_EQ( count, 0 );
+}
+
+TEST( RESQMLHdf5Utilities, readDeflatedDataset )
+{
+  if( H5Zfilter_avail( H5Z_FILTER_DEFLATE ) <= 0 )
+  {
+    GTEST_SKIP() << "HDF5 is built without deflate";
+  }
+
+  // The last written chunk is partially written, the chunks after it are not stored
+  std::vector< double > const writtenValues = createValues( 1000 );
+  hsize_t const datasetSize = 1200;
+  double const fillValue = -1.5;
+  Hdf5DatasetLocation const location = writeDeflatedDataset( "testReadDeflatedDataset.h5", writtenValues, datasetSize, 64, fillValue );
+
+  std::vector< double > expectedValues( datasetSize );
+  readHdf5Dataset( location, H5T_NATIVE_DOUBLE, expectedValues.data());
+  EXPECT_EQ( expectedValues[datasetSize - 1], fillValue );
+
+  std::vector< double > values( datasetSize );
+  ASSERT_TRUE( readDeflatedHdf5Dataset( location, H5T_NATIVE_DOUBLE, values.data(), datasetSize ));
+  for( hsize_t i = 0; i < datasetSize; ++i )
+  {
+    EXPECT_EQ( values[i], expectedValues[i] ) << "value " << i;
+  }
+
+  // The values stored with another type or with another count must be read otherwise
+  std::vector< int > intValues( datasetSize );
+  EXPECT_FALSE( readDeflatedHdf5Dataset( location, H5T_NATIVE_INT, intValues.data(), datasetSize ));
+  EXPECT_FALSE( readDeflatedHdf5Dataset( location, H5T_NATIVE_DOUBLE, values.data(), writtenValues.size()));
+}
+
+TEST( RESQMLHdf5Utilities, readDeflatedDatasetFallsBack )
+{
+  if( H5Zfilter_avail( H5Z_FILTER_DEFLATE ) <= 0 )
+  {
+    GTEST_SKIP() << "HDF5 is built without deflate";
+  }
+
+  std::vector< double > const writtenValues = createValues( 256 );
+  std::vector< double > values( writtenValues.size());
+
+  // A contiguous dataset is not inflated
+  Hdf5DatasetLocation location;
+  location.filePath = writeDatasets( "testReadDeflatedContiguousDataset.h5", { { "values", writtenValues } } );
+  location.datasetPath = "/values";
+  EXPECT_FALSE( readDeflatedHdf5Dataset( location, H5T_NATIVE_DOUBLE, values.data(), values.size()));
+
+  // Neither is a dataset using another filter
+  hid_t const datasetProperties = H5Pcreate( H5P_DATASET_CREATE );
+  hsize_t const chunkSize = 64;
+  H5Pset_chunk( datasetProperties, 1, &chunkSize );
+  H5Pset_deflate( datasetProperties, 5 );
+  H5Pset_fletcher32( datasetProperties );
+  location.filePath = writeDatasets( "testReadChecksummedDataset.h5", { { "values", writtenValues } }, datasetProperties );
+  H5Pclose( datasetProperties );
+  EXPECT_FALSE( readDeflatedHdf5Dataset( location, H5T_NATIVE_DOUBLE, values.data(), values.size()));
+
+  // A chunk which cannot be inflated fails the whole read
+  location = writeDeflatedDataset( "testReadCorruptedDataset.h5", writtenValues, writtenValues.size(), chunkSize, 0.0 );
+  hid_t const file = H5Fopen( location.filePath.c_str(), H5F_ACC_RDWR, H5P_DEFAULT );
+  hid_t const dataset = H5Dopen( file, location.datasetPath.c_str(), H5P_DEFAULT );
+  std::vector< unsigned char > garbage( 100 );
+  std::memset( garbage.data(), 0xAB, garbage.size());
+  hsize_t const chunkOffset = chunkSize;
+  EXPECT_GE( H5Dwrite_chunk( dataset, H5P_DEFAULT, 0, &chunkOffset, garbage.size(), garbage.data()), 0 );
+  H5Dclose( dataset );
+  H5Fclose( file );
+  EXPECT_FALSE( readDeflatedHdf5Dataset( location, H5T_NATIVE_DOUBLE, values.data(), values.size()));
+}
+
+TEST( RESQMLHdf5Utilities, readDeflatedPropertiesMatchFesapi )
+{
+  if( H5Zfilter_avail( H5Z_FILTER_DEFLATE ) <= 0 )
+  {
+    GTEST_SKIP() << "HDF5 is built without deflate";
+  }
+
+  COMMON_NS::DataObjectRepository repository;
+  COMMON_NS::EpcDocument package( std::string( RESQML_TEST_DATA_DIR ) + "/testingPackageCpp.epc" );
+  package.deserializeInto( repository );
+  package.close();
+
+  // The values of the package are copied in a compressed file, as written by the RESQML output
+  EML2_NS::AbstractHdfProxy * const hdfProxy =
+    repository.createHdfProxy( "", "Deflated HDF proxy", std::filesystem::temp_directory_path().string(), "testReadDeflatedProperties.h5",
+                               COMMON_NS::DataObjectRepository::openingMode::OVERWRITE );
+  hdfProxy->setCompressionLevel( 5 );
+
+  std::size_t propertyCount = 0;
+  for( auto * property : repository.getDataObjects< RESQML2_NS::ContinuousProperty >())
+  {
+    if( property->getElementCountPerValue() != 1 )
+    {
+      continue;
+    }
+    SCOPED_TRACE( property->getUuid());
+
+    uint64_t const valueCount = property->getValuesCountOfPatch( 0 );
+    std::vector< double > expectedValues( valueCount );
+    property->getDoubleValuesOfPatch( 0, expectedValues.data());
+
+    // The datasets of the package itself are compared when they are deflated
+    Hdf5DatasetLocation location;
+    std::vector< double > values( valueCount );
+    if( locatePropertyValues( property, location ) && readDeflatedHdf5Dataset( location, H5T_NATIVE_DOUBLE, values.data(), valueCount ))
+    {
+      for( uint64_t i = 0; i < valueCount; ++i )
+      {
+        EXPECT_EQ( std::isnan( values[i] ), std::isnan( expectedValues[i] )) << "value " << i;
+        if( !std::isnan( expectedValues[i] ))
+        {
+          EXPECT_EQ( values[i], expectedValues[i] ) << "value " << i;
+        }
+      }
+    }
+
+    RESQML2_NS::ContinuousProperty * const deflatedProperty =
+      repository.createContinuousProperty( property->getRepresentation(), "", property->getTitle() + " deflated", 1,
+                                           property->getAttachmentKind(), gsoap_resqml2_0_1::resqml20__ResqmlUom::Euc,
+                                           gsoap_resqml2_0_1::resqml20__ResqmlPropertyKind::continuous );
+    deflatedProperty->pushBackDoubleHdf5Array1dOfValues( expectedValues.data(), valueCount, hdfProxy );
+    ++propertyCount;
+
+    ASSERT_TRUE( locatePropertyValues( deflatedProperty, location ));
+    std::fill( values.begin(), values.end(), 0.0 );
+    ASSERT_TRUE( readDeflatedHdf5Dataset( location, H5T_NATIVE_DOUBLE, values.data(), valueCount ));
+    for( uint64_t i = 0; i < valueCount; ++i )
+    {
+      EXPECT_EQ( std::isnan( values[i] ), std::isnan( expectedValues[i] )) << "value " << i;
+      if( !std::isnan( expectedValues[i] ))
+      {
+        EXPECT_EQ( values[i], expectedValues[i] ) << "value " << i;
+      }
+    }
+  }
+  EXPECT_GT( propertyCount, 0 );
+
+  for( auto * property : repository.getDataObjects< RESQML2_NS::DiscreteProperty >())
+  {
+    if( property->getElementCountPerValue() != 1 )
+    {
+      continue;
+    }
+    SCOPED_TRACE( property->getUuid());
+
+    uint64_t const valueCount = property->getValuesCountOfPatch( 0 );
+    std::vector< int > expectedValues( valueCount );
+    property->getInt32ValuesOfPatch( 0, expectedValues.data());
+
+    RESQML2_NS::DiscreteProperty * const deflatedProperty =
+      repository.createDiscreteProperty( property->getRepresentation(), "", property->getTitle() + " deflated", 1,
+                                         property->getAttachmentKind(), gsoap_resqml2_0_1::resqml20__ResqmlPropertyKind::discrete );
+    deflatedProperty->pushBackInt32Hdf5Array1dOfValues( expectedValues.data(), valueCount, hdfProxy, -1 );
+
+    Hdf5DatasetLocation location;
+    ASSERT_TRUE( locatePropertyValues( deflatedProperty, location ));
+    std::vector< int > values( valueCount );
+    ASSERT_TRUE( readDeflatedHdf5Dataset( location, H5T_NATIVE_INT, values.data(), valueCount ));
+    EXPECT_EQ( values, expectedValues );
+  }
+
+  hdfProxy->close();
+}
+
+int main( int argc, char * * argv )
+{
+  ::testing::InitGoogleTest( &argc, argv );
+  geos::setupEnvironment( argc, argv );
+  int const result = RUN_ALL_TESTS();
+  geos::cleanupEnvironment();
+  return result;
+}
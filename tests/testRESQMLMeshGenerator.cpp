@@ -0,0 +1,165 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 TotalEnergies
+ * Copyright (c) 2019-     GEOSX Contributors
+ * All rights reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+// Source includes
+#include "common/MpiWrapper.hpp"
+#include "mainInterface/GeosxState.hpp"
+#include "mainInterface/initialization.hpp"
+#include "mainInterface/ProblemManager.hpp"
+#include "mesh/CellElementSubRegion.hpp"
+#include "mesh/DomainPartition.hpp"
+
+// TPL includes
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+using namespace geos;
+
+namespace
+{
+
+CommandLineOptions g_commandLineOptions;
+
+/// UUID of the IJK grid of the test package
+constexpr char const * gridUuid = "e96c2bde-e3ae-4d51-b078-a8e57fb1e667";
+
+/**
+ * @brief Build an input deck loading the IJK grid of the test package, with a partition cache
+ * @param[in] cacheDirectory The directory of the partition cache
+ * @return the input deck
+ */
+string createInputDeck( string const & cacheDirectory )
+{
+  return GEOS_FMT( R"xml(
+<Problem>
+  <ExternalDataRepository>
+    <EpcDocumentRepository name="repository" files="{{ {}/testingPackageCpp.epc }}"/>
+  </ExternalDataRepository>
+  <Mesh>
+    <RESQMLMesh name="mesh" repositoryName="repository" uuid="{}" compactInactiveCells="1" partitionCacheDirectory="{}"/>
+  </Mesh>
+  <Events maxTime="1.0"/>
+  <ElementRegions>
+    <CellElementRegion name="reservoir" cellBlocks="{{ * }}" materialList="{{ }}"/>
+  </ElementRegions>
+</Problem>)xml", RESQML_TEST_DATA_DIR, gridUuid, cacheDirectory );
+}
+
+/**
+ * @brief Set up the problem of an input deck
+ * @param[in] inputDeck The input deck
+ * @return the sorted global ids of the cells owned by the current rank
+ */
+std::vector< globalIndex > getOwnedCells( string const & inputDeck )
+{
+  GeosxState state( std::make_unique< CommandLineOptions >( g_commandLineOptions ) );
+  ProblemManager & problemManager = state.getProblemManager();
+  problemManager.parseInputString( inputDeck );
+  problemManager.problemSetup();
+
+  std::vector< globalIndex > ownedCells;
+  ElementRegionManager & elemManager = problemManager.getDomainPartition().getMeshBody( 0 ).getBaseDiscretization().getElemManager();
+  elemManager.forElementSubRegions< CellElementSubRegion >( [&]( CellElementSubRegion const & subRegion )
+  {
+    arrayView1d< integer const > const ghostRank = subRegion.ghostRank();
+    arrayView1d< globalIndex const > const localToGlobal = subRegion.localToGlobalMap();
+    for( localIndex k = 0; k < subRegion.size(); ++k )
+    {
+      if( ghostRank[k] < 0 )
+      {
+        ownedCells.push_back( localToGlobal[k] );
+      }
+    }
+  } );
+  std::sort( ownedCells.begin(), ownedCells.end());
+  return ownedCells;
+}
+
+}
+
+TEST( RESQMLMeshGenerator, partitionCache )
+{
+  int const rank = MpiWrapper::commRank();
+  int const rankCount = MpiWrapper::commSize();
+  if( rankCount < 2 )
+  {
+    GTEST_SKIP() << "The partition is only cached when the mesh is distributed";
+  }
+
+  std::filesystem::path const cacheDirectory = std::filesystem::temp_directory_path() / "testRESQMLPartitionCache";
+  if( rank == 0 )
+  {
+    std::filesystem::remove_all( cacheDirectory );
+    std::filesystem::create_directories( cacheDirectory );
+  }
+  MpiWrapper::barrier();
+
+  // The first run partitions the grid and caches the rank of each cell
+  string const inputDeck = createInputDeck( cacheDirectory.string() );
+  std::vector< globalIndex > const ownedCells = getOwnedCells( inputDeck );
+  std::filesystem::path const cachePath = cacheDirectory / GEOS_FMT( "{}_{}.partition", gridUuid, rankCount );
+  ASSERT_TRUE( std::filesystem::exists( cachePath ));
+  EXPECT_FALSE( ownedCells.empty());
+
+  // The next run gives each rank the same cells
+  EXPECT_EQ( getOwnedCells( inputDeck ), ownedCells );
+
+  // The cached ranks are followed as they are: shifting them moves the cells of each rank to the next one
+  MpiWrapper::barrier();
+  if( rank == 0 )
+  {
+    string header;
+    std::vector< int > partitions;
+    {
+      std::ifstream file( cachePath, std::ios::binary );
+      std::getline( file, header );
+      int partition;
+      while( file.read( reinterpret_cast< char * >( &partition ), sizeof( int )))
+      {
+        partitions.push_back( ( partition + 1 ) % rankCount );
+      }
+    }
+    std::ofstream file( cachePath, std::ios::binary | std::ios::trunc );
+    file << header << '\n';
+    file.write( reinterpret_cast< char const * >( partitions.data()), partitions.size() * sizeof( int ));
+  }
+  MpiWrapper::barrier();
+
+  std::vector< globalIndex > const shiftedCells = getOwnedCells( inputDeck );
+
+  // The cells of the previous rank of the first run
+  int const previousRank = ( rank + rankCount - 1 ) % rankCount;
+  int const nextRank = ( rank + 1 ) % rankCount;
+  int ownedCount = LvArray::integerConversion< int >( ownedCells.size());
+  int previousCount = 0;
+  MPI_Sendrecv( &ownedCount, 1, MPI_INT, nextRank, 0, &previousCount, 1, MPI_INT, previousRank, 0, MPI_COMM_GEOS, MPI_STATUS_IGNORE );
+  std::vector< globalIndex > previousCells( previousCount );
+  MPI_Sendrecv( ownedCells.data(), ownedCount, MPI_LONG_LONG, nextRank, 1,
+                previousCells.data(), previousCount, MPI_LONG_LONG, previousRank, 1, MPI_COMM_GEOS, MPI_STATUS_IGNORE );
+  EXPECT_EQ( shiftedCells, previousCells );
+}
+
+int main( int argc, char * * argv )
+{
+  ::testing::InitGoogleTest( &argc, argv );
+  g_commandLineOptions = *geos::basicSetup( argc, argv );
+  int const result = RUN_ALL_TESTS();
+  geos::basicCleanup();
+  return result;
+}
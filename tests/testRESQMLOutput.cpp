@@ -0,0 +1,655 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 TotalEnergies
+ * Copyright (c) 2019-     GEOSX Contributors
+ * All rights reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+// Source includes
+#include "RESQMLOutput.hpp"
+#include "mainInterface/GeosxState.hpp"
+#include "mainInterface/initialization.hpp"
+#include "mainInterface/ProblemManager.hpp"
+#include "mesh/CellElementSubRegion.hpp"
+#include "mesh/DomainPartition.hpp"
+
+// TPL includes
+#include <gtest/gtest.h>
+
+#include "fesapi/common/DataObjectRepository.h"
+#include "fesapi/common/EpcDocument.h"
+#include "fesapi/eml2/AbstractHdfProxy.h"
+#include "fesapi/resqml2/AbstractIjkGridRepresentation.h"
+#include "fesapi/resqml2/ContinuousProperty.h"
+#include "fesapi/resqml2/SubRepresentation.h"
+
+#include "hdf5.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+using namespace geos;
+
+namespace
+{
+
+CommandLineOptions g_commandLineOptions;
+
+/// UUID of the IJK grid of the test package
+constexpr char const * gridUuid = "e96c2bde-e3ae-4d51-b078-a8e57fb1e667";
+
+/// Number of cells of the IJK grid of the test package, including its cells without geometry
+constexpr uint64_t gridCellCount = 24;
+
+/// Name of the copy of the test package with the regions of the tests
+constexpr char const * inputPackageName = "testRESQMLOutputInput";
+
+/// UUID of the Top region added to the test package, the other regions are only found by title
+constexpr char const * topRegionUuid = "5d3c8f2e-7a41-4b6e-9c0d-2e8f1a7b3c64";
+
+/**
+ * @brief Cells of the regions added to the test package, by title
+ * @return the RESQML indices of the cells of each region
+ * @details The West and East regions split the grid along I, the Top region is the first layer and overlaps both.
+ */
+std::map< string, std::vector< uint64_t > > getRegionCells()
+{
+  std::map< string, std::vector< uint64_t > > regionCells;
+  for( uint64_t k = 0; k < 2; ++k )
+  {
+    for( uint64_t j = 0; j < 3; ++j )
+    {
+      for( uint64_t i = 0; i < 4; ++i )
+      {
+        uint64_t const cellIndex = i + 4 * j + 12 * k;
+        regionCells[i < 2 ? "West" : "East"].push_back( cellIndex );
+        if( k == 0 )
+        {
+          regionCells["Top"].push_back( cellIndex );
+        }
+      }
+    }
+  }
+  return regionCells;
+}
+
+/**
+ * @brief Build an input deck loading the IJK grid of the test package, with a RESQML output of its cells
+ * @param[in] outputAttributes The attributes of the RESQML output, besides its name and its mesh
+ * @param[in] meshChildren The children of the RESQML mesh
+ * @return the input deck
+ */
+string createInputDeck( string const & outputAttributes, string const & meshChildren = "" )
+{
+  return GEOS_FMT( R"xml(
+<Problem>
+  <ExternalDataRepository>
+    <EpcDocumentRepository name="repository" files="{{ {}/{}.epc }}"/>
+  </ExternalDataRepository>
+  <Mesh>
+    <RESQMLMesh name="mesh" repositoryName="repository" uuid="{}" compactInactiveCells="1">{}
+    </RESQMLMesh>
+  </Mesh>
+  <Events maxTime="1.0"/>
+  <ElementRegions>
+    <CellElementRegion name="reservoir" cellBlocks="{{ * }}" materialList="{{ }}"/>
+  </ElementRegions>
+  <Outputs>
+    <RESQML name="resqmlOutput" referenceObjectName="mesh" onlyPlotSpecifiedFieldNames="1" {}/>
+  </Outputs>
+</Problem>)xml", std::filesystem::temp_directory_path().string(), inputPackageName, gridUuid, meshChildren, outputAttributes );
+}
+
+/**
+ * @brief Apply a function to the owned cells of a domain
+ * @param[in] domain The domain
+ * @param[in] lambda The function, called with the subregion and the index of each owned cell
+ */
+template< typename LAMBDA >
+void forOwnedCells( DomainPartition & domain, LAMBDA && lambda )
+{
+  ElementRegionManager & elemManager = domain.getMeshBody( 0 ).getBaseDiscretization().getElemManager();
+  elemManager.forElementSubRegions< CellElementSubRegion >( [&]( CellElementSubRegion & subRegion )
+  {
+    arrayView1d< integer const > const ghostRank = subRegion.ghostRank();
+    for( localIndex k = 0; k < subRegion.size(); ++k )
+    {
+      if( ghostRank[k] < 0 )
+      {
+        lambda( subRegion, k );
+      }
+    }
+  } );
+}
+
+/**
+ * @brief Set the values of a scalar cell field from the global ids of the cells, registering it on first use
+ * @param[in] domain The domain
+ * @param[in] fieldName The name of the field
+ * @param[in] value The value of the field, as a function of the global id of a cell
+ */
+void setCellField( DomainPartition & domain, string const & fieldName, std::function< real64 ( globalIndex ) > const & value )
+{
+  ElementRegionManager & elemManager = domain.getMeshBody( 0 ).getBaseDiscretization().getElemManager();
+  elemManager.forElementSubRegions< CellElementSubRegion >( [&]( CellElementSubRegion & subRegion )
+  {
+    if( !subRegion.hasWrapper( fieldName ))
+    {
+      subRegion.registerWrapper< array1d< real64 > >( fieldName ).
+        setPlotLevel( dataRepository::PlotLevel::LEVEL_0 );
+    }
+    array1d< real64 > & values = subRegion.getReference< array1d< real64 > >( fieldName );
+    values.resize( subRegion.size());
+
+    arrayView1d< globalIndex const > const localToGlobal = subRegion.localToGlobalMap();
+    for( localIndex k = 0; k < subRegion.size(); ++k )
+    {
+      values[k] = value( localToGlobal[k] );
+    }
+  } );
+}
+
+/**
+ * @brief Get the values of a function on the owned cells of a domain
+ * @param[in] domain The domain
+ * @param[in] value The value of the function, as a function of the global id of a cell
+ * @return the values, by global id
+ */
+std::map< globalIndex, real64 > getOwnedCellValues( DomainPartition & domain, std::function< real64 ( globalIndex ) > const & value )
+{
+  std::map< globalIndex, real64 > values;
+  forOwnedCells( domain, [&]( CellElementSubRegion const & subRegion, localIndex const k )
+  {
+    globalIndex const globalId = subRegion.localToGlobalMap()[k];
+    values[globalId] = value( globalId );
+  } );
+  return values;
+}
+
+/**
+ * @brief Read back the RESQML document written by an output
+ * @param[in] plotFileName The name of the files of the output
+ * @return the repository holding the document
+ * @details The writers keep their HDF5 files open, so they are flushed before being read.
+ */
+std::unique_ptr< COMMON_NS::DataObjectRepository > readOutputDocument( string const & plotFileName )
+{
+  ssize_t const fileCount = H5Fget_obj_count( H5F_OBJ_ALL, H5F_OBJ_FILE );
+  std::vector< hid_t > files( fileCount );
+  H5Fget_obj_ids( H5F_OBJ_ALL, H5F_OBJ_FILE, files.size(), files.data());
+  for( hid_t const file : files )
+  {
+    H5Fflush( file, H5F_SCOPE_GLOBAL );
+  }
+
+  auto repository = std::make_unique< COMMON_NS::DataObjectRepository >();
+  COMMON_NS::EpcDocument document( ( std::filesystem::temp_directory_path() / ( plotFileName + ".epc" )).string() );
+  document.deserializeInto( *repository );
+  document.close();
+  return repository;
+}
+
+/**
+ * @brief Get the continuous properties of a repository with a given title
+ * @param[in] repository The repository
+ * @param[in] title The title of the properties
+ * @return the properties
+ */
+std::vector< RESQML2_NS::ContinuousProperty * > getProperties( COMMON_NS::DataObjectRepository const & repository, string const & title )
+{
+  std::vector< RESQML2_NS::ContinuousProperty * > properties;
+  for( auto * property : repository.getDataObjects< RESQML2_NS::ContinuousProperty >())
+  {
+    if( property->getTitle() == title )
+    {
+      properties.push_back( property );
+    }
+  }
+  return properties;
+}
+
+/**
+ * @brief Read the values of a cell property
+ * @param[in] property The property
+ * @return the values, by index of their cell in the grid
+ */
+std::map< globalIndex, real64 > readCellValues( RESQML2_NS::AbstractValuesProperty * property )
+{
+  uint64_t const valueCount = property->getValuesCountOfPatch( 0 );
+  std::vector< double > values( valueCount );
+  property->getDoubleValuesOfPatch( 0, values.data());
+
+  // The values of a subrepresentation follow its element indices, those of the grid the cells of the grid
+  std::vector< uint64_t > cellIndices( valueCount );
+  std::iota( cellIndices.begin(), cellIndices.end(), 0 );
+  auto * const subrep = dynamic_cast< RESQML2_NS::SubRepresentation * >( property->getRepresentation());
+  if( subrep != nullptr )
+  {
+    EXPECT_EQ( subrep->getElementCountOfPatch( 0 ), valueCount );
+    subrep->getElementIndicesOfPatch( 0, 0, cellIndices.data());
+  }
+
+  std::map< globalIndex, real64 > cellValues;
+  for( uint64_t i = 0; i < valueCount; ++i )
+  {
+    cellValues[LvArray::integerConversion< globalIndex >( cellIndices[i] )] = values[i];
+  }
+  return cellValues;
+}
+
+/**
+ * @brief Value of the test fields in a cell
+ * @param[in] globalId The global id of the cell
+ * @return the value
+ */
+real64 cellValue( globalIndex const globalId )
+{
+  return 10.0 * static_cast< real64 >( globalId ) + 0.5;
+}
+
+/**
+ * @brief Value of the second test field in a cell
+ * @param[in] globalId The global id of the cell
+ * @return the value
+ */
+real64 oppositeCellValue( globalIndex const globalId )
+{
+  return -cellValue( globalId );
+}
+
+}
+
+/**
+ * @brief A problem on the IJK grid of the test package, whose fields are written by a RESQML output
+ */
+class RESQMLOutputTest : public ::testing::Test
+{
+protected:
+
+  RESQMLOutputTest():
+    state( std::make_unique< CommandLineOptions >( g_commandLineOptions ) )
+  {}
+
+  /**
+   * @brief Copy the test package in the temporary directory, with the regions of getRegionCells()
+   */
+  static void SetUpTestSuite()
+  {
+    std::filesystem::path const directory = std::filesystem::temp_directory_path();
+    std::filesystem::copy_file( std::filesystem::path( RESQML_TEST_DATA_DIR ) / "testingPackageCpp.h5", directory / "testingPackageCpp.h5",
+                                std::filesystem::copy_options::overwrite_existing );
+
+    COMMON_NS::DataObjectRepository repository;
+    COMMON_NS::EpcDocument package( std::string( RESQML_TEST_DATA_DIR ) + "/testingPackageCpp.epc" );
+    package.deserializeInto( repository );
+    package.close();
+
+    EML2_NS::AbstractHdfProxy * const hdfProxy =
+      repository.createHdfProxy( "", "Test regions", directory.string(), string( inputPackageName ) + ".h5",
+                                 COMMON_NS::DataObjectRepository::openingMode::OVERWRITE );
+    for( auto const & [title, cells] : getRegionCells())
+    {
+      RESQML2_NS::SubRepresentation * const subrep = repository.createSubRepresentation( title == "Top" ? topRegionUuid : "", title );
+      subrep->pushBackSupportingRepresentation( repository.getDataObjectByUuid< RESQML2_NS::AbstractIjkGridRepresentation >( gridUuid ));
+      subrep->pushBackSubRepresentationPatch( gsoap_eml2_3::eml23__IndexableElement::cells, cells.size(), cells.data(), hdfProxy );
+    }
+    hdfProxy->close();
+
+    COMMON_NS::EpcDocument inputPackage( ( directory / ( string( inputPackageName ) + ".epc" )).string() );
+    inputPackage.serializeFrom( repository );
+    inputPackage.close();
+  }
+
+  /**
+   * @brief Set up the problem of an input deck
+   * @param[in] inputDeck The input deck
+   */
+  void setupProblem( string const & inputDeck )
+  {
+    OutputBase::setOutputDirectory( std::filesystem::temp_directory_path().string() );
+    ProblemManager & problemManager = state.getProblemManager();
+    problemManager.parseInputString( inputDeck );
+    problemManager.problemSetup();
+  }
+
+  DomainPartition & getDomain()
+  {
+    return state.getProblemManager().getDomainPartition();
+  }
+
+  /**
+   * @brief Execute the RESQML output
+   * @param[in] time The time of the execution
+   * @param[in] cycle The cycle of the execution
+   */
+  void execute( real64 const time, integer const cycle )
+  {
+    RESQMLOutput & output = state.getProblemManager().getGroupByPath< RESQMLOutput >( "/Problem/Outputs/resqmlOutput" );
+    output.execute( time, 0.0, cycle, 0, 0.0, getDomain());
+  }
+
+  /**
+   * @brief Clean up the RESQML output, which writes its document
+   * @param[in] time The time of the last execution
+   * @param[in] cycle The cycle of the last execution
+   */
+  void cleanup( real64 const time, integer const cycle )
+  {
+    RESQMLOutput & output = state.getProblemManager().getGroupByPath< RESQMLOutput >( "/Problem/Outputs/resqmlOutput" );
+    output.cleanup( time, cycle, 0, 0.0, getDomain());
+  }
+
+  GeosxState state;
+};
+
+TEST_F( RESQMLOutputTest, writeOnSubRepresentation )
+{
+  setupProblem( createInputDeck( R"(plotFileName="testSubRepresentationOutput" fieldNames="{ cellValue }")" ));
+  setCellField( getDomain(), "cellValue", cellValue );
+  execute( 0.0, 0 );
+  cleanup( 0.0, 0 );
+
+  auto const repository = readOutputDocument( "testSubRepresentationOutput" );
+  std::vector< RESQML2_NS::ContinuousProperty * > const properties = getProperties( *repository, "cellValue" );
+  ASSERT_EQ( properties.size(), 1 );
+  ASSERT_NE( dynamic_cast< RESQML2_NS::SubRepresentation * >( properties[0]->getRepresentation()), nullptr );
+
+  // The subrepresentation lists the owned cells, with their values
+  EXPECT_EQ( readCellValues( properties[0] ), getOwnedCellValues( getDomain(), cellValue ));
+}
+
+TEST_F( RESQMLOutputTest, writeOnParentGrid )
+{
+  setupProblem( createInputDeck( R"(plotFileName="testParentGridOutput" fieldNames="{ cellValue }" writeOnParentGrid="1")" ));
+  setCellField( getDomain(), "cellValue", cellValue );
+  execute( 0.0, 0 );
+  cleanup( 0.0, 0 );
+
+  auto const repository = readOutputDocument( "testParentGridOutput" );
+  std::vector< RESQML2_NS::ContinuousProperty * > const properties = getProperties( *repository, "cellValue" );
+  ASSERT_EQ( properties.size(), 1 );
+  EXPECT_EQ( properties[0]->getRepresentation()->getUuid(), gridUuid );
+  ASSERT_EQ( properties[0]->getValuesCountOfPatch( 0 ), gridCellCount );
+
+  // The values are ordered by global id, the cells without geometry being set to zero
+  std::map< globalIndex, real64 > const expectedValues = getOwnedCellValues( getDomain(), cellValue );
+  std::map< globalIndex, real64 > const values = readCellValues( properties[0] );
+  for( auto const & [globalId, value] : values )
+  {
+    auto const expectedValue = expectedValues.find( globalId );
+    EXPECT_EQ( value, expectedValue == expectedValues.end() ? 0.0 : expectedValue->second ) << "cell " << globalId;
+  }
+}
+
+TEST_F( RESQMLOutputTest, packScalarFields )
+{
+  setupProblem( createInputDeck( R"(plotFileName="testPackedFieldsOutput" fieldNames="{ cellValue, oppositeCellValue }" packScalarFields="1")" ));
+  setCellField( getDomain(), "cellValue", cellValue );
+  setCellField( getDomain(), "oppositeCellValue", oppositeCellValue );
+  execute( 0.0, 0 );
+  cleanup( 0.0, 0 );
+
+  // Each field is read through the virtual dataset of its column in the packed dataset
+  EXPECT_TRUE( std::filesystem::exists( std::filesystem::temp_directory_path() / "testPackedFieldsOutput_fields.h5" ));
+  auto const repository = readOutputDocument( "testPackedFieldsOutput" );
+  std::vector< RESQML2_NS::ContinuousProperty * > const properties = getProperties( *repository, "cellValue" );
+  std::vector< RESQML2_NS::ContinuousProperty * > const oppositeProperties = getProperties( *repository, "oppositeCellValue" );
+  ASSERT_EQ( properties.size(), 1 );
+  ASSERT_EQ( oppositeProperties.size(), 1 );
+
+  // The fields defined on the same cells share their subrepresentation
+  EXPECT_EQ( properties[0]->getRepresentation()->getUuid(), oppositeProperties[0]->getRepresentation()->getUuid());
+  EXPECT_EQ( readCellValues( properties[0] ), getOwnedCellValues( getDomain(), cellValue ));
+  EXPECT_EQ( readCellValues( oppositeProperties[0] ), getOwnedCellValues( getDomain(), oppositeCellValue ));
+}
+
+TEST_F( RESQMLOutputTest, packScalarFieldsOnParentGrid )
+{
+  setupProblem( createInputDeck( R"(plotFileName="testPackedParentGridOutput" fieldNames="{ cellValue, oppositeCellValue }" )"
+                                 R"(packScalarFields="1" writeOnParentGrid="1")" ));
+  setCellField( getDomain(), "cellValue", cellValue );
+  setCellField( getDomain(), "oppositeCellValue", oppositeCellValue );
+  execute( 0.0, 0 );
+  cleanup( 0.0, 0 );
+
+  auto const repository = readOutputDocument( "testPackedParentGridOutput" );
+  for( auto const & [field, value] : { std::make_pair( "cellValue", cellValue ), std::make_pair( "oppositeCellValue", oppositeCellValue ) } )
+  {
+    SCOPED_TRACE( field );
+    std::vector< RESQML2_NS::ContinuousProperty * > const properties = getProperties( *repository, field );
+    ASSERT_EQ( properties.size(), 1 );
+    EXPECT_EQ( properties[0]->getRepresentation()->getUuid(), gridUuid );
+    ASSERT_EQ( properties[0]->getValuesCountOfPatch( 0 ), gridCellCount );
+
+    std::map< globalIndex, real64 > const expectedValues = getOwnedCellValues( getDomain(), value );
+    for( auto const & [globalId, readValue] : readCellValues( properties[0] ))
+    {
+      auto const expectedValue = expectedValues.find( globalId );
+      EXPECT_EQ( readValue, expectedValue == expectedValues.end() ? 0.0 : expectedValue->second ) << "cell " << globalId;
+    }
+  }
+}
+
+TEST_F( RESQMLOutputTest, temporalReductions )
+{
+  setupProblem( createInputDeck( R"(plotFileName="testReductionsOutput" fieldNames="{ cellValue }" )"
+                                 R"(temporalReductions="{ min, max, mean }" dumpFrequency="2")" ));
+
+  // The values increase by one at each execution: the reductions are dumped after the second one,
+  // and the third one makes a last, partial window dumped at cleanup
+  for( integer cycle = 0; cycle < 3; ++cycle )
+  {
+    setCellField( getDomain(), "cellValue", [cycle]( globalIndex const globalId ) { return cellValue( globalId ) + cycle; } );
+    execute( 10.0 * cycle, cycle );
+  }
+  cleanup( 20.0, 2 );
+
+  auto const repository = readOutputDocument( "testReductionsOutput" );
+  EXPECT_TRUE( getProperties( *repository, "cellValue" ).empty());
+
+  std::map< string, std::array< real64, 2 > > const offsets = { { "min", { 0.0, 2.0 } }, { "max", { 1.0, 2.0 } }, { "mean", { 0.5, 2.0 } } };
+  for( auto const & [reduction, windowOffsets] : offsets )
+  {
+    SCOPED_TRACE( reduction );
+    std::vector< RESQML2_NS::ContinuousProperty * > const properties = getProperties( *repository, "cellValue_" + reduction );
+    ASSERT_EQ( properties.size(), 2 );
+
+    // The windows are told apart by their values, which increase with time
+    std::vector< std::map< globalIndex, real64 > > windowValues = { readCellValues( properties[0] ), readCellValues( properties[1] ) };
+    ASSERT_FALSE( windowValues[0].empty());
+    if( windowValues[0].begin()->second > windowValues[1].begin()->second )
+    {
+      std::swap( windowValues[0], windowValues[1] );
+    }
+
+    for( std::size_t window = 0; window < windowValues.size(); ++window )
+    {
+      real64 const offset = windowOffsets[window];
+      EXPECT_EQ( windowValues[window], getOwnedCellValues( getDomain(), [offset]( globalIndex const globalId ) { return cellValue( globalId ) + offset; } ))
+        << "window " << window;
+    }
+  }
+}
+
+TEST_F( RESQMLOutputTest, summarizeFieldsByRegion )
+{
+  setupProblem( createInputDeck( R"(plotFileName="testSummaryOutput" fieldNames="{ cellValue }" )"
+                                 R"(summaryFieldNames="{ cellValue }" summaryWeightFieldName="porosity")",
+                                 R"(<Region name="west" title="West"/><Region name="east" title="East"/><Region name="top" title="Top"/>)" ));
+  setCellField( getDomain(), "porosity", []( globalIndex const globalId ) { return 0.1 + 0.01 * static_cast< real64 >( globalId ); } );
+
+  std::map< string, std::vector< uint64_t > > const regionCells = getRegionCells();
+  std::vector< string > const regions = { "West", "East", "Top" };
+
+  // The pore-volume weighted totals and means of each execution, in the order of the Region children
+  std::vector< std::vector< real64 > > expectedTotals;
+  std::vector< std::vector< real64 > > expectedMeans;
+  for( integer cycle = 0; cycle < 2; ++cycle )
+  {
+    auto const value = [cycle]( globalIndex const globalId ) { return cellValue( globalId ) + cycle; };
+    setCellField( getDomain(), "cellValue", value );
+    execute( 10.0 * cycle, cycle );
+
+    std::vector< real64 > totals( regions.size(), 0.0 );
+    std::vector< real64 > weights( regions.size(), 0.0 );
+    forOwnedCells( getDomain(), [&]( CellElementSubRegion const & subRegion, localIndex const k )
+    {
+      globalIndex const globalId = subRegion.localToGlobalMap()[k];
+      real64 const weight = subRegion.getElementVolume()[k] * subRegion.getReference< array1d< real64 > >( "porosity" )[k];
+      for( std::size_t r = 0; r < regions.size(); ++r )
+      {
+        std::vector< uint64_t > const & cells = regionCells.at( regions[r] );
+        if( std::find( cells.begin(), cells.end(), LvArray::integerConversion< uint64_t >( globalId )) != cells.end())
+        {
+          totals[r] += weight * value( globalId );
+          weights[r] += weight;
+        }
+      }
+    } );
+    expectedTotals.push_back( totals );
+    std::vector< real64 > means( regions.size(), 0.0 );
+    for( std::size_t r = 0; r < regions.size(); ++r )
+    {
+      ASSERT_GT( weights[r], 0.0 );
+      means[r] = totals[r] / weights[r];
+    }
+    expectedMeans.push_back( means );
+  }
+  cleanup( 10.0, 1 );
+
+  auto const repository = readOutputDocument( "testSummaryOutput" );
+  for( auto const & [statistic, expectedValues] : { std::make_pair( "total", expectedTotals ), std::make_pair( "mean", expectedMeans ) } )
+  {
+    SCOPED_TRACE( statistic );
+    std::vector< RESQML2_NS::ContinuousProperty * > const properties = getProperties( *repository, string( "cellValue_" ) + statistic + "_by_region" );
+    ASSERT_EQ( properties.size(), 1 );
+    EXPECT_EQ( properties[0]->getAttachmentKind(), gsoap_eml2_3::eml23__IndexableElement::regions );
+
+    // One patch per execution, one value per region
+    ASSERT_EQ( properties[0]->getPatchCount(), expectedValues.size());
+    for( uint64_t patch = 0; patch < expectedValues.size(); ++patch )
+    {
+      ASSERT_EQ( properties[0]->getValuesCountOfPatch( patch ), regions.size());
+      std::vector< double > values( regions.size());
+      properties[0]->getDoubleValuesOfPatch( patch, values.data());
+      for( std::size_t r = 0; r < regions.size(); ++r )
+      {
+        EXPECT_NEAR( values[r], expectedValues[patch][r], 1.0e-12 * std::abs( expectedValues[patch][r] )) << "patch " << patch << ", region " << regions[r];
+      }
+    }
+  }
+}
+
+TEST_F( RESQMLOutputTest, writeOutputRegions )
+{
+  setupProblem( createInputDeck( GEOS_FMT( R"(plotFileName="testOutputRegionsOutput" fieldNames="{{ cellValue }}" outputRegions="{{ West, {} }}")",
+                                           topRegionUuid )));
+  setCellField( getDomain(), "cellValue", cellValue );
+  execute( 0.0, 0 );
+  cleanup( 0.0, 0 );
+
+  // Only the cells of the regions, found by title or by UUID, are written
+  std::map< string, std::vector< uint64_t > > const regionCells = getRegionCells();
+  std::map< globalIndex, real64 > expectedValues;
+  for( auto const & [globalId, value] : getOwnedCellValues( getDomain(), cellValue ))
+  {
+    for( string const region : { "West", "Top" } )
+    {
+      std::vector< uint64_t > const & cells = regionCells.at( region );
+      if( std::find( cells.begin(), cells.end(), LvArray::integerConversion< uint64_t >( globalId )) != cells.end())
+      {
+        expectedValues[globalId] = value;
+      }
+    }
+  }
+  EXPECT_FALSE( expectedValues.empty());
+
+  auto const repository = readOutputDocument( "testOutputRegionsOutput" );
+  std::vector< RESQML2_NS::ContinuousProperty * > const properties = getProperties( *repository, "cellValue" );
+  ASSERT_EQ( properties.size(), 1 );
+  EXPECT_EQ( readCellValues( properties[0] ), expectedValues );
+}
+
+TEST_F( RESQMLOutputTest, writeOutputBoundingBox )
+{
+  // The box keeps the cells centered in the lower half of the grid along x
+  COMMON_NS::DataObjectRepository inputRepository;
+  COMMON_NS::EpcDocument package( std::string( RESQML_TEST_DATA_DIR ) + "/testingPackageCpp.epc" );
+  package.deserializeInto( inputRepository );
+  package.close();
+  auto * const grid = inputRepository.getDataObjectByUuid< RESQML2_NS::AbstractIjkGridRepresentation >( gridUuid );
+  ASSERT_NE( grid, nullptr );
+  std::vector< double > points( 3 * grid->getXyzPointCountOfAllPatches());
+  grid->getXyzPointsOfAllPatches( points.data());
+  real64 xMin = std::numeric_limits< real64 >::max();
+  real64 xMax = std::numeric_limits< real64 >::lowest();
+  for( std::size_t p = 0; p < points.size(); p += 3 )
+  {
+    if( !std::isnan( points[p] ))
+    {
+      xMin = std::min( xMin, points[p] );
+      xMax = std::max( xMax, points[p] );
+    }
+  }
+  real64 const xMiddle = 0.5 * ( xMin + xMax );
+
+  setupProblem( createInputDeck( GEOS_FMT( R"(plotFileName="testOutputBoundingBoxOutput" fieldNames="{{ cellValue }}" )"
+                                           R"(outputBoundingBox="{{ -1e30, -1e30, -1e30, {}, 1e30, 1e30 }}" outputRegions="{{ Top }}")",
+                                           xMiddle )));
+  setCellField( getDomain(), "cellValue", cellValue );
+  execute( 0.0, 0 );
+  cleanup( 0.0, 0 );
+
+  // Only the cells of the regions inside the box are written
+  std::vector< uint64_t > const topCells = getRegionCells().at( "Top" );
+  std::map< globalIndex, real64 > expectedValues;
+  globalIndex outsideCount = 0;
+  forOwnedCells( getDomain(), [&]( CellElementSubRegion const & subRegion, localIndex const k )
+  {
+    globalIndex const globalId = subRegion.localToGlobalMap()[k];
+    bool const isTop = std::find( topCells.begin(), topCells.end(), LvArray::integerConversion< uint64_t >( globalId )) != topCells.end();
+    if( isTop && subRegion.getElementCenter()[k][0] <= xMiddle )
+    {
+      expectedValues[globalId] = cellValue( globalId );
+    }
+    else if( isTop )
+    {
+      ++outsideCount;
+    }
+  } );
+  EXPECT_FALSE( expectedValues.empty());
+  EXPECT_GT( outsideCount, 0 );
+
+  auto const repository = readOutputDocument( "testOutputBoundingBoxOutput" );
+  std::vector< RESQML2_NS::ContinuousProperty * > const properties = getProperties( *repository, "cellValue" );
+  ASSERT_EQ( properties.size(), 1 );
+  EXPECT_EQ( readCellValues( properties[0] ), expectedValues );
+}
+
+int main( int argc, char * * argv )
+{
+  // The HDF5 files held open by the writers are read back by the tests
+  setenv( "HDF5_USE_FILE_LOCKING", "FALSE", 1 );
+
+  ::testing::InitGoogleTest( &argc, argv );
+  g_commandLineOptions = *geos::basicSetup( argc, argv );
+  int const result = RUN_ALL_TESTS();
+  geos::basicCleanup();
+  return result;
+}
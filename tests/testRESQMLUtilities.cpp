@@ -0,0 +1,730 @@
+/*
+ * ------------------------------------------------------------------------------------------------------------
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ * Copyright (c) 2018-2020 Lawrence Livermore National Security LLC
+ * Copyright (c) 2018-2020 The Board of Trustees of the Leland Stanford Junior University
+ * Copyright (c) 2018-2020 TotalEnergies
+ * Copyright (c) 2019-     GEOSX Contributors
+ * All rights reserved
+ *
+ * See top level LICENSE, COPYRIGHT, CONTRIBUTORS, NOTICE, and ACKNOWLEDGEMENTS files for details.
+ * ------------------------------------------------------------------------------------------------------------
+ */
+
+// Source includes
+#include "RESQMLUtilities.hpp"
+#include "common/initializeEnvironment.hpp"
+
+// TPL includes
+#include <gtest/gtest.h>
+
+#include <vtkCellData.h>
+#include <vtkDataArray.h>
+#include <vtkIdList.h>
+#include <vtkIdTypeArray.h>
+#include <vtkIntArray.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkSignedCharArray.h>
+#include <vtkUnstructuredGrid.h>
+
+#include "fesapi/common/DataObjectRepository.h"
+#include "fesapi/common/EpcDocument.h"
+#include "fesapi/eml2/AbstractHdfProxy.h"
+#include "fesapi/resqml2/AbstractIjkGridRepresentation.h"
+#include "fesapi/resqml2/CategoricalProperty.h"
+#include "fesapi/resqml2/ContinuousProperty.h"
+#include "fesapi/resqml2/DiscreteProperty.h"
+#include "fesapi/resqml2/SubRepresentation.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <filesystem>
+#include <limits>
+#include <map>
+#include <memory>
+#include <set>
+
+using namespace geos;
+
+namespace
+{
+
+/// Name of the cell array numbering the cells of the test grids
+constexpr char const * cellNumberArrayName = "CellNumber";
+
+/**
+ * @brief Build a row of unit hexahedra along x, listed from the last to the first
+ * @param[in] cellCount The number of hexahedra
+ * @return the grid, whose cells hold their position along the row in the cellNumberArrayName cell array
+ */
+vtkSmartPointer< vtkUnstructuredGrid > createHexahedronRow( vtkIdType const cellCount )
+{
+  vtkNew< vtkPoints > points;
+  for( vtkIdType i = 0; i <= cellCount; ++i )
+  {
+    for( int z = 0; z < 2; ++z )
+    {
+      for( int y = 0; y < 2; ++y )
+      {
+        points->InsertNextPoint( i, y, z );
+      }
+    }
+  }
+
+  auto pointId = []( vtkIdType i, int y, int z ) { return 4 * i + 2 * z + y; };
+
+  vtkSmartPointer< vtkUnstructuredGrid > grid = vtkSmartPointer< vtkUnstructuredGrid >::New();
+  grid->SetPoints( points );
+  grid->Allocate( cellCount );
+
+  vtkNew< vtkIntArray > cellNumbers;
+  cellNumbers->SetName( cellNumberArrayName );
+  for( vtkIdType c = cellCount - 1; c >= 0; --c )
+  {
+    vtkIdType const hexahedron[8] = { pointId( c, 0, 0 ), pointId( c + 1, 0, 0 ), pointId( c + 1, 1, 0 ), pointId( c, 1, 0 ),
+                                      pointId( c, 0, 1 ), pointId( c + 1, 0, 1 ), pointId( c + 1, 1, 1 ), pointId( c, 1, 1 ) };
+    grid->InsertNextCell( VTK_HEXAHEDRON, 8, hexahedron );
+    cellNumbers->InsertNextValue( static_cast< int >( c ));
+  }
+  grid->GetCellData()->AddArray( cellNumbers );
+
+  return grid;
+}
+
+/**
+ * @brief Expect the cells of two datasets to have the same point coordinates
+ * @param[in] dataset The first dataset
+ * @param[in] cellId The cell of the first dataset
+ * @param[in] reference The second dataset
+ * @param[in] referenceCellId The cell of the second dataset
+ */
+void expectSameCellPoints( vtkDataSet * dataset, vtkIdType cellId, vtkDataSet * reference, vtkIdType referenceCellId )
+{
+  vtkNew< vtkIdList > pointIds;
+  vtkNew< vtkIdList > referencePointIds;
+  dataset->GetCellPoints( cellId, pointIds );
+  reference->GetCellPoints( referenceCellId, referencePointIds );
+  ASSERT_EQ( pointIds->GetNumberOfIds(), referencePointIds->GetNumberOfIds());
+
+  for( vtkIdType i = 0; i < pointIds->GetNumberOfIds(); ++i )
+  {
+    double point[3];
+    double referencePoint[3];
+    dataset->GetPoint( pointIds->GetId( i ), point );
+    reference->GetPoint( referencePointIds->GetId( i ), referencePoint );
+    for( int dim = 0; dim < 3; ++dim )
+    {
+      EXPECT_DOUBLE_EQ( point[dim], referencePoint[dim] ) << "cell " << cellId << ", corner " << i;
+    }
+  }
+}
+
+/**
+ * @brief Expect the partitions of the cells to be in range and balanced within one cell
+ * @param[in] partitions The partition of each cell
+ * @param[in] partitionCount The number of partitions
+ */
+void expectBalancedPartitions( std::vector< int > const & partitions, int partitionCount )
+{
+  std::vector< std::size_t > partitionSizes( partitionCount, 0 );
+  for( int const partition : partitions )
+  {
+    ASSERT_GE( partition, 0 );
+    ASSERT_LT( partition, partitionCount );
+    ++partitionSizes[partition];
+  }
+  auto const [smallest, largest] = std::minmax_element( partitionSizes.begin(), partitionSizes.end());
+  EXPECT_LE( *largest - *smallest, 1 );
+}
+
+/**
+ * @brief Create the values of a discrete property
+ * @param[in] values The value of each cell
+ * @return the values, in a vtkIntArray as read by readProperty
+ */
+vtkSmartPointer< vtkDataArray > createPropertyValues( std::vector< int > const & values )
+{
+  vtkSmartPointer< vtkIntArray > propertyValues = vtkSmartPointer< vtkIntArray >::New();
+  propertyValues->SetName( "Facies" );
+  for( int const value : values )
+  {
+    propertyValues->InsertNextValue( value );
+  }
+  return propertyValues;
+}
+
+/**
+ * @brief Expect the values of a cell array
+ * @param[in] dataset The dataset
+ * @param[in] name The name of the cell array
+ * @param[in] expectedValues The value of each cell
+ */
+void expectCellValues( vtkDataSet * dataset, char const * name, std::vector< int > const & expectedValues )
+{
+  vtkDataArray * const array = dataset->GetCellData()->GetArray( name );
+  ASSERT_NE( array, nullptr ) << name;
+  ASSERT_EQ( array->GetNumberOfTuples(), static_cast< vtkIdType >( expectedValues.size()));
+  for( vtkIdType cellId = 0; cellId < array->GetNumberOfTuples(); ++cellId )
+  {
+    EXPECT_EQ( array->GetTuple1( cellId ), expectedValues[cellId] ) << name << ", cell " << cellId;
+  }
+}
+
+}
+
+TEST( RESQMLUtilities, hilbertIndex3d )
+{
+  for( int bitCount = 1; bitCount <= 3; ++bitCount )
+  {
+    std::uint32_t const sideLength = 1u << bitCount;
+    std::uint64_t const indexCount = std::uint64_t( sideLength ) * sideLength * sideLength;
+
+    // The curve visits each vertex of the cube once, moving to a neighbor at each step
+    std::vector< std::array< std::uint32_t, 3 > > vertexOfIndex( indexCount );
+    std::vector< bool > isVisited( indexCount, false );
+    for( std::uint32_t x = 0; x < sideLength; ++x )
+    {
+      for( std::uint32_t y = 0; y < sideLength; ++y )
+      {
+        for( std::uint32_t z = 0; z < sideLength; ++z )
+        {
+          std::uint64_t const index = hilbertIndex3d( { x, y, z }, bitCount );
+          ASSERT_LT( index, indexCount );
+          ASSERT_FALSE( isVisited[index] );
+          isVisited[index] = true;
+          vertexOfIndex[index] = { x, y, z };
+        }
+      }
+    }
+
+    for( std::uint64_t index = 1; index < indexCount; ++index )
+    {
+      std::uint32_t distance = 0;
+      for( int dim = 0; dim < 3; ++dim )
+      {
+        distance += std::max( vertexOfIndex[index][dim], vertexOfIndex[index - 1][dim] ) -
+                    std::min( vertexOfIndex[index][dim], vertexOfIndex[index - 1][dim] );
+      }
+      EXPECT_EQ( distance, 1 ) << "bitCount " << bitCount << ", index " << index;
+    }
+  }
+}
+
+TEST( RESQMLUtilities, reorderCellsKeepsCellPoints )
+{
+  vtkIdType const cellCount = 7;
+  vtkSmartPointer< vtkUnstructuredGrid > grid = createHexahedronRow( cellCount );
+
+  EXPECT_EQ( reorderCells( grid, CellReordering::none ).GetPointer(), grid.GetPointer());
+
+  vtkSmartPointer< vtkDataSet > reordered = reorderCells( grid, CellReordering::hilbert );
+  ASSERT_EQ( reordered->GetNumberOfCells(), cellCount );
+  ASSERT_EQ( reordered->GetNumberOfPoints(), grid->GetNumberOfPoints());
+
+  // The cell arrays follow the cells
+  vtkDataArray * const cellNumbers = reordered->GetCellData()->GetArray( cellNumberArrayName );
+  ASSERT_NE( cellNumbers, nullptr );
+  std::set< vtkIdType > foundCells;
+  for( vtkIdType cellId = 0; cellId < cellCount; ++cellId )
+  {
+    vtkIdType const cellNumber = static_cast< vtkIdType >( cellNumbers->GetTuple1( cellId ));
+    EXPECT_TRUE( foundCells.insert( cellNumber ).second );
+    expectSameCellPoints( reordered, cellId, grid, cellCount - 1 - cellNumber );
+  }
+
+  // The points are numbered in the order of their first use by the cells
+  vtkNew< vtkIdList > pointIds;
+  reordered->GetCellPoints( 0, pointIds );
+  for( vtkIdType i = 0; i < pointIds->GetNumberOfIds(); ++i )
+  {
+    EXPECT_EQ( pointIds->GetId( i ), i );
+  }
+}
+
+TEST( RESQMLUtilities, createRegionsFromBitsets )
+{
+  vtkSmartPointer< vtkUnstructuredGrid > grid = createHexahedronRow( 6 );
+
+  // The cells shared by several regions get the id of the last of them
+  CellBitset first;
+  first.words = { 0b0111 };
+  CellBitset second;
+  second.words = { 0b1100 };
+
+  createRegions( grid, { first, second }, "Regions" );
+  vtkDataArray * const regions = grid->GetCellData()->GetArray( "Regions" );
+  ASSERT_NE( regions, nullptr );
+  EXPECT_EQ( regions->GetDataType(), VTK_SIGNED_CHAR );
+  std::vector< int > const expectedRegions = { 1, 1, 2, 2, 0, 0 };
+  for( vtkIdType cellId = 0; cellId < 6; ++cellId )
+  {
+    EXPECT_EQ( regions->GetTuple1( cellId ), expectedRegions[cellId] ) << "cell " << cellId;
+  }
+
+  // GEOS reads the regions as int
+  convertRegionIdsToInt( *grid, "Regions" );
+  vtkDataArray * const intRegions = grid->GetCellData()->GetArray( "Regions" );
+  ASSERT_NE( intRegions, nullptr );
+  EXPECT_EQ( intRegions->GetDataType(), VTK_INT );
+  for( vtkIdType cellId = 0; cellId < 6; ++cellId )
+  {
+    EXPECT_EQ( intRegions->GetTuple1( cellId ), expectedRegions[cellId] ) << "cell " << cellId;
+  }
+
+  // The cells of a compacted grid are found from their RESQML index
+  vtkNew< vtkIdTypeArray > cellIndices;
+  cellIndices->SetName( resqmlCellIndexArrayName );
+  for( vtkIdType cellId = 0; cellId < 6; ++cellId )
+  {
+    cellIndices->InsertNextValue( 5 - cellId );
+  }
+  grid->GetCellData()->AddArray( cellIndices );
+
+  createRegions( grid, { first, second }, "CompactedRegions" );
+  vtkDataArray * const compactedRegions = grid->GetCellData()->GetArray( "CompactedRegions" );
+  ASSERT_NE( compactedRegions, nullptr );
+  for( vtkIdType cellId = 0; cellId < 6; ++cellId )
+  {
+    EXPECT_EQ( compactedRegions->GetTuple1( cellId ), expectedRegions[5 - cellId] ) << "cell " << cellId;
+  }
+}
+
+TEST( RESQMLUtilities, createRegionsWithManyRegions )
+{
+  vtkSmartPointer< vtkUnstructuredGrid > grid = createHexahedronRow( 4 );
+
+  // The region ids larger than a signed char are held by a larger integer type
+  std::vector< CellBitset > regionCells( 200 );
+  regionCells[9].words = { 0b0001 };
+  regionCells[199].words = { 0b0100 };
+
+  createRegions( grid, regionCells, "Regions" );
+  vtkDataArray * const regions = grid->GetCellData()->GetArray( "Regions" );
+  ASSERT_NE( regions, nullptr );
+  EXPECT_EQ( regions->GetDataType(), VTK_SHORT );
+  std::vector< int > const expectedRegions = { 10, 0, 200, 0 };
+  for( vtkIdType cellId = 0; cellId < 4; ++cellId )
+  {
+    EXPECT_EQ( regions->GetTuple1( cellId ), expectedRegions[cellId] ) << "cell " << cellId;
+  }
+}
+
+TEST( RESQMLUtilities, createRegionsFromDenseProperty )
+{
+  vtkSmartPointer< vtkUnstructuredGrid > grid = createHexahedronRow( 6 );
+
+  // The regions of the subrepresentations are applied first
+  CellBitset region;
+  region.words = { 0b110000 };
+  createRegions( grid, { region }, "Regions" );
+
+  vtkSmartPointer< vtkDataArray > const values = createPropertyValues( { 3, 7, 3, -2, 5, 42 } );
+  createRegionsFromProperty( grid, values, { { -2, 2 }, { 3, 3 }, { 5, 4 } }, "Regions" );
+
+  // The cells whose value has no region keep their region
+  expectCellValues( grid, "Regions", { 3, 0, 3, 2, 4, 1 } );
+  expectCellValues( grid, propertyRegionCellArrayName, { 1, 0, 1, 1, 1, 0 } );
+
+  // The region array is converted to a larger integer type when needed, keeping the previous regions
+  createRegionsFromProperty( grid, values, { { 7, 300 } }, "Regions" );
+  EXPECT_EQ( grid->GetCellData()->GetArray( "Regions" )->GetDataType(), VTK_SHORT );
+  expectCellValues( grid, "Regions", { 3, 300, 3, 2, 4, 1 } );
+  expectCellValues( grid, propertyRegionCellArrayName, { 1, 1, 1, 1, 1, 0 } );
+}
+
+TEST( RESQMLUtilities, createRegionsFromSparseProperty )
+{
+  vtkSmartPointer< vtkUnstructuredGrid > grid = createHexahedronRow( 6 );
+
+  // The values span more than the lookup table: they are looked up by binary search
+  int const largeValue = std::numeric_limits< int >::max();
+  int const smallValue = std::numeric_limits< int >::lowest();
+  vtkSmartPointer< vtkDataArray > const values = createPropertyValues( { largeValue, 7, smallValue, 0, largeValue - 1, 8 } );
+  createRegionsFromProperty( grid, values, { { smallValue, 1 }, { 0, 2 }, { 8, 3 }, { largeValue, 4 } }, "Regions" );
+
+  expectCellValues( grid, "Regions", { 4, 0, 1, 2, 0, 3 } );
+  expectCellValues( grid, propertyRegionCellArrayName, { 1, 0, 1, 1, 0, 1 } );
+}
+
+TEST( RESQMLUtilities, createRegionsFromPropertyOfCompactedGrid )
+{
+  vtkSmartPointer< vtkUnstructuredGrid > grid = createHexahedronRow( 3 );
+
+  // The values of all the cells of the grid are read from the RESQML indices of the cells
+  vtkNew< vtkIdTypeArray > cellIndices;
+  cellIndices->SetName( resqmlCellIndexArrayName );
+  cellIndices->InsertNextValue( 4 );
+  cellIndices->InsertNextValue( 0 );
+  cellIndices->InsertNextValue( 2 );
+  grid->GetCellData()->AddArray( cellIndices );
+
+  vtkSmartPointer< vtkDataArray > const values = createPropertyValues( { 10, 11, 12, 13, 14 } );
+  createRegionsFromProperty( grid, values, { { 10, 1 }, { 14, 2 } }, "Regions" );
+
+  expectCellValues( grid, "Regions", { 2, 1, 0 } );
+  expectCellValues( grid, propertyRegionCellArrayName, { 1, 1, 0 } );
+}
+
+class IjkGridTest : public ::testing::Test
+{
+protected:
+  static void SetUpTestSuite()
+  {
+    repository = new COMMON_NS::DataObjectRepository();
+    COMMON_NS::EpcDocument package( std::string( RESQML_TEST_DATA_DIR ) + "/testingPackageCpp.epc" );
+    package.deserializeInto( *repository );
+    package.close();
+  }
+
+  static void TearDownTestSuite()
+  {
+    delete repository;
+    repository = nullptr;
+    hdfProxy = nullptr;
+  }
+
+  /**
+   * @brief Create a cell subrepresentation of the 4x3x2 grid, whose indices are written in a temporary HDF5 file
+   * @param[in] title The title of the subrepresentation
+   * @param[in] cellIndices The RESQML indices of its cells, in any order
+   * @return the subrepresentation
+   */
+  static RESQML2_NS::SubRepresentation * createCellSubRepresentation( std::string const & title, std::vector< uint64_t > const & cellIndices )
+  {
+    if( hdfProxy == nullptr )
+    {
+      hdfProxy = repository->createHdfProxy( "", "Test HDF proxy", std::filesystem::temp_directory_path().string(), "testRESQMLUtilities.h5",
+                                             COMMON_NS::DataObjectRepository::openingMode::OVERWRITE );
+    }
+
+    RESQML2_NS::SubRepresentation * const subrep = repository->createSubRepresentation( "", title );
+    subrep->pushBackSupportingRepresentation( repository->getDataObjectByUuid< RESQML2_NS::AbstractIjkGridRepresentation >( gridUuid ));
+    subrep->pushBackSubRepresentationPatch( gsoap_eml2_3::eml23__IndexableElement::cells, cellIndices.size(), cellIndices.data(), hdfProxy );
+    return subrep;
+  }
+
+  /**
+   * @brief Build the cells of a rank, in a shuffled order
+   * @param[in] globalIds The RESQML indices of the cells, used as their global ids
+   * @return the cells
+   */
+  static vtkSmartPointer< vtkDataSet > createRankCells( std::vector< vtkIdType > const & globalIds )
+  {
+    vtkSmartPointer< vtkUnstructuredGrid > cells = createHexahedronRow( static_cast< vtkIdType >( globalIds.size()));
+    vtkNew< vtkIdTypeArray > cellGlobalIds;
+    for( vtkIdType const globalId : globalIds )
+    {
+      cellGlobalIds->InsertNextValue( globalId );
+    }
+    cells->GetCellData()->SetGlobalIds( cellGlobalIds );
+    return cells;
+  }
+
+  /**
+   * @return the IJK grids of the package with an explicit or parametric geometry
+   */
+  static std::vector< RESQML2_NS::AbstractIjkGridRepresentation * > getGridsWithGeometry()
+  {
+    using geometryKind = RESQML2_NS::AbstractIjkGridRepresentation::geometryKind;
+
+    std::vector< RESQML2_NS::AbstractIjkGridRepresentation * > grids;
+    for( auto * grid : repository->getDataObjects< RESQML2_NS::AbstractIjkGridRepresentation >())
+    {
+      if( !grid->isPartial() &&
+          ( grid->getGeometryKind() == geometryKind::EXPLICIT || grid->getGeometryKind() == geometryKind::PARAMETRIC ))
+      {
+        grids.push_back( grid );
+      }
+    }
+    return grids;
+  }
+
+  static COMMON_NS::DataObjectRepository * repository;
+
+  /// The proxy of the temporary HDF5 file of the data objects created by the tests
+  static EML2_NS::AbstractHdfProxy * hdfProxy;
+
+  /// The 4x3x2 IJK grid of the package
+  static constexpr char const * gridUuid = "e96c2bde-e3ae-4d51-b078-a8e57fb1e667";
+
+  /// The ACTNUM cell subrepresentation of the 4x3x2 grid
+  static constexpr char const * actnumUuid = "323001d0-468c-41d7-abec-7d12c3c9428b";
+};
+
+COMMON_NS::DataObjectRepository * IjkGridTest::repository = nullptr;
+EML2_NS::AbstractHdfProxy * IjkGridTest::hdfProxy = nullptr;
+
+TEST_F( IjkGridTest, compactedCellsKeepTheirPoints )
+{
+  std::vector< RESQML2_NS::AbstractIjkGridRepresentation * > const grids = getGridsWithGeometry();
+  ASSERT_FALSE( grids.empty());
+
+  for( auto * grid : grids )
+  {
+    SCOPED_TRACE( grid->getUuid());
+
+    vtkSmartPointer< vtkDataSet > full = loadIjkGridRepresentation( grid );
+    GridLoadOptions options;
+    options.compactInactiveCells = true;
+    vtkSmartPointer< vtkDataSet > compacted = loadIjkGridRepresentation( grid, options );
+
+    ASSERT_EQ( full->GetNumberOfCells(), static_cast< vtkIdType >( grid->getCellCount()));
+    ASSERT_LE( compacted->GetNumberOfPoints(), full->GetNumberOfPoints());
+
+    // The compacted grid keeps the cells with a geometry, in the RESQML order
+    std::unique_ptr< bool[] > enabledCells( new bool[grid->getCellCount()] );
+    if( grid->hasCellGeometryIsDefinedFlags())
+    {
+      grid->getCellGeometryIsDefinedFlags( enabledCells.get());
+    }
+    else
+    {
+      std::fill_n( enabledCells.get(), grid->getCellCount(), true );
+    }
+    std::vector< vtkIdType > expectedCellIndices;
+    for( uint64_t cellIndex = 0; cellIndex < grid->getCellCount(); ++cellIndex )
+    {
+      if( enabledCells[cellIndex] )
+      {
+        expectedCellIndices.push_back( static_cast< vtkIdType >( cellIndex ));
+      }
+    }
+    ASSERT_EQ( compacted->GetNumberOfCells(), static_cast< vtkIdType >( expectedCellIndices.size()));
+
+    vtkDataArray * const cellIndices = compacted->GetCellData()->GetArray( resqmlCellIndexArrayName );
+    ASSERT_NE( cellIndices, nullptr );
+    for( vtkIdType cellId = 0; cellId < compacted->GetNumberOfCells(); ++cellId )
+    {
+      vtkIdType const cellIndex = static_cast< vtkIdType >( cellIndices->GetTuple1( cellId ));
+      ASSERT_EQ( cellIndex, expectedCellIndices[cellId] );
+      expectSameCellPoints( compacted, cellId, full, cellIndex );
+    }
+  }
+}
+
+TEST_F( IjkGridTest, readRegionCells )
+{
+  auto * const region = repository->getDataObjectByUuid< RESQML2_NS::SubRepresentation >( actnumUuid );
+  ASSERT_NE( region, nullptr );
+
+  std::vector< uint64_t > elementIndices( region->getElementCountOfPatch( 0 ));
+  region->getElementIndicesOfPatch( 0, 0, elementIndices.data());
+  std::set< uint64_t > const expectedCells( elementIndices.begin(), elementIndices.end());
+
+  auto * const grid = repository->getDataObjectByUuid< RESQML2_NS::AbstractIjkGridRepresentation >( gridUuid );
+  ASSERT_NE( grid, nullptr );
+
+  CellBitset const cells = readRegionCells( region );
+  uint64_t const cellCount = grid->getCellCount();
+  for( uint64_t cellIndex = 0; cellIndex < cellCount; ++cellIndex )
+  {
+    EXPECT_EQ( cells.contains( cellIndex ), expectedCells.count( cellIndex ) == 1 ) << "cell " << cellIndex;
+  }
+  EXPECT_FALSE( cells.contains( cellCount + 64 ));
+}
+
+TEST_F( IjkGridTest, createOwnedRegions )
+{
+  // The cells shared by several regions get the id of the last of them
+  std::vector< RESQML2_NS::SubRepresentation * > const regions = {
+    createCellSubRepresentation( "First owned region", { 12, 3, 5, 1, 7, 9, 11, 2, 4, 6, 8, 10 } ),
+    createCellSubRepresentation( "Second owned region", { 17, 10, 12, 14, 16 } )
+  };
+
+  // The regions of all the cells of the grid, created on rank 0
+  auto * const grid = repository->getDataObjectByUuid< RESQML2_NS::AbstractIjkGridRepresentation >( gridUuid );
+  ASSERT_NE( grid, nullptr );
+  vtkSmartPointer< vtkDataSet > const allCells = createRegions( loadIjkGridRepresentation( grid ), regions, "Regions" );
+  vtkDataArray * const allRegions = allCells->GetCellData()->GetArray( "Regions" );
+  ASSERT_NE( allRegions, nullptr );
+
+  // The cells of a rank after the redistribution
+  std::vector< vtkIdType > const globalIds = { 20, 3, 12, 0, 10, 7, 17, 5 };
+  vtkSmartPointer< vtkDataSet > const rankCells = createOwnedRegions( createRankCells( globalIds ), regions, "Regions" );
+  expectCellValues( rankCells, "Regions", { 0, 1, 2, 0, 2, 1, 2, 1 } );
+
+  vtkDataArray * const rankRegions = rankCells->GetCellData()->GetArray( "Regions" );
+  for( std::size_t cellId = 0; cellId < globalIds.size(); ++cellId )
+  {
+    EXPECT_EQ( rankRegions->GetTuple1( cellId ), allRegions->GetTuple1( globalIds[cellId] )) << "global id " << globalIds[cellId];
+  }
+}
+
+TEST_F( IjkGridTest, createOwnedRegionsKeepsPropertyRegions )
+{
+  std::vector< RESQML2_NS::SubRepresentation * > const regions = {
+    createCellSubRepresentation( "Region under property regions", { 1, 5, 12 } )
+  };
+
+  // The first cell got its region from a property value on rank 0, the last cell is in no subrepresentation
+  vtkSmartPointer< vtkDataSet > rankCells = createRankCells( { 5, 12, 1, 23 } );
+  vtkNew< vtkIntArray > propertyRegions;
+  propertyRegions->SetName( "Regions" );
+  vtkNew< vtkSignedCharArray > propertyRegionCells;
+  propertyRegionCells->SetName( propertyRegionCellArrayName );
+  for( int const isPropertyRegionCell : { 1, 0, 0, 0 } )
+  {
+    propertyRegions->InsertNextValue( 7 );
+    propertyRegionCells->InsertNextValue( static_cast< signed char >( isPropertyRegionCell ));
+  }
+  rankCells->GetCellData()->AddArray( propertyRegions );
+  rankCells->GetCellData()->AddArray( propertyRegionCells );
+
+  rankCells = createOwnedRegions( rankCells, regions, "Regions" );
+  expectCellValues( rankCells, "Regions", { 7, 1, 1, 7 } );
+  EXPECT_EQ( rankCells->GetCellData()->GetArray( propertyRegionCellArrayName ), nullptr );
+}
+
+TEST_F( IjkGridTest, createOwnedSparseProperty )
+{
+  // The values follow the element indices of the subrepresentation, which are not sorted
+  RESQML2_NS::SubRepresentation * const subrep = createCellSubRepresentation( "Sparse property support", { 9, 2, 14, 5, 21 } );
+  vtkSmartPointer< vtkDataSet > rankCells = createRankCells( { 21, 0, 14, 9, 3, 5 } );
+
+  // An undefined continuous value keeps the default value
+  auto * const continuousProperty = repository->createContinuousProperty( subrep, "", "Sparse continuous property", 1,
+                                                                          gsoap_eml2_3::eml23__IndexableElement::cells,
+                                                                          gsoap_resqml2_0_1::resqml20__ResqmlUom::Euc,
+                                                                          gsoap_resqml2_0_1::resqml20__ResqmlPropertyKind::continuous );
+  double const continuousValues[5] = { 0.9, 0.2, std::numeric_limits< double >::quiet_NaN(), 0.5, 2.1 };
+  continuousProperty->pushBackDoubleHdf5Array1dOfValues( continuousValues, 5, hdfProxy );
+
+  rankCells = createOwnedSparseProperty( rankCells, continuousProperty, "Porosity", -1.0 );
+  vtkDataArray * const porosity = rankCells->GetCellData()->GetArray( "Porosity" );
+  ASSERT_NE( porosity, nullptr );
+  EXPECT_EQ( porosity->GetDataType(), VTK_DOUBLE );
+  std::vector< double > const expectedPorosity = { 2.1, -1.0, -1.0, 0.9, -1.0, 0.5 };
+  for( vtkIdType cellId = 0; cellId < 6; ++cellId )
+  {
+    EXPECT_DOUBLE_EQ( porosity->GetTuple1( cellId ), expectedPorosity[cellId] ) << "cell " << cellId;
+  }
+
+  RESQML2_NS::AbstractValuesProperty * const discreteProperty =
+    repository->createDiscreteProperty( subrep, "", "Sparse discrete property", 1,
+                                        gsoap_eml2_3::eml23__IndexableElement::cells,
+                                        gsoap_resqml2_0_1::resqml20__ResqmlPropertyKind::discrete );
+  int const discreteValues[5] = { 90, 20, 140, 50, 210 };
+  discreteProperty->pushBackInt32Hdf5Array1dOfValues( discreteValues, 5, hdfProxy, -1 );
+
+  rankCells = createOwnedSparseProperty( rankCells, discreteProperty, "Facies", -1.0 );
+  expectCellValues( rankCells, "Facies", { 210, -1, 140, 90, -1, 50 } );
+  EXPECT_EQ( rankCells->GetCellData()->GetArray( "Facies" )->GetDataType(), VTK_INT );
+}
+
+TEST_F( IjkGridTest, createOwnedSparseVectorProperty )
+{
+  RESQML2_NS::SubRepresentation * const subrep = createCellSubRepresentation( "Sparse vector property support", { 7, 1 } );
+  vtkSmartPointer< vtkDataSet > rankCells = createRankCells( { 1, 4, 7 } );
+
+  // The values of several components are read at once
+  auto * const vectorProperty = repository->createContinuousProperty( subrep, "", "Sparse vector property", 2,
+                                                                      gsoap_eml2_3::eml23__IndexableElement::cells,
+                                                                      gsoap_resqml2_0_1::resqml20__ResqmlUom::Euc,
+                                                                      gsoap_resqml2_0_1::resqml20__ResqmlPropertyKind::continuous );
+  double const vectorValues[4] = { 7.0, 70.0, 1.0, 10.0 };
+  vectorProperty->pushBackDoubleHdf5Array2dOfValues( vectorValues, 2, 2, hdfProxy );
+
+  rankCells = createOwnedSparseProperty( rankCells, vectorProperty, "Vector", 0.0 );
+  vtkDataArray * const vectors = rankCells->GetCellData()->GetArray( "Vector" );
+  ASSERT_NE( vectors, nullptr );
+  ASSERT_EQ( vectors->GetNumberOfComponents(), 2 );
+  std::vector< std::array< double, 2 > > const expectedVectors = { { 1.0, 10.0 }, { 0.0, 0.0 }, { 7.0, 70.0 } };
+  for( vtkIdType cellId = 0; cellId < 3; ++cellId )
+  {
+    EXPECT_DOUBLE_EQ( vectors->GetComponent( cellId, 0 ), expectedVectors[cellId][0] ) << "cell " << cellId;
+    EXPECT_DOUBLE_EQ( vectors->GetComponent( cellId, 1 ), expectedVectors[cellId][1] ) << "cell " << cellId;
+  }
+}
+
+TEST_F( IjkGridTest, readPropertyMatchesFesapi )
+{
+  // The values are mapped, inflated or read by fesapi depending on the layout of their dataset
+  std::size_t propertyCount = 0;
+  for( auto * property : repository->getDataObjects< RESQML2_NS::AbstractValuesProperty >())
+  {
+    std::string const typeProperty = property->getXmlTag();
+    bool const isContinuous = typeProperty == RESQML2_NS::ContinuousProperty::XML_TAG;
+    bool const isInteger = typeProperty == RESQML2_NS::DiscreteProperty::XML_TAG || typeProperty == RESQML2_NS::CategoricalProperty::XML_TAG;
+    if( property->isPartial() || property->getAttachmentKind() != gsoap_eml2_3::eml23__IndexableElement::cells || !( isContinuous || isInteger ))
+    {
+      continue;
+    }
+    SCOPED_TRACE( property->getUuid());
+    ++propertyCount;
+
+    vtkSmartPointer< vtkDataArray > const values = readProperty( property, "Values" );
+    ASSERT_NE( values, nullptr );
+    uint64_t const valueCount = property->getValuesCountOfPatch( 0 );
+    ASSERT_EQ( static_cast< uint64_t >( values->GetNumberOfValues()), valueCount );
+    EXPECT_EQ( values->GetNumberOfComponents(), static_cast< int >( property->getElementCountPerValue()));
+
+    if( isContinuous )
+    {
+      ASSERT_EQ( values->GetDataType(), VTK_DOUBLE );
+      std::vector< double > expectedValues( valueCount );
+      property->getDoubleValuesOfPatch( 0, expectedValues.data());
+      double const * const readValues = static_cast< double const * >( values->GetVoidPointer( 0 ));
+      for( uint64_t i = 0; i < valueCount; ++i )
+      {
+        // The undefined values are replaced
+        EXPECT_EQ( readValues[i], std::isnan( expectedValues[i] ) ? 0.00000001 : expectedValues[i] ) << "value " << i;
+      }
+    }
+    else
+    {
+      ASSERT_EQ( values->GetDataType(), VTK_INT );
+      std::vector< int > expectedValues( valueCount );
+      property->getInt32ValuesOfPatch( 0, expectedValues.data());
+      int const * const readValues = static_cast< int const * >( values->GetVoidPointer( 0 ));
+      for( uint64_t i = 0; i < valueCount; ++i )
+      {
+        EXPECT_EQ( readValues[i], expectedValues[i] ) << "value " << i;
+      }
+    }
+  }
+  EXPECT_GT( propertyCount, 0 );
+}
+
+TEST_F( IjkGridTest, partitionIjkGrid )
+{
+  std::vector< RESQML2_NS::AbstractIjkGridRepresentation * > const grids = getGridsWithGeometry();
+  ASSERT_FALSE( grids.empty());
+
+  for( auto * grid : grids )
+  {
+    SCOPED_TRACE( grid->getUuid());
+
+    GridLoadOptions options;
+    options.compactInactiveCells = true;
+    for( vtkSmartPointer< vtkDataSet > dataset : { loadIjkGridRepresentation( grid ), loadIjkGridRepresentation( grid, options ) } )
+    {
+      int const partitionCount = static_cast< int >( std::min< vtkIdType >( 3, dataset->GetNumberOfCells()));
+      if( partitionCount == 0 )
+      {
+        continue;
+      }
+
+      std::vector< int > const unpartitioned = partitionIjkGrid( dataset, grid, StructuredPartitionMethod::none, partitionCount );
+      EXPECT_TRUE( std::all_of( unpartitioned.begin(), unpartitioned.end(), []( int partition ) { return partition == 0; } ));
+
+      for( StructuredPartitionMethod const method : { StructuredPartitionMethod::cartesian, StructuredPartitionMethod::hilbert } )
+      {
+        std::vector< int > const partitions = partitionIjkGrid( dataset, grid, method, partitionCount );
+        ASSERT_EQ( partitions.size(), static_cast< std::size_t >( dataset->GetNumberOfCells()));
+        expectBalancedPartitions( partitions, partitionCount );
+      }
+    }
+  }
+}
+
+int main( int argc, char * * argv )
+{
+  ::testing::InitGoogleTest( &argc, argv );
+  geos::setupEnvironment( argc, argv );
+  int const result = RUN_ALL_TESTS();
+  geos::cleanupEnvironment();
+  return result;
+}